@@ -0,0 +1,292 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "AllocationTracker.h"
+
+#ifdef MIRGLESDEMO_ALLOCATION_TRACKING
+
+#include <atomic>
+#include <new>
+#include <vector>
+#include <algorithm>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <unistd.h>
+
+namespace
+{
+	// distinct (scope, caller) pairs that are recorded, the rest is only counted; a power of 2
+	const size_t MAX_SITES = 1024;
+
+	// how many sites are listed in the report
+	const size_t REPORTED_SITE_COUNT = 20;
+
+	struct Site
+	{
+		const char* scope; // nullptr: unused slot
+		const void* caller;
+		uint64_t count;
+		uint64_t bytes;
+		uint64_t firstFrame;
+		uint64_t lastFrame;
+	};
+
+	/*
+	 * The state must not need any dynamic initialization (or allocation): operator new can be
+	 * called before main() and in threads started before anything else.
+	 */
+	Site g_sites[MAX_SITES];
+	uint64_t g_droppedSiteCount;
+	std::atomic_flag g_sitesLock = ATOMIC_FLAG_INIT;
+
+	std::atomic<uint64_t> g_frame(0);
+	std::atomic<bool> g_assertions(false);
+
+	thread_local AllocationCounters t_counters;
+	thread_local const char* t_scope;
+
+	class SitesLock
+	{
+	public:
+		SitesLock()
+		{
+			while (g_sitesLock.test_and_set(std::memory_order_acquire))
+			{}
+		}
+
+		~SitesLock()
+		{
+			g_sitesLock.clear(std::memory_order_release);
+		}
+	};
+
+	/**
+	 * Name of the function containing the address, as well as dladdr can tell (the executable is
+	 * linked with exported symbols). Writes into the buffer, allocates nothing.
+	 */
+	const char* getSymbolName(const void* address, char* buffer, size_t size)
+	{
+		Dl_info info;
+		if (dladdr(address, &info) && info.dli_sname)
+			std::snprintf(buffer, size, "%s+%#lx", info.dli_sname,
+					static_cast<unsigned long>(reinterpret_cast<uintptr_t>(address) - reinterpret_cast<uintptr_t>(info.dli_saddr)));
+		else
+			std::snprintf(buffer, size, "%p", address);
+
+		return buffer;
+	}
+
+	/**
+	 * Demangled name of the function containing the address, for the report.
+	 */
+	std::string getFunctionName(const void* address)
+	{
+		Dl_info info;
+		if (!dladdr(address, &info) || !info.dli_sname)
+		{
+			char buffer[32];
+			std::snprintf(buffer, sizeof(buffer), "%p", address);
+			return buffer;
+		}
+
+		int status = -1;
+		char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+		std::string name(status == 0 ? demangled : info.dli_sname);
+		std::free(demangled);
+
+		char offset[32];
+		std::snprintf(offset, sizeof(offset), "+%#lx",
+				static_cast<unsigned long>(reinterpret_cast<uintptr_t>(address) - reinterpret_cast<uintptr_t>(info.dli_saddr)));
+		return name + offset;
+	}
+
+	[[noreturn]] void failAllocation(size_t size, const void* caller)
+	{
+		char symbol[256];
+		char message[512];
+		const int length = std::snprintf(message, sizeof(message),
+				"Allocation of %zu bytes in allocation scope \"%s\" in frame %llu, called from %s\n",
+				size, t_scope, static_cast<unsigned long long>(g_frame.load()), getSymbolName(caller, symbol, sizeof(symbol)));
+
+		// no iostreams: they could allocate
+		if (length > 0 && write(STDERR_FILENO, message, std::min<size_t>(length, sizeof(message) - 1)) < 0)
+		{}
+		std::abort();
+	}
+
+	void recordSite(size_t size, const void* caller)
+	{
+		const uint64_t frame = g_frame.load(std::memory_order_relaxed);
+		size_t index = (reinterpret_cast<uintptr_t>(t_scope) ^ (reinterpret_cast<uintptr_t>(caller) >> 4)) & (MAX_SITES - 1);
+
+		SitesLock lock;
+		for (size_t probe = 0; probe < MAX_SITES; probe++, index = (index + 1) & (MAX_SITES - 1))
+		{
+			Site& site = g_sites[index];
+			if (!site.scope)
+			{
+				site.scope = t_scope;
+				site.caller = caller;
+				site.firstFrame = frame;
+			}
+			else if (site.scope != t_scope || site.caller != caller)
+				continue;
+
+			site.count++;
+			site.bytes += size;
+			site.lastFrame = frame;
+			return;
+		}
+
+		g_droppedSiteCount++;
+	}
+
+	void recordAllocation(size_t size, const void* caller)
+	{
+		t_counters.allocations++;
+		t_counters.bytes += size;
+
+		if (t_scope)
+		{
+			if (g_assertions.load(std::memory_order_relaxed))
+				failAllocation(size, caller);
+
+			recordSite(size, caller);
+		}
+	}
+
+	void* allocate(size_t size)
+	{
+		if (size == 0)
+			size = 1;
+
+		void* p;
+		while ((p = std::malloc(size)) == nullptr)
+		{
+			std::new_handler handler = std::get_new_handler();
+			if (!handler)
+				throw std::bad_alloc();
+
+			handler();
+		}
+
+		return p;
+	}
+
+	// not inlined into the deallocations in this file, GCC would warn about free() of operator new memory
+	__attribute__((noinline)) void deallocate(void* p)
+	{
+		if (p)
+			t_counters.deallocations++;
+
+		std::free(p);
+	}
+}
+
+AllocationCounters getThreadAllocationCounters()
+{
+	return t_counters;
+}
+
+void setAllocationFrame(uint64_t frame)
+{
+	g_frame.store(frame, std::memory_order_relaxed);
+}
+
+void setAllocationAssertions(bool enabled)
+{
+	g_assertions.store(enabled);
+}
+
+void reportAllocationSites(std::ostream& os)
+{
+	// the copy is allocated before taking the lock: allocating with the lock held would deadlock
+	std::vector<Site> allSites(MAX_SITES);
+	uint64_t droppedSiteCount;
+	{
+		SitesLock lock;
+		std::copy(g_sites, g_sites + MAX_SITES, allSites.begin());
+		droppedSiteCount = g_droppedSiteCount;
+	}
+
+	std::vector<Site> sites;
+	for (const Site& site: allSites)
+	{
+		if (site.scope)
+			sites.push_back(site);
+	}
+
+	std::sort(sites.begin(), sites.end(), [](const Site& a, const Site& b)
+	{
+		return a.count > b.count;
+	});
+
+	os << "Allocation sites: " << sites.size() << std::endl;
+	for (size_t i = 0; i < std::min(sites.size(), REPORTED_SITE_COUNT); i++)
+	{
+		const Site& site = sites[i];
+		os << "  " << site.scope << ": " << site.count << " allocations, " << site.bytes << " bytes, frames "
+		   << site.firstFrame << "-" << site.lastFrame << ", from " << getFunctionName(site.caller) << std::endl;
+	}
+
+	if (droppedSiteCount > 0)
+		os << "  (" << droppedSiteCount << " allocations at sites that didn't fit into the table)" << std::endl;
+}
+
+const char* enterAllocationScope(const char* name)
+{
+	const char* previous = t_scope;
+	t_scope = name;
+	return previous;
+}
+
+void leaveAllocationScope(const char* previous)
+{
+	t_scope = previous;
+}
+
+void* operator new(std::size_t size)
+{
+	void* p = allocate(size);
+	recordAllocation(size, __builtin_return_address(0));
+	return p;
+}
+
+void* operator new[](std::size_t size)
+{
+	void* p = allocate(size);
+	recordAllocation(size, __builtin_return_address(0));
+	return p;
+}
+
+void operator delete(void* p) noexcept
+{
+	deallocate(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+	deallocate(p);
+}
+
+#endif // MIRGLESDEMO_ALLOCATION_TRACKING
@@ -0,0 +1,101 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef ALLOCATION_TRACKER_H
+#define ALLOCATION_TRACKER_H
+
+/*
+ * Heap allocation tracking through replaced global operator new/delete.
+ *
+ * Compiled in only with MIRGLESDEMO_ALLOCATION_TRACKING defined (the CMake
+ * option of the same name). Otherwise the macro expands to nothing.
+ *
+ * Every thread counts its allocations. Allocations inside an allocation scope
+ * are also recorded by site (the scope and the calling function) with the
+ * frame they happened in, and can be made fatal to guard the hot paths:
+ *
+ *     void renderFrame()
+ *     {
+ *         ALLOCATION_SCOPE("renderFrame");
+ *         ...
+ *     }
+ */
+
+#ifdef MIRGLESDEMO_ALLOCATION_TRACKING
+
+#include <ostream>
+#include <cstdint>
+
+struct AllocationCounters
+{
+	uint64_t allocations;
+	uint64_t deallocations;
+	uint64_t bytes; // allocated
+};
+
+/** Counters of the calling thread, since it started. Allocates nothing. */
+AllocationCounters getThreadAllocationCounters();
+
+/** Tag the following allocations (of all threads) with a frame number. */
+void setAllocationFrame(uint64_t frame);
+
+/**
+ * When enabled, any allocation inside an allocation scope prints the site and aborts.
+ * Meant to be enabled once the application reaches its steady state.
+ */
+void setAllocationAssertions(bool enabled);
+
+/** Write the allocation sites seen so far, the most frequent first. */
+void reportAllocationSites(std::ostream& os);
+
+/** Make name the innermost allocation scope of the calling thread, return the previous one (or nullptr). */
+const char* enterAllocationScope(const char* name);
+void leaveAllocationScope(const char* previous);
+
+class AllocationScope
+{
+public:
+	explicit AllocationScope(const char* name):
+		m_previous(enterAllocationScope(name))
+	{}
+
+	~AllocationScope()
+	{
+		leaveAllocationScope(m_previous);
+	}
+
+	// disallow copy and move
+	AllocationScope(const AllocationScope&) = delete;
+	AllocationScope& operator=(const AllocationScope&) = delete;
+
+private:
+	const char* m_previous;
+};
+
+#define ALLOCATION_CONCAT_(a, b) a##b
+#define ALLOCATION_CONCAT(a, b) ALLOCATION_CONCAT_(a, b)
+
+#define ALLOCATION_SCOPE(name) AllocationScope ALLOCATION_CONCAT(allocationScope_, __LINE__)(name)
+
+#else
+
+#define ALLOCATION_SCOPE(name) do {} while (false)
+
+#endif // MIRGLESDEMO_ALLOCATION_TRACKING
+
+#endif // ALLOCATION_TRACKER_H
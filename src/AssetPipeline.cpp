@@ -0,0 +1,122 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "AssetPipeline.h"
+#include "ResourcePath.h"
+#include "ShaderLoader.h"
+#include "Log.h"
+#include "Trace.h"
+
+#include <stdexcept>
+
+namespace
+{
+	/**
+	 * Remove the future for a resource. The result is left invalid if there is none.
+	 */
+	template<typename T>
+	void takeFuture(std::map<std::string, std::future<T>>& futures, const std::string& resource, std::future<T>& result)
+	{
+		auto it = futures.find(resource);
+		if (it != futures.end())
+		{
+			result = std::move(it->second);
+			futures.erase(it);
+		}
+	}
+
+	/**
+	 * The texture cache directory, or an empty string (disabling the cache) if there is none.
+	 * The cache is an optimization only, e.g. a read-only home must not prevent the start.
+	 */
+	std::string getOptionalCacheDirectory()
+	{
+		try
+		{
+			return getCacheDirectory();
+		}
+		catch (const std::runtime_error& e)
+		{
+			LOG_WARNING("Texture cache disabled: " << e.what());
+			return std::string();
+		}
+	}
+}
+
+AssetPipeline::AssetPipeline(unsigned threadCount, std::shared_ptr<PhaseTimer> timer):
+	m_timer(std::move(timer)),
+	m_textureCache(getOptionalCacheDirectory(), true /* store mipmaps */),
+	m_workers(threadCount)
+{}
+
+void AssetPipeline::preloadShaderSource(const std::string& resource)
+{
+	std::lock_guard<std::mutex> guard(m_mutex);
+	if (m_shaderSources.find(resource) == m_shaderSources.end())
+		m_shaderSources[resource] = m_workers.submit([this, resource]() { return loadShaderSource(resource); });
+}
+
+void AssetPipeline::preloadTexture(const std::string& resource)
+{
+	std::lock_guard<std::mutex> guard(m_mutex);
+	if (m_textures.find(resource) == m_textures.end())
+		m_textures[resource] = m_workers.submit([this, resource]() { return loadTexture(resource); });
+}
+
+std::string AssetPipeline::getShaderSource(const std::string& resource)
+{
+	std::future<std::string> result;
+	{
+		std::lock_guard<std::mutex> guard(m_mutex);
+		takeFuture(m_shaderSources, resource, result);
+	}
+
+	// rethrows any exception thrown by the loader
+	return result.valid() ? result.get() : loadShaderSource(resource);
+}
+
+std::vector<Image> AssetPipeline::getTexture(const std::string& resource)
+{
+	std::future<std::vector<Image>> result;
+	{
+		std::lock_guard<std::mutex> guard(m_mutex);
+		takeFuture(m_textures, resource, result);
+	}
+
+	// rethrows any exception thrown by the loader
+	return result.valid() ? result.get() : loadTexture(resource);
+}
+
+std::string AssetPipeline::loadShaderSource(const std::string& resource)
+{
+	TRACE_SCOPE("loadShaderSource");
+	const PhaseTimer::clock::time_point start = PhaseTimer::clock::now();
+	std::string source = readShaderSource(openResource(resource));
+	m_timer->addConcurrent("read shader " + resource, start, PhaseTimer::clock::now());
+
+	return source;
+}
+
+std::vector<Image> AssetPipeline::loadTexture(const std::string& resource)
+{
+	const PhaseTimer::clock::time_point start = PhaseTimer::clock::now();
+	std::vector<Image> levels = m_textureCache.load(openResource(resource));
+	m_timer->addConcurrent("load texture " + resource, start, PhaseTimer::clock::now());
+
+	return levels;
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef ASSET_PIPELINE_H
+#define ASSET_PIPELINE_H
+
+#include "Image.h"
+#include "TextureCache.h"
+#include "WorkerPool.h"
+#include "PhaseTimer.h"
+
+#include <string>
+#include <vector>
+#include <map>
+#include <future>
+#include <memory>
+#include <mutex>
+
+/**
+ * Loads assets (shader sources, decoded textures) on a pool of worker threads
+ * so that the work overlaps with the Mir and EGL initialization.
+ *
+ * Assets are requested early via preload*() and picked up later (typically once
+ * the GL context is current) via get*(), which only waits if the asset is not
+ * ready yet. Assets that were not preloaded are loaded synchronously.
+ * Each preloaded asset can be picked up once.
+ */
+class AssetPipeline
+{
+public:
+	AssetPipeline(unsigned threadCount, std::shared_ptr<PhaseTimer> timer);
+
+	void preloadShaderSource(const std::string& resource);
+	void preloadTexture(const std::string& resource);
+
+	std::string getShaderSource(const std::string& resource);
+	std::vector<Image> getTexture(const std::string& resource);
+
+	unsigned getTextureCacheHitCount() const
+	{
+		return m_textureCache.getHitCount();
+	}
+
+	unsigned getTextureCacheMissCount() const
+	{
+		return m_textureCache.getMissCount();
+	}
+
+private:
+	std::string loadShaderSource(const std::string& resource);
+	std::vector<Image> loadTexture(const std::string& resource);
+
+	std::shared_ptr<PhaseTimer> m_timer;
+	TextureCache m_textureCache;
+
+	std::mutex m_mutex;
+	std::map<std::string, std::future<std::string>> m_shaderSources;
+	std::map<std::string, std::future<std::vector<Image>>> m_textures;
+
+	// destroyed first: waits for the running tasks that reference the members above
+	WorkerPool m_workers;
+};
+
+#endif // ASSET_PIPELINE_H
@@ -0,0 +1,190 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "Benchmark.h"
+#include "Json.h"
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <cmath>
+#include <cstdio>
+
+#include <sys/resource.h>
+
+namespace
+{
+	// space reserved for the frame times of a run limited by time only
+	const size_t DEFAULT_RESERVED_FRAMES = 64 * 1024;
+
+	const double PERCENTILES[] = { 0.5, 0.9, 0.95, 0.99 };
+
+	double toMilliseconds(int64_t ns)
+	{
+		return ns / 1e6;
+	}
+
+	double toMilliseconds(Benchmark::clock::duration d)
+	{
+		return std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(d).count();
+	}
+
+	/** Nearest-rank percentile of sorted values, fraction in (0, 1]. */
+	int64_t getPercentile(const std::vector<int64_t>& sorted, double fraction)
+	{
+		const size_t rank = static_cast<size_t>(std::ceil(fraction * sorted.size()));
+		return sorted[std::max<size_t>(rank, 1) - 1];
+	}
+
+	void writeFrameTimes(FILE* file, const char* name, std::vector<int64_t> times)
+	{
+		std::fprintf(file, "  \"%s\": {", name);
+		if (times.empty())
+		{
+			std::fputs("},\n", file);
+			return;
+		}
+
+		std::sort(times.begin(), times.end());
+
+		int64_t sum = 0;
+		for (int64_t t: times)
+			sum += t;
+
+		std::fprintf(file, "\"mean\": %.3f, \"min\": %.3f", toMilliseconds(sum) / times.size(), toMilliseconds(times.front()));
+		for (double fraction: PERCENTILES)
+			std::fprintf(file, ", \"p%g\": %.3f", fraction * 100, toMilliseconds(getPercentile(times, fraction)));
+		std::fprintf(file, ", \"max\": %.3f},\n", toMilliseconds(times.back()));
+	}
+}
+
+Benchmark::Benchmark(std::string scenario, unsigned frameLimit, double secondLimit):
+	m_scenario(std::move(scenario)),
+	m_frameLimit(frameLimit),
+	m_timeLimit(std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(secondLimit))),
+	m_isStarted(false),
+	m_isFinished(false),
+	m_startGLCounts(),
+	m_endGLCounts(),
+	m_startPoolStatistics(),
+	m_endPoolStatistics()
+{
+	if (frameLimit == 0 && !(secondLimit > 0))
+		throw std::runtime_error("A benchmark needs a frame or a time limit.");
+
+	// reserved up front so that the run doesn't measure the growth of the vectors
+	const size_t reserved = frameLimit > 0 ? frameLimit : DEFAULT_RESERVED_FRAMES;
+	m_cpuTimes.reserve(reserved);
+	m_frameTimes.reserve(reserved);
+}
+
+void Benchmark::start()
+{
+	m_isStarted = true;
+	m_startTime = clock::now();
+	m_startGLCounts = getGLCounts();
+	m_startPoolStatistics = GLObjectPool::get().getStatistics();
+}
+
+void Benchmark::addFrame(int64_t cpuTime, int64_t frameTime)
+{
+	if (!m_isStarted || m_isFinished)
+		return;
+
+	m_cpuTimes.push_back(cpuTime);
+	m_frameTimes.push_back(frameTime);
+
+	const bool frameLimitReached = m_frameLimit > 0 && m_frameTimes.size() >= m_frameLimit;
+	const bool timeLimitReached = m_timeLimit > clock::duration::zero() && clock::now() - m_startTime >= m_timeLimit;
+	if (frameLimitReached || timeLimitReached)
+		finish();
+}
+
+void Benchmark::finish()
+{
+	m_isFinished = true;
+	m_endTime = clock::now();
+	m_endGLCounts = getGLCounts();
+	m_endPoolStatistics = GLObjectPool::get().getStatistics();
+}
+
+void Benchmark::writeJson(const std::string& fileName, const PhaseTimer& startupTimer) const
+{
+	std::unique_ptr<FILE, decltype(&fclose)> file(std::fopen(fileName.c_str(), "w"), fclose);
+	if (!file)
+		throw std::runtime_error("Can't create benchmark result file " + fileName);
+
+	const clock::duration duration = (m_isFinished ? m_endTime : clock::now()) - m_startTime;
+	const double seconds = std::chrono::duration<double>(duration).count();
+
+	std::fputs("{\n  \"scenario\": ", file.get());
+	writeJsonString(file.get(), m_scenario);
+#ifdef NDEBUG
+	std::fputs(",\n  \"debugBuild\": false", file.get());
+#else
+	std::fputs(",\n  \"debugBuild\": true", file.get());
+#endif
+	std::fprintf(file.get(), ",\n  \"finished\": %s", m_isFinished ? "true" : "false");
+	std::fprintf(file.get(), ",\n  \"frames\": %zu", m_frameTimes.size());
+	std::fprintf(file.get(), ",\n  \"durationMs\": %.3f", toMilliseconds(duration));
+	std::fprintf(file.get(), ",\n  \"fps\": %.3f,\n", seconds > 0 ? m_frameTimes.size() / seconds : 0.0);
+
+	writeFrameTimes(file.get(), "frameTimeMs", m_frameTimes);
+	writeFrameTimes(file.get(), "cpuTimeMs", m_cpuTimes);
+
+	std::fputs("  \"startupPhases\": [", file.get());
+	bool first = true;
+	for (const PhaseTimer::Phase& phase: startupTimer.getPhases())
+	{
+		std::fputs(first ? "\n    {\"name\": " : ",\n    {\"name\": ", file.get());
+		first = false;
+		writeJsonString(file.get(), phase.name);
+		std::fprintf(file.get(), ", \"startMs\": %.3f, \"durationMs\": %.3f, \"concurrent\": %s}",
+				toMilliseconds(phase.start), toMilliseconds(phase.duration), phase.concurrent ? "true" : "false");
+	}
+	std::fputs("\n  ],\n", file.get());
+
+	// the counts of the measured frames only, not of the startup
+	const GLCounts& endGLCounts = m_isFinished ? m_endGLCounts : getGLCounts();
+	std::fputs("  \"glCalls\": {", file.get());
+	for (size_t i = 0; i < GL_COUNTER_COUNT; i++)
+	{
+		std::fprintf(file.get(), "\"%s\": %llu, ", getGLCounterName(static_cast<GLCounter>(i)),
+				static_cast<unsigned long long>(endGLCounts[i] - m_startGLCounts[i]));
+	}
+	const GLObjectPool::Statistics endPoolStatistics = m_isFinished ? m_endPoolStatistics : GLObjectPool::get().getStatistics();
+	std::fprintf(file.get(), "\"objectGenCalls\": %llu, \"objectDeleteCalls\": %llu},\n",
+			static_cast<unsigned long long>(endPoolStatistics.genCalls - m_startPoolStatistics.genCalls),
+			static_cast<unsigned long long>(endPoolStatistics.deleteCalls - m_startPoolStatistics.deleteCalls));
+
+	// the peaks are over the whole run of the program, including the startup
+	const MemoryTracker& memory = MemoryTracker::get();
+	std::fprintf(file.get(), "  \"memoryPeakBytes\": {\"gpu\": %zu, \"cpu\": %zu", memory.getGpuUsage().peakBytes, memory.getCpuUsage().peakBytes);
+	for (size_t i = 0; i < MemoryTracker::CATEGORY_COUNT; i++)
+	{
+		const MemoryCategory category = static_cast<MemoryCategory>(i);
+		std::fprintf(file.get(), ", \"%s\": %zu", MemoryTracker::getCategoryName(category), memory.getCategoryUsage(category).peakBytes);
+	}
+	rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) == 0)
+		std::fprintf(file.get(), ", \"maxResidentSet\": %lld", static_cast<long long>(usage.ru_maxrss) * 1024); // in kB on Linux
+	std::fputs("}\n}\n", file.get());
+
+	if (std::ferror(file.get()))
+		throw std::runtime_error("Can't write benchmark result file " + fileName);
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include "PhaseTimer.h"
+#include "MemoryTracker.h"
+#include "gl/GLCounters.h"
+#include "gl/GLObjectPool.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/**
+ * Limits and results of a benchmark run of a renderer.
+ *
+ * The renderer calls start() once the startup is over (after the first frame),
+ * then addFrame() after each frame until isFinished(). The run ends after the
+ * frame limit or the time limit, whichever comes first (0: no limit). The
+ * frame times are kept individually, so that the percentiles are exact.
+ */
+class Benchmark
+{
+public:
+	typedef std::chrono::steady_clock clock;
+
+	Benchmark(std::string scenario, unsigned frameLimit, double secondLimit);
+
+	const std::string& getScenario() const
+	{
+		return m_scenario;
+	}
+
+	void start();
+
+	/**
+	 * @param cpuTime time (in ns) spent in the renderer
+	 * @param frameTime time (in ns) from the start of the frame to the end of the swap
+	 */
+	void addFrame(int64_t cpuTime, int64_t frameTime);
+
+	bool isFinished() const
+	{
+		return m_isFinished;
+	}
+
+	/**
+	 * Write the results as JSON: frame time percentiles, the startup phases, the GL call counts and
+	 * the memory peaks. Throws std::runtime_error if the file can't be written.
+	 */
+	void writeJson(const std::string& fileName, const PhaseTimer& startupTimer) const;
+
+	// disallow copy and move
+	Benchmark& operator=(Benchmark&&) = delete;
+	Benchmark(Benchmark&&) = delete;
+	Benchmark& operator=(const Benchmark&) = delete;
+	Benchmark(const Benchmark&) = delete;
+
+private:
+	void finish();
+
+	std::string m_scenario;
+	unsigned m_frameLimit;
+	clock::duration m_timeLimit;
+
+	bool m_isStarted;
+	bool m_isFinished;
+	clock::time_point m_startTime;
+	clock::time_point m_endTime;
+
+	std::vector<int64_t> m_cpuTimes;
+	std::vector<int64_t> m_frameTimes;
+
+	// the counts are the difference between the start and the end
+	GLCounts m_startGLCounts;
+	GLCounts m_endGLCounts;
+	GLObjectPool::Statistics m_startPoolStatistics;
+	GLObjectPool::Statistics m_endPoolStatistics;
+};
+
+#endif // BENCHMARK_H
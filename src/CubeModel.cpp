@@ -0,0 +1,65 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "CubeModel.h"
+
+#include <cmath>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+void clampAngle(float& angle)
+{
+	while (angle > M_PI)
+		angle -= 2.0 * M_PI;
+	while (angle <= -M_PI)
+		angle += 2.0 * M_PI;
+}
+
+void rotateAlongAxis(float& rotationAngle, float& rotationAngularSpeed, float secsSinceLastFrame)
+{
+	const float DECELERATION = 2.0f; // rad/s^2
+
+	if (rotationAngularSpeed == 0.0f)
+		return; // nothing to do
+
+	const float d = rotationAngularSpeed > 0.0f ? DECELERATION : -DECELERATION;
+	const float t_E = rotationAngularSpeed / d; // time when the rotation should stop
+
+	if (secsSinceLastFrame > t_E)
+	{
+		// the rotation has stopped somewhere between this and the previous frame
+		rotationAngle += (rotationAngularSpeed - 0.5f * d * t_E) * t_E;
+		rotationAngularSpeed = 0.0f;
+	}
+	else
+	{
+		// the rotation continues, but the speed is decreased
+		rotationAngle += (rotationAngularSpeed - 0.5f * d* secsSinceLastFrame) * secsSinceLastFrame;
+		rotationAngularSpeed -= d * secsSinceLastFrame;
+	}
+
+	clampAngle(rotationAngle);
+}
+
+glm::mat4 getCubeMvpMatrix(const glm::mat4& projection, const glm::mat4& view, float angleX, float angleY, float angleZ)
+{
+	glm::mat4 model = glm::rotate(glm::mat4(1.0f), angleZ, glm::vec3(0, 0, 1));
+	model = glm::rotate(glm::rotate(model, angleX, glm::vec3(1, 0, 0)), angleY, glm::vec3(0, 1, 0));
+
+	return projection * view * model;
+}
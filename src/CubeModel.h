@@ -0,0 +1,98 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CUBE_MODEL_H
+#define CUBE_MODEL_H
+
+/*
+ * Geometry and motion of the die cube, kept apart from the GL code of the
+ * DemoRenderer so that the CPU side can be benchmarked on its own.
+ */
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+
+/** 6 faces, 2 triangles each. */
+const size_t CUBE_VERTEX_COUNT = 6 * 2 * 3;
+
+template<typename VECTOR, typename VEC>
+void addFace(VECTOR& triangles, const VEC& a, const VEC& b, const VEC& c, const VEC& d)
+{
+	// 1st triangle
+	triangles.push_back(a);
+	triangles.push_back(b);
+	triangles.push_back(d);
+
+	// 2nd triangle
+	triangles.push_back(b);
+	triangles.push_back(d);
+	triangles.push_back(c);
+}
+
+/**
+ * Append the triangles of the cube (-1..+1 on each axis) and their die texture
+ * coordinates. The texture has the faces 1, 2, 3 in the top row and 4, 5, 6 in the bottom one.
+ */
+template<typename VEC3_VECTOR, typename VEC2_VECTOR>
+void addCubeGeometry(VEC3_VECTOR& v, VEC2_VECTOR& c)
+{
+	constexpr float HALF = 1.0/2.0;
+	constexpr float THIRD = 1.0/3.0;
+
+	// z = +1, value 1
+	addFace(v, glm::vec3(-1, -1, +1), glm::vec3(-1, +1, +1), glm::vec3(+1, +1, +1), glm::vec3(+1, -1, +1));
+	addFace(c, glm::vec2(0, HALF), glm::vec2(0, 1), glm::vec2(THIRD, 1), glm::vec2(THIRD, HALF));
+
+	// z = -1, value 6
+	addFace(v, glm::vec3(+1, -1, -1), glm::vec3(+1, +1, -1), glm::vec3(-1, +1, -1), glm::vec3(-1, -1, -1));
+	addFace(c, glm::vec2(2*THIRD, 0), glm::vec2(2*THIRD, HALF), glm::vec2(1, HALF), glm::vec2(1, 0));
+
+	// x = +1, value 2
+	addFace(v, glm::vec3(+1, -1, +1), glm::vec3(+1, +1, +1), glm::vec3(+1, +1, -1), glm::vec3(+1, -1, -1));
+	addFace(c, glm::vec2(THIRD, HALF), glm::vec2(THIRD, 1), glm::vec2(2*THIRD, 1), glm::vec2(2*THIRD, HALF));
+
+	// x = -1, value 5
+	addFace(v, glm::vec3(-1, -1, -1), glm::vec3(-1, +1, -1), glm::vec3(-1, +1, +1), glm::vec3(-1, -1, +1));
+	addFace(c, glm::vec2(THIRD, 0), glm::vec2(THIRD, HALF), glm::vec2(2*THIRD, HALF), glm::vec2(2*THIRD, 0));
+
+	// y = +1, value 3
+	addFace(v, glm::vec3(-1, +1, +1), glm::vec3(-1, +1, -1), glm::vec3(+1, +1, -1), glm::vec3(+1, +1, +1));
+	addFace(c, glm::vec2(2*THIRD, HALF), glm::vec2(2*THIRD, 1), glm::vec2(1, 1), glm::vec2(1, HALF));
+
+	// y = -1, value 4
+	addFace(v, glm::vec3(-1, -1, -1), glm::vec3(-1, -1, +1), glm::vec3(+1, -1, +1), glm::vec3(+1, -1, -1));
+	addFace(c, glm::vec2(0, 0), glm::vec2(0, HALF), glm::vec2(THIRD, HALF), glm::vec2(THIRD, 0));
+}
+
+/** Wrap the angle into (-pi, pi]. */
+void clampAngle(float& angle);
+
+/**
+ * Advance the rotation along one axis by the given time, decelerating at a fixed rate.
+ * The speed drops to zero when the rotation stops.
+ */
+void rotateAlongAxis(float& rotationAngle, float& rotationAngularSpeed, float secsSinceLastFrame);
+
+/**
+ * The model-view-projection matrix of the cube rotated by angleZ around the view axis,
+ * then by angleX and angleY.
+ */
+glm::mat4 getCubeMvpMatrix(const glm::mat4& projection, const glm::mat4& view, float angleX, float angleY, float angleZ);
+
+#endif // CUBE_MODEL_H
@@ -17,163 +17,273 @@
  * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "DemoRenderer.h"
-#include "ResourcePath.h"
-#include "PNGLoader.h"
-#include "ShaderLoader.h"
 
+#include "CubeModel.h"
 #include "gl/Program.h"
 #include "gl/ArrayBuffer.h"
 #include "gl/Texture.h"
+#include "gl/GLObjectPool.h"
+#include "gl/GLCheck.h"
+#include "gl/GLCounters.h"
+#include "Log.h"
+#include "MemoryTracker.h"
+#include "Trace.h"
 
 #include <iostream>
 #include <stdexcept>
+#include <algorithm>
 #include <cmath>
 #include <vector>
 #include <thread>
 
+#include <time.h>
+
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtx/norm.hpp>
 
-DemoRenderer::DemoRenderer():
+namespace
+{
+	const char VERTEX_SHADER[] = "vertex_shader.glslv";
+	const char FRAGMENT_SHADER[] = "fragment_shader.glslf";
+	const char DIE_TEXTURE[] = "die.png";
+
+	// how many released shaders/programs are kept around for reuse
+	const size_t RETAINED_RESOURCE_COUNT = 8;
+
+	// camera distance limits for the pinch zoom
+	const float MIN_CAMERA_DISTANCE = 3.0f;
+	const float MAX_CAMERA_DISTANCE = 20.0f;
+
+	// GPU memory budget for textures and how long a texture must be unused to be evicted
+	const size_t TEXTURE_BUDGET_BYTES = 32 * 1024 * 1024;
+	const unsigned TEXTURE_MIN_IDLE_FRAMES = 90;
+
+	// how often the input latency is reported (if there was any input)
+	const std::chrono::seconds LATENCY_REPORT_PERIOD(10);
+
+	// how often the CPU and GPU frame times and the memory usage are reported
+	const std::chrono::seconds FRAME_STATS_REPORT_PERIOD(10);
+
+	/**
+	 * Current time in the time base of mir_input_event_get_event_time (CLOCK_MONOTONIC, in ns).
+	 */
+	int64_t getMonotonicTime()
+	{
+		timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+	}
+}
+
+DemoRenderer::DemoRenderer(std::shared_ptr<AssetPipeline> assets, std::shared_ptr<PhaseTimer> startupTimer, const Options& options,
+		std::shared_ptr<Benchmark> benchmark, std::shared_ptr<GoldenImageCheck> goldenCheck):
+	m_assets(std::move(assets)),
+	m_startupTimer(std::move(startupTimer)),
+	m_benchmark(std::move(benchmark)),
+	m_goldenCheck(std::move(goldenCheck)),
+	m_resources(m_assets, RETAINED_RESOURCE_COUNT),
+	m_textures(TEXTURE_BUDGET_BYTES, TEXTURE_MIN_IDLE_FRAMES),
+	m_dieTexture(0),
 	m_mvpMatrixIndex(0),
 	m_cubeVertexCount(0),
 	m_pointerState(PointerState::Up),
-	m_fingerId(0),
-	m_lastX(0),
-	m_lastY(0),
+	m_inputRecorder(options.recordInputFile.empty() ? nullptr : new InputRecorder(options.recordInputFile)),
+	m_inputReplayer(options.replayInputFile.empty() ? nullptr :
+			new InputReplayer(options.replayInputFile, options.replaySpeed, static_cast<int64_t>(options.replayStepMs * 1e6))),
+	m_inputToSubmitLatency("input to submit latency"),
+	m_inputToSwapLatency("input to swap latency"),
+	m_cpuFrameTime("CPU frame time"),
+	m_gestures(*this),
+	m_touchPrediction(options.touchPrediction),
+	m_measurePrediction(options.measurePrediction),
+	m_touchPredictor(static_cast<int64_t>(options.predictionHorizonMs) * 1000000, options.predictionMaxOvershoot, options.measurePrediction),
+	m_predictionOffset(0.0f, 0.0f),
 	m_rotationAngularSpeedX(0.0f),
 	m_rotationAngularSpeedY(0.0f),
 	m_rotationAngleX(M_PI/8.0f),
 	m_rotationAngleY(M_PI_4),
-	m_lastFrameTimeStampValid(false),
-	m_swipeGesture(*this)
+	m_rotationAngleZ(0.0f),
+	m_cameraDistance(6.0f),
+	m_traceFile(options.traceFile),
+	m_traceFrames(options.traceFrames),
+	m_assertNoAllocationsAfter(options.assertNoAllocationsAfter),
+#ifdef MIRGLESDEMO_ALLOCATION_TRACKING
+	m_allocationFrameCount(0),
+	m_frameAllocations(0),
+	m_frameAllocatedBytes(0),
+	m_maxFrameAllocations(0),
+#endif
+	m_lastFrameTimeStampValid(false)
 {}
 
-namespace
+void DemoRenderer::preloadAssets(AssetPipeline& assets)
 {
-	template<typename VEC>
-	void addFace(std::vector<VEC>& triangles, const VEC& a, const VEC& b, const VEC& c, const VEC& d)
-	{
-		// 1st triangle
-		triangles.push_back(a);
-		triangles.push_back(b);
-		triangles.push_back(d);
-
-		// 2nd triangle
-		triangles.push_back(b);
-		triangles.push_back(d);
-		triangles.push_back(c);
-	}
-
-	void clampAngle(float& angle)
-	{
-		while (angle > M_PI)
-			angle -= 2.0 * M_PI;
-		while (angle <= -M_PI)
-			angle += 2.0 * M_PI;
-	}
+	assets.preloadShaderSource(VERTEX_SHADER);
+	assets.preloadShaderSource(FRAGMENT_SHADER);
+	assets.preloadTexture(DIE_TEXTURE);
 }
 
 void DemoRenderer::run(MirNativeWindowControl& nativeWindow)
 {
-	std::cout << "Loading shader" << std::endl;
-	std::shared_ptr<Shader> vertexShader = loadShader(ShaderType::Vertex, getResourcePath("vertex_shader.glslv"));
-	std::shared_ptr<Shader> fragmentShader = loadShader(ShaderType::Fragment, getResourcePath("fragment_shader.glslf"));
-
-	Program program(*vertexShader, *fragmentShader);
-	program.link();
-	glUseProgram(program.getGLProgram());
+	TRACE_THREAD_NAME("render");
 
-	glViewport(0, 0, nativeWindow.getWidth(), nativeWindow.getHeight());
-	glClearColor(0.2, 0.4, 0., 1.);
+	// no-op in release builds
+	installGLDebugOutput();
 
-	glEnable(GL_DEPTH_TEST);
-	glDepthFunc(GL_LESS);
-
-	const GLint vertexIndex = program.getAttribute("vPosition");
-	const GLint colorIndex = program.getAttribute("vTexCoord");
-	m_mvpMatrixIndex = program.getUniform("MVPMatrix");
-	const GLint textureSamplerIndex = program.getUniform("textureSampler");
-
-	std::vector<glm::vec3> v; // vertices
-	std::vector<glm::vec2> c; // text coords
-	v.reserve(6 /* faces */ * 2 /* 2 triangles for each face */);
-	c.reserve(v.capacity());
+	std::cout << "Loading shader" << std::endl;
+	std::shared_ptr<Program> program = m_resources.getProgram(VERTEX_SHADER, FRAGMENT_SHADER);
+	GL_CHECK(glUseProgram(program->getGLProgram()));
+	countGL(GLCounter::ProgramBinds);
+	m_startupTimer->mark("load, compile and link shaders");
 
-	constexpr float HALF = 1.0/2.0;
-	constexpr float THIRD = 1.0/3.0;
+	GL_CHECK(glViewport(0, 0, nativeWindow.getWidth(), nativeWindow.getHeight()));
+	GL_CHECK(glClearColor(0.2, 0.4, 0., 1.));
 
-	// z = +1, value 1
-	addFace(v, glm::vec3(-1, -1, +1), glm::vec3(-1, +1, +1), glm::vec3(+1, +1, +1), glm::vec3(+1, -1, +1));
-	addFace(c, glm::vec2(0, HALF), glm::vec2(0, 1), glm::vec2(THIRD, 1), glm::vec2(THIRD, HALF));
+	GL_CHECK(glEnable(GL_DEPTH_TEST));
+	GL_CHECK(glDepthFunc(GL_LESS));
 
-	// z = -1, value 6
-	addFace(v, glm::vec3(+1, -1, -1), glm::vec3(+1, +1, -1), glm::vec3(-1, +1, -1), glm::vec3(-1, -1, -1));
-	addFace(c, glm::vec2(2*THIRD, 0), glm::vec2(2*THIRD, HALF), glm::vec2(1, HALF), glm::vec2(1, 0));
+	const GLint vertexIndex = program->getAttribute("vPosition");
+	const GLint colorIndex = program->getAttribute("vTexCoord");
+	m_mvpMatrixIndex = program->getUniform("MVPMatrix");
+	const GLint textureSamplerIndex = program->getUniform("textureSampler");
 
-	// x = +1, value 2
-	addFace(v, glm::vec3(+1, -1, +1), glm::vec3(+1, +1, +1), glm::vec3(+1, +1, -1), glm::vec3(+1, -1, -1));
-	addFace(c, glm::vec2(THIRD, HALF), glm::vec2(THIRD, 1), glm::vec2(2*THIRD, 1), glm::vec2(2*THIRD, HALF));
+	ArrayBuffer arrayBuffer("cube vertices");
+	ArrayBuffer colorBuffer("cube texture coordinates");
+	{
+		std::vector<glm::vec3> v; // vertices
+		std::vector<glm::vec2> c; // text coords
+		v.reserve(CUBE_VERTEX_COUNT);
+		c.reserve(v.capacity());
 
-	// x = -1, value 5
-	addFace(v, glm::vec3(-1, -1, -1), glm::vec3(-1, +1, -1), glm::vec3(-1, +1, +1), glm::vec3(-1, -1, +1));
-	addFace(c, glm::vec2(THIRD, 0), glm::vec2(THIRD, HALF), glm::vec2(2*THIRD, HALF), glm::vec2(2*THIRD, 0));
+		addCubeGeometry(v, c);
 
-	// y = +1, value 3
-	addFace(v, glm::vec3(-1, +1, +1), glm::vec3(-1, +1, -1), glm::vec3(+1, +1, -1), glm::vec3(+1, +1, +1));
-	addFace(c, glm::vec2(2*THIRD, HALF), glm::vec2(2*THIRD, 1), glm::vec2(1, 1), glm::vec2(1, HALF));
+		arrayBuffer.setData(glm::value_ptr(v[0]), v.size()*sizeof(decltype(v[0])), GL_STATIC_DRAW);
 
-	// y = -1, value 4
-	addFace(v, glm::vec3(-1, -1, -1), glm::vec3(-1, -1, +1), glm::vec3(+1, -1, +1), glm::vec3(+1, -1, -1));
-	addFace(c, glm::vec2(0, 0), glm::vec2(0, HALF), glm::vec2(THIRD, HALF), glm::vec2(THIRD, 0));
+		GL_CHECK(glEnableVertexAttribArray(vertexIndex));
+		GL_CHECK(glVertexAttribPointer(vertexIndex, 3, GL_FLOAT, GL_FALSE, 0, nullptr));
 
-	ArrayBuffer arrayBuffer;
-	arrayBuffer.bind();
-	glBufferData(GL_ARRAY_BUFFER, v.size()*sizeof(decltype(v[0])), glm::value_ptr(v[0]), GL_STATIC_DRAW);
+		colorBuffer.setData(glm::value_ptr(c[0]), c.size()*sizeof(decltype(c[0])), GL_STATIC_DRAW);
 
-	glEnableVertexAttribArray(vertexIndex);
-	glVertexAttribPointer(vertexIndex, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
+		GL_CHECK(glEnableVertexAttribArray(colorIndex));
+		GL_CHECK(glVertexAttribPointer(colorIndex, 2, GL_FLOAT, GL_FALSE, 0, nullptr));
 
-	ArrayBuffer colorBuffer;
-	colorBuffer.bind();
-	glBufferData(GL_ARRAY_BUFFER, c.size()*sizeof(decltype(c[0])), glm::value_ptr(c[0]), GL_STATIC_DRAW);
+		m_cubeVertexCount = v.size();
+	}
 
-	glEnableVertexAttribArray(colorIndex);
-	glVertexAttribPointer(colorIndex, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+	m_startupTimer->mark("GL setup and geometry upload");
 
-	Texture2D texture(loadPNG(getResourcePath("die.png")));
-	texture.getGLTexture();
+	// reloaded from the (texture cache of the) asset pipeline if it gets evicted
+	m_dieTexture = m_textures.add(DIE_TEXTURE, [this]()
+	{
+		return std::make_shared<Texture2D>(m_assets->getTexture(DIE_TEXTURE), DIE_TEXTURE);
+	});
+	m_textures.use(m_dieTexture);
+	m_startupTimer->mark("load and upload texture");
 
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, texture.getGLTexture());
-	glUniform1i(textureSamplerIndex, 0 /* Texture unit 0 */);
+	GL_CHECK(glActiveTexture(GL_TEXTURE0));
+	GL_CHECK(glUniform1i(textureSamplerIndex, 0 /* Texture unit 0 */));
+	countGL(GLCounter::UniformUpdates);
 
 	m_projectionMatrix = glm::perspective(glm::radians(45.0f),
 										  static_cast<float>(nativeWindow.getWidth()) / static_cast<float>(nativeWindow.getHeight()),
 										  0.1f, 100.0f);
 
-	m_cubeVertexCount = v.size();
+	m_gpuProfiler.reset(new GpuProfiler());
+	m_frameStatsReportTime = clock::now();
+
+	if (m_benchmark)
+	{
+		nativeWindow.setSwapInterval(0);
+		LOG_INFO("Running benchmark " << m_benchmark->getScenario());
+	}
 
 	// target frames per second value
 	constexpr unsigned fps = 30;
 	const clock::duration framePeriod = std::chrono::milliseconds(static_cast<unsigned>(std::round(1000.0/fps)));
 
-	while (true)
+	bool isFirstFrame = true;
+	unsigned frameCount = 0;
+	while (!m_benchmark || !m_benchmark->isFinished())
 	{
-		// limit rendering to requested fps value
-		if (m_lastFrameTimeStampValid)
+		// limit rendering to requested fps value; a benchmark runs uncapped
+		if (m_lastFrameTimeStampValid && !m_benchmark)
 		{
 			std::this_thread::sleep_until(m_lastFrameTimeStamp + framePeriod);
 		}
 
+#ifdef MIRGLESDEMO_ALLOCATION_TRACKING
+		setAllocationFrame(frameCount);
+		if (m_assertNoAllocationsAfter > 0 && frameCount == m_assertNoAllocationsAfter)
+		{
+			setAllocationAssertions(true);
+			LOG_INFO("Steady state reached after " << frameCount << " frames, allocations in the render and input paths are fatal now");
+		}
+		const AllocationCounters frameStartAllocations = getThreadAllocationCounters();
+#endif
+
+		if (m_goldenCheck)
+			setPose(m_goldenCheck->beginFrame());
+
+		const int64_t frameStartTime = getMonotonicTime();
 		renderFrame();
+		const int64_t submitTime = getMonotonicTime();
+		// read back before the swap, after it the content of the back buffer is undefined
+		const bool isCaptureFrame = m_goldenCheck && m_goldenCheck->isCaptureFrame();
+		if (isCaptureFrame)
+			m_goldenCheck->capture(nativeWindow.getWidth(), nativeWindow.getHeight());
 		nativeWindow.swapBuffers();
+		const int64_t swapTime = getMonotonicTime();
+		recordInputLatency(submitTime, swapTime);
+#ifdef MIRGLESDEMO_ALLOCATION_TRACKING
+		recordFrameAllocations(frameStartAllocations);
+#endif
+		recordFrameTime(frameStartTime, submitTime);
+		m_textures.endFrame();
+		// the released GL objects are deleted once per frame, after the swap
+		GLObjectPool::get().flush();
+		frameCount++;
+
+		if (m_benchmark)
+		{
+			// the first frame is a part of the startup; the captured frames of a golden image check aren't timed
+			if (isFirstFrame)
+				m_benchmark->start();
+			else if (!isCaptureFrame)
+				m_benchmark->addFrame(submitTime - frameStartTime, swapTime - frameStartTime);
+		}
+
+#ifdef MIRGLESDEMO_TRACING
+		if (!m_traceFile.empty() && frameCount == m_traceFrames)
+		{
+			writeTraceJson(m_traceFile);
+			std::cout << "Trace of the first " << frameCount << " frames written to " << m_traceFile << std::endl;
+		}
+#endif
+
+		if (isFirstFrame)
+		{
+			isFirstFrame = false;
+			m_startupTimer->mark("first frame");
+			// the startup is over, e.g. texture reloads after an eviction are not a part of it
+			m_startupTimer->stop();
+
+			std::cout << "Startup timings:" << std::endl;
+			m_startupTimer->report(std::cout);
+			std::cout << "Texture cache: " << m_assets->getTextureCacheHitCount() << " hits, "
+					  << m_assets->getTextureCacheMissCount() << " misses" << std::endl;
+			m_resources.report(std::cout);
+			m_textures.report(std::cout);
+			MemoryTracker::get().report(std::cout);
+			GLObjectPool::get().report(std::cout);
+		}
 	}
 }
 
 void DemoRenderer::handleEvent(const MirEvent* event)
 {
+	ALLOCATION_SCOPE("handleEvent");
+
 	const MirEventType type = mir_event_get_type(event);
 
 	if (type == mir_event_type_input)
@@ -188,12 +298,21 @@ void DemoRenderer::handleEvent(const MirEvent* event)
 
 void DemoRenderer::renderFrame()
 {
+	TRACE_SCOPE("renderFrame");
+	ALLOCATION_SCOPE("renderFrame");
+
 	const clock::time_point t = clock::now();
 
-	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	processInput();
+
+	m_gpuProfiler->beginFrame();
+
+	m_gpuProfiler->beginPass("clear");
+	GL_CHECK(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+	m_gpuProfiler->endPass();
 
 	glm::mat4 view = glm::lookAt(
-				glm::vec3(0,0,6),
+				glm::vec3(0,0,m_cameraDistance),
 				glm::vec3(0,0,0),
 				glm::vec3(0,1,0)
 				);
@@ -204,26 +323,146 @@ void DemoRenderer::renderFrame()
 	{
 		const std::chrono::duration<float> durationSinceLastFrame = t - m_lastFrameTimeStamp;
 		const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(durationSinceLastFrame);
-		const float secsSinceLastFrame = ms.count() / 1000.0f;
+		// a stepped replay advances its clock by the step each frame, the fling follows it
+		const float secsSinceLastFrame = isReplayStepping() ? m_inputReplayer->getStep() * 1e-9f : ms.count() / 1000.0f;
 
 		rotateAlongAxis(m_rotationAngleX, m_rotationAngularSpeedX, secsSinceLastFrame);
 		rotateAlongAxis(m_rotationAngleY, m_rotationAngularSpeedY, secsSinceLastFrame);
 	}
 
-	glm::mat4 model = glm::rotate(glm::rotate(glm::mat4(1.0f), m_rotationAngleX, glm::vec3(1, 0, 0)), m_rotationAngleY, glm::vec3(0, 1, 0));
+	// the same mapping as in rotateCube()
+	const float angleX = m_rotationAngleX + m_predictionOffset.y / 500;
+	const float angleY = m_rotationAngleY + m_predictionOffset.x / 400;
+
+	const glm::mat4 mvpMatrix = getCubeMvpMatrix(m_projectionMatrix, view, angleX, angleY, m_rotationAngleZ);
+	GL_CHECK(glUniformMatrix4fv(m_mvpMatrixIndex, 1, GL_FALSE, glm::value_ptr(mvpMatrix)));
+	countGL(GLCounter::UniformUpdates);
 
-	glm::mat4 mvpMatrix = m_projectionMatrix * view * model;
-	glUniformMatrix4fv(m_mvpMatrixIndex, 1, GL_FALSE, glm::value_ptr(mvpMatrix));
+	GL_CHECK(glBindTexture(GL_TEXTURE_2D, m_textures.use(m_dieTexture).getGLTexture()));
+	countGL(GLCounter::TextureBinds);
 
-	glDrawArrays(GL_TRIANGLES, 0, m_cubeVertexCount);
+	m_gpuProfiler->beginPass("cube");
+	GL_CHECK(glDrawArrays(GL_TRIANGLES, 0, m_cubeVertexCount));
+	countGL(GLCounter::DrawCalls);
+	countGL(GLCounter::Vertices, m_cubeVertexCount);
+	m_gpuProfiler->endPass();
+
+	m_gpuProfiler->endFrame();
 
 	m_lastFrameTimeStampValid = true;
 	m_lastFrameTimeStamp = t;
 }
 
+void DemoRenderer::processInput()
+{
+	TRACE_SCOPE("processInput");
+	ALLOCATION_SCOPE("processInput");
+
+	if (m_inputReplayer && !m_inputReplayer->isFinished())
+	{
+		m_inputReplayer->replay(getMonotonicTime(), *this);
+		if (m_inputReplayer->isFinished())
+			LOG_INFO("Input replay finished (" << m_inputReplayer->getEventCount() << " events)");
+	}
+
+	m_inputBatch.take(m_inputFrame);
+	m_gestures.process(m_inputFrame);
+
+	m_predictionOffset = glm::vec2(0.0f, 0.0f);
+	if (m_touchPrediction || m_measurePrediction)
+	{
+		for (const InputSample& sample: m_inputFrame.samples)
+			m_touchPredictor.addSample(sample);
+
+		// only a single pointer drag (a pan that rotates the cube) is predicted
+		int32_t pointerId;
+		glm::vec2 offset;
+		const int64_t frameTime = isReplayStepping() ? m_inputReplayer->getTime() : getMonotonicTime();
+		if (m_gestures.getSingleContact(pointerId) && m_touchPredictor.predict(pointerId, frameTime, offset) && m_touchPrediction)
+			m_predictionOffset = offset;
+	}
+}
+
+void DemoRenderer::recordInputLatency(int64_t submitTime, int64_t swapTime)
+{
+	// the platform doesn't tell when the frame is actually presented, so the swap is the last point measured;
+	// the events of a stepped replay have the trace timing, which says nothing about the latency
+	if (!isReplayStepping())
+	{
+		for (const InputSample& sample: m_inputFrame.samples)
+		{
+			m_inputToSubmitLatency.add(submitTime - sample.eventTime);
+			m_inputToSwapLatency.add(swapTime - sample.eventTime);
+		}
+	}
+
+	const clock::time_point now = clock::now();
+	if (m_inputToSwapLatency.getCount() == 0 && !isReplayStepping())
+		m_latencyReportTime = now;
+	else if (now - m_latencyReportTime >= LATENCY_REPORT_PERIOD)
+	{
+		if (!isReplayStepping())
+		{
+			m_inputToSubmitLatency.report(std::cout);
+			m_inputToSwapLatency.report(std::cout);
+		}
+		m_touchPredictor.report(std::cout);
+		m_inputToSubmitLatency.reset();
+		m_inputToSwapLatency.reset();
+		m_latencyReportTime = now;
+	}
+}
+
+void DemoRenderer::recordFrameTime(int64_t frameStartTime, int64_t submitTime)
+{
+	m_cpuFrameTime.add(submitTime - frameStartTime);
+
+	// a fill-rate bound frame shows up as a GPU time well above the CPU time
+	const clock::time_point now = clock::now();
+	if (now - m_frameStatsReportTime >= FRAME_STATS_REPORT_PERIOD)
+	{
+		m_cpuFrameTime.report(std::cout);
+		m_gpuProfiler->report(std::cout);
+		MemoryTracker::get().report(std::cout);
+		reportGLErrors(std::cout);
+#ifdef MIRGLESDEMO_ALLOCATION_TRACKING
+		reportFrameAllocations();
+#endif
+		m_cpuFrameTime.reset();
+		m_gpuProfiler->reset();
+		m_frameStatsReportTime = now;
+	}
+}
+
+#ifdef MIRGLESDEMO_ALLOCATION_TRACKING
+void DemoRenderer::recordFrameAllocations(const AllocationCounters& frameStart)
+{
+	const AllocationCounters frameEnd = getThreadAllocationCounters();
+	const uint64_t allocations = frameEnd.allocations - frameStart.allocations;
+
+	m_allocationFrameCount++;
+	m_frameAllocations += allocations;
+	m_frameAllocatedBytes += frameEnd.bytes - frameStart.bytes;
+	m_maxFrameAllocations = std::max(m_maxFrameAllocations, allocations);
+}
+
+void DemoRenderer::reportFrameAllocations()
+{
+	std::cout << "Render thread allocations: " << m_frameAllocations << " (" << m_frameAllocatedBytes << " bytes) in "
+			  << m_allocationFrameCount << " frames, max " << m_maxFrameAllocations << " in a frame" << std::endl;
+	reportAllocationSites(std::cout);
+
+	m_allocationFrameCount = 0;
+	m_frameAllocations = 0;
+	m_frameAllocatedBytes = 0;
+	m_maxFrameAllocations = 0;
+}
+#endif
+
 void DemoRenderer::handleInputEvent(const MirInputEvent* inputEvent)
 {
 	const MirInputEventType inputType = mir_input_event_get_type(inputEvent);
+	const int64_t eventTime = mir_input_event_get_event_time(inputEvent);
 
 	switch (inputType)
 	{
@@ -231,7 +470,7 @@ void DemoRenderer::handleInputEvent(const MirInputEvent* inputEvent)
 		{
 			const MirTouchEvent* touchEvent = mir_input_event_get_touch_event(inputEvent);
 			if (touchEvent)
-				handleInputTouchEvent(touchEvent);
+				handleInputTouchEvent(touchEvent, eventTime);
 		}
 		break;
 
@@ -239,7 +478,7 @@ void DemoRenderer::handleInputEvent(const MirInputEvent* inputEvent)
 		{
 			const MirKeyboardEvent* keyboardEvent = mir_input_event_get_keyboard_event(inputEvent);
 			if (keyboardEvent)
-				handleKeyboardEvent(keyboardEvent);
+				handleKeyboardEvent(keyboardEvent, eventTime);
 		}
 		break;
 
@@ -247,71 +486,59 @@ void DemoRenderer::handleInputEvent(const MirInputEvent* inputEvent)
 		{
 			const MirPointerEvent* pointerEvent = mir_input_event_get_pointer_event(inputEvent);
 			if (pointerEvent)
-				handlePointerEvent(pointerEvent);
+				handlePointerEvent(pointerEvent, eventTime);
 		}
 		break;
 	}
 }
 
-void DemoRenderer::handleInputTouchEvent(const MirTouchEvent* touchEvent)
+void DemoRenderer::handleInputTouchEvent(const MirTouchEvent* touchEvent, int64_t eventTime)
 {
+	// all the contacts are passed on, the gesture engine tracks them
 	const unsigned touchCount = mir_touch_event_point_count(touchEvent);
-	unsigned touchIndex;
-
-	if (m_pointerState == PointerState::Up)
+	for (unsigned touchIndex = 0; touchIndex < touchCount; touchIndex++)
 	{
-		for (touchIndex = 0; touchIndex < touchCount; touchIndex++)
+		InputSample::Action sampleAction;
+		switch (mir_touch_event_action(touchEvent, touchIndex))
 		{
-			const MirTouchAction action = mir_touch_event_action(touchEvent, touchIndex);
-			if (action == mir_touch_action_down)
-				break;
+		case mir_touch_action_down:
+			sampleAction = InputSample::Action::Down;
+			break;
+		case mir_touch_action_change:
+			sampleAction = InputSample::Action::Move;
+			break;
+		case mir_touch_action_up:
+			sampleAction = InputSample::Action::Up;
+			break;
+		default:
+			continue;
 		}
-		if (touchIndex < touchCount)
-		{
-			m_pointerState = PointerState::FingerDown;
-			m_fingerId = mir_touch_event_id(touchEvent, touchIndex);
 
-			const float pointerX = mir_touch_event_axis_value(touchEvent, touchIndex, mir_touch_axis_x);
-			const float pointerY = mir_touch_event_axis_value(touchEvent, touchIndex, mir_touch_axis_y);
-			onPointerDown(pointerX, pointerY);
-		}
-	}
-	else if (m_pointerState == PointerState::FingerDown)
-	{
-		for (touchIndex = 0; touchIndex < touchCount; touchIndex++)
-		{
-			if (mir_touch_event_id(touchEvent, touchIndex) == m_fingerId)
-				break;
-		}
-		if (touchIndex < touchCount)
-		{
-			const MirTouchAction action = mir_touch_event_action(touchEvent, touchIndex);
-			if (action == mir_touch_action_change)
-			{
-				const float pointerX = mir_touch_event_axis_value(touchEvent, touchIndex, mir_touch_axis_x);
-				const float pointerY = mir_touch_event_axis_value(touchEvent, touchIndex, mir_touch_axis_y);
-				onPointerMove(pointerX, pointerY);
-			}
-			else if (action == mir_touch_action_up)
-			{
-				m_pointerState = PointerState::Up;
-
-				const float pointerX = mir_touch_event_axis_value(touchEvent, touchIndex, mir_touch_axis_x);
-				const float pointerY = mir_touch_event_axis_value(touchEvent, touchIndex, mir_touch_axis_y);
-				onPointerUp(pointerX, pointerY);
-			}
-		}
+		const MirTouchId touchId = mir_touch_event_id(touchEvent, touchIndex);
+		const float pointerX = mir_touch_event_axis_value(touchEvent, touchIndex, mir_touch_axis_x);
+		const float pointerY = mir_touch_event_axis_value(touchEvent, touchIndex, mir_touch_axis_y);
+		addInputSample(sampleAction, touchId, pointerX, pointerY, eventTime);
 	}
 }
 
-void DemoRenderer::handleKeyboardEvent(const MirKeyboardEvent* keyboardEvent)
+void DemoRenderer::handleKeyboardEvent(const MirKeyboardEvent* keyboardEvent, int64_t eventTime)
+{
+	const KeySample key = {
+		mir_keyboard_event_action(keyboardEvent),
+		mir_keyboard_event_scan_code(keyboardEvent),
+		mir_keyboard_event_key_code(keyboardEvent),
+		eventTime
+	};
+	onKey(key);
+}
+
+void DemoRenderer::onKey(const KeySample& key)
 {
-	const MirKeyboardAction action = mir_keyboard_event_action(keyboardEvent);
-	const int keyCode = mir_keyboard_event_scan_code(keyboardEvent);
-	const xkb_keysym_t keySym = mir_keyboard_event_key_code(keyboardEvent);
+	if (m_inputRecorder)
+		m_inputRecorder->addKey(key);
 
 	const char *actionString;
-	switch (action)
+	switch (key.action)
 	{
 	case mir_keyboard_action_down:
 		actionString = "DOWN";
@@ -326,10 +553,10 @@ void DemoRenderer::handleKeyboardEvent(const MirKeyboardEvent* keyboardEvent)
 		actionString = "UNKNOWN";
 	}
 
-	std::cout << "keyboard event " << actionString << ": key code=" << keyCode << ", key sym=" << keySym << std::endl;
+	LOG_DEBUG("keyboard event " << actionString << ": key code=" << key.scanCode << ", key sym=" << key.keySym);
 }
 
-void DemoRenderer::handlePointerEvent(const MirPointerEvent* pointerEvent)
+void DemoRenderer::handlePointerEvent(const MirPointerEvent* pointerEvent, int64_t eventTime)
 {
 	const MirPointerAction action = mir_pointer_event_action(pointerEvent);
 	const bool primaryButtonDown = mir_pointer_event_button_state(pointerEvent, mir_pointer_button_primary);
@@ -341,99 +568,112 @@ void DemoRenderer::handlePointerEvent(const MirPointerEvent* pointerEvent)
 		if (action == mir_pointer_action_button_down && primaryButtonDown)
 		{
 			m_pointerState = PointerState::PointerDown;
-			onPointerDown(pointerX, pointerY);
+			addInputSample(InputSample::Action::Down, InputSample::MOUSE_POINTER_ID, pointerX, pointerY, eventTime);
 		}
 	}
 	else if (m_pointerState == PointerState::PointerDown)
 	{
 		if ((action == mir_pointer_action_button_up && !primaryButtonDown) || action == mir_pointer_action_leave)
 		{
-			m_pointerState = PointerState::PointerDown;
-			onPointerUp(pointerX, pointerY);
+			m_pointerState = PointerState::Up;
+			addInputSample(InputSample::Action::Up, InputSample::MOUSE_POINTER_ID, pointerX, pointerY, eventTime);
 		}
 		else if (action == mir_pointer_action_motion)
 		{
-			onPointerMove(pointerX, pointerY);
+			addInputSample(InputSample::Action::Move, InputSample::MOUSE_POINTER_ID, pointerX, pointerY, eventTime);
 		}
 	}
 }
 
-void DemoRenderer::onPointerDown(float x, float y)
+void DemoRenderer::addInputSample(InputSample::Action action, int32_t pointerId, float x, float y, int64_t eventTime)
 {
-	std::cout << "onPointerDown " << x << "," << y << std::endl;
+	const InputSample sample = { action, pointerId, x, y, eventTime };
+	addInputSample(sample);
+}
+
+void DemoRenderer::addInputSample(const InputSample& sample)
+{
+	if (m_inputRecorder)
+		m_inputRecorder->addSample(sample);
+
+	m_inputBatch.add(sample);
+}
+
+void DemoRenderer::onReplayedSample(const InputSample& sample)
+{
+	addInputSample(sample);
+}
+
+void DemoRenderer::onReplayedKey(const KeySample& key)
+{
+	onKey(key);
+}
+
+bool DemoRenderer::isReplayStepping() const
+{
+	return m_inputReplayer && m_inputReplayer->getStep() != 0;
+}
+
+void DemoRenderer::onGestureStart()
+{
+	LOG_DEBUG("onGestureStart");
 
 	// stop any posible rotation
 	m_rotationAngularSpeedX = 0.0f;
 	m_rotationAngularSpeedY = 0.0f;
+}
 
-	// store the start position
-	m_lastX = x;
-	m_lastY = y;
-
-	// notify gesture handler
-	m_swipeGesture.down(x, y);
+void DemoRenderer::onPan(float dx, float dy)
+{
+	LOG_DEBUG("onPan " << dx << "," << dy);
+	rotateCube(dx, dy);
 }
 
-void DemoRenderer::onPointerMove(float x, float y)
+void DemoRenderer::onPinch(float scale)
 {
-	std::cout << "onPointerMove " << x << "," << y << std::endl;
-	rotateCube(x, y);
+	LOG_DEBUG("onPinch " << scale);
+
+	// moving the fingers apart brings the die closer
+	m_cameraDistance = std::min(std::max(m_cameraDistance / scale, MIN_CAMERA_DISTANCE), MAX_CAMERA_DISTANCE);
 }
 
-void DemoRenderer::onPointerUp(float x, float y)
+void DemoRenderer::onRotate(float angle)
 {
-	std::cout << "onPointerUp " << x << "," << y << std::endl;
-	rotateCube(x, y);
-	m_swipeGesture.up(x, y);
+	LOG_DEBUG("onRotate " << angle);
+
+	// the screen y axis points down, so clockwise on the screen is a negative rotation along the GL z axis
+	m_rotationAngleZ -= angle;
+	clampAngle(m_rotationAngleZ);
 }
 
-void DemoRenderer::onSwipe(float dx, float dy)
+void DemoRenderer::onFling(float dx, float dy)
 {
-	std::cout << "onSwipe " << dx << "," << dy << std::endl;
+	LOG_DEBUG("onFling " << dx << "," << dy);
 
 	// the rotation axis is perpendicular to the movement -> dx affects rotation along Y and dy affects X
 	m_rotationAngularSpeedX = dy / 100.0f; // dy is in screen coordinates, -dy_{gl} = dy_{screen}
 	m_rotationAngularSpeedY = dx / 100.0f;
 }
 
-void DemoRenderer::rotateCube(float x, float y)
+void DemoRenderer::rotateCube(float dx, float dy)
 {
 	// it would be better to implement something like https://www.khronos.org/opengl/wiki/Object_Mouse_Trackball
 	// the following must suffice here :)
-	const float dx = x - m_lastX;
-	const float dy = m_lastY - y; // y axis coordinate grows downwards, but GLES y coordinate grows upwards (by default)
-
-	m_rotationAngleX += -dy/ 500;
+	// y axis coordinate grows downwards, but GLES y coordinate grows upwards (by default)
+	m_rotationAngleX += dy / 500;
 	m_rotationAngleY += dx / 400;
 
 	clampAngle(m_rotationAngleX);
 	clampAngle(m_rotationAngleY);
-
-	m_lastX = x;
-	m_lastY = y;
 }
 
-void DemoRenderer::rotateAlongAxis(float& rotationAngle, float& rotationAngularSpeed, float secsSinceLastFrame)
+void DemoRenderer::setPose(const GoldenPose& pose)
 {
-	const float DECELERATION = 2.0f; // rad/s^2
-
-	if (rotationAngularSpeed == 0.0f)
-		return; // nothing to do
-
-	const float d = rotationAngularSpeed > 0.0f ? DECELERATION : -DECELERATION;
-	const float t_E = rotationAngularSpeed / d; // time when the rotation should stop
-
-	if (secsSinceLastFrame > t_E)
-	{
-		// the rotation has stopped somewhere between this and the previous frame
-		rotationAngle += (rotationAngularSpeed - 0.5f * d * t_E) * t_E;
-	}
-	else
-	{
-		// the rotation continues, but the speed is decreased
-		rotationAngle += (rotationAngularSpeed - 0.5f * d* secsSinceLastFrame) * secsSinceLastFrame;
-		rotationAngularSpeed -= d * secsSinceLastFrame;
-	}
-
-	clampAngle(rotationAngle);
+	// replaces the state driven by the input, so that the frame doesn't depend on the timing
+	m_rotationAngularSpeedX = 0.0f;
+	m_rotationAngularSpeedY = 0.0f;
+	m_rotationAngleX = pose.angleX;
+	m_rotationAngleY = pose.angleY;
+	m_rotationAngleZ = pose.angleZ;
+	m_cameraDistance = pose.cameraDistance;
 }
@@ -20,6 +20,7 @@
 #define DEMO_RENDERER_H
 
 #include <chrono>
+#include <memory>
 
 #include <mir_toolkit/events/event.h>
 #include <GLES2/gl2.h>
@@ -28,12 +29,37 @@
 
 #include "MirNativeWindowRenderer.h"
 #include "MirNativeWindowControl.h"
-#include "SwipeGesture.h"
-
-class DemoRenderer: public MirNativeWindowRenderer, private SwipeGesture::Listener
+#include "gl/GpuProfiler.h"
+#include "GestureEngine.h"
+#include "InputBatch.h"
+#include "LatencyHistogram.h"
+#include "TouchPredictor.h"
+#include "InputTrace.h"
+#include "Options.h"
+#include "AssetPipeline.h"
+#include "ResourceManager.h"
+#include "TextureResidencyManager.h"
+#include "PhaseTimer.h"
+#include "AllocationTracker.h"
+#include "Benchmark.h"
+#include "GoldenImageCheck.h"
+
+class DemoRenderer: public MirNativeWindowRenderer, private GestureEngine::Listener, private InputReplayer::Listener
 {
 public:
-	DemoRenderer();
+	/**
+	 * @param benchmark if not null, the frame rate is not capped and run() returns when the benchmark is finished
+	 * @param goldenCheck if not null, the cube is rendered in its poses instead of following the input; the benchmark
+	 * must then have its timed frames
+	 */
+	DemoRenderer(std::shared_ptr<AssetPipeline> assets, std::shared_ptr<PhaseTimer> startupTimer, const Options& options,
+			std::shared_ptr<Benchmark> benchmark = nullptr, std::shared_ptr<GoldenImageCheck> goldenCheck = nullptr);
+
+	/**
+	 * Request loading of all the assets the renderer needs.
+	 */
+	static void preloadAssets(AssetPipeline& assets);
+
 	virtual void run(MirNativeWindowControl& nativeWindow) override;
 	virtual void handleEvent(const MirEvent* event) override;
 
@@ -41,46 +67,102 @@ private:
 	typedef std::chrono::steady_clock clock;
 
 	void renderFrame();
+	void processInput();
+	void recordInputLatency(int64_t submitTime, int64_t swapTime);
+	void recordFrameTime(int64_t frameStartTime, int64_t submitTime);
+#ifdef MIRGLESDEMO_ALLOCATION_TRACKING
+	void recordFrameAllocations(const AllocationCounters& frameStart);
+	void reportFrameAllocations();
+#endif
 	void handleInputEvent(const MirInputEvent* inputEvent);
-	void handleInputTouchEvent(const MirTouchEvent* touchEvent);
-	void handleKeyboardEvent(const MirKeyboardEvent* keyboardEvent);
-	void handlePointerEvent(const MirPointerEvent* pointerEvent);
+	void handleInputTouchEvent(const MirTouchEvent* touchEvent, int64_t eventTime);
+	void handleKeyboardEvent(const MirKeyboardEvent* keyboardEvent, int64_t eventTime);
+	void handlePointerEvent(const MirPointerEvent* pointerEvent, int64_t eventTime);
+	void addInputSample(InputSample::Action action, int32_t pointerId, float x, float y, int64_t eventTime);
+	void addInputSample(const InputSample& sample);
+	void onKey(const KeySample& key);
 
-	void onPointerDown(float x, float y);
-	void onPointerMove(float x, float y);
-	void onPointerUp(float x, float y);
+	virtual void onReplayedSample(const InputSample& sample) override;
+	virtual void onReplayedKey(const KeySample& key) override;
 
-	virtual void onSwipe(float x, float y) override;
+	virtual void onGestureStart() override;
+	virtual void onPan(float dx, float dy) override;
+	virtual void onPinch(float scale) override;
+	virtual void onRotate(float angle) override;
+	virtual void onFling(float dx, float dy) override;
 
-	void rotateCube(float x, float y);
+	void rotateCube(float dx, float dy);
+	void setPose(const GoldenPose& pose);
 
-	static void rotateAlongAxis(float& rotationAngle, float &rotationAngularSpeed, float secsSinceLastFrame);
+	/** True if the input is replayed with a fixed step per frame (so its time isn't the wall clock). */
+	bool isReplayStepping() const;
 
 	enum class PointerState
 	{
 		Up,
-		PointerDown,
-		FingerDown
+		PointerDown
 	};
 
+	std::shared_ptr<AssetPipeline> m_assets;
+	std::shared_ptr<PhaseTimer> m_startupTimer;
+	std::shared_ptr<Benchmark> m_benchmark;
+	std::shared_ptr<GoldenImageCheck> m_goldenCheck;
+	ResourceManager m_resources;
+	TextureResidencyManager m_textures;
+	TextureResidencyManager::TextureId m_dieTexture;
+
 	GLuint m_mvpMatrixIndex;
 	glm::mat4 m_projectionMatrix;
 	GLuint m_cubeVertexCount;
+	// the mouse button state is tracked on the event thread, the samples are processed on the render thread
 	PointerState m_pointerState;
-	MirTouchId m_fingerId;
+	InputBatch m_inputBatch;
+	InputFrame m_inputFrame;
+	std::unique_ptr<InputRecorder> m_inputRecorder;
+	std::unique_ptr<InputReplayer> m_inputReplayer;
+
+	// from the input event timestamp to the end of the frame that consumed it
+	LatencyHistogram m_inputToSubmitLatency;
+	LatencyHistogram m_inputToSwapLatency;
+	clock::time_point m_latencyReportTime;
+
+	// CPU time spent in renderFrame() and GPU time of its passes; the profiler needs the GL context, so it's created in run()
+	LatencyHistogram m_cpuFrameTime;
+	std::unique_ptr<GpuProfiler> m_gpuProfiler;
+	clock::time_point m_frameStatsReportTime;
+
+	GestureEngine m_gestures;
 
-	float m_lastX;
-	float m_lastY;
+	// the predicted movement of the dragged pointer is only displayed, it doesn't change the rotation state
+	bool m_touchPrediction;
+	bool m_measurePrediction;
+	TouchPredictor m_touchPredictor;
+	glm::vec2 m_predictionOffset;
 
 	float m_rotationAngularSpeedX;
 	float m_rotationAngularSpeedY;
 
 	float m_rotationAngleX;
 	float m_rotationAngleY;
+	float m_rotationAngleZ;
+	float m_cameraDistance;
+
+	// written after the given number of frames (if tracing is compiled in)
+	std::string m_traceFile;
+	unsigned m_traceFrames;
+
+	// allocations in the allocation scopes abort after this many frames (0: never; if allocation tracking is compiled in)
+	unsigned m_assertNoAllocationsAfter;
+#ifdef MIRGLESDEMO_ALLOCATION_TRACKING
+	// render thread allocations since the last report
+	uint64_t m_allocationFrameCount;
+	uint64_t m_frameAllocations;
+	uint64_t m_frameAllocatedBytes;
+	uint64_t m_maxFrameAllocations;
+#endif
 
 	bool m_lastFrameTimeStampValid;
 	clock::time_point m_lastFrameTimeStamp;
-	SwipeGesture m_swipeGesture;
 };
 
 #endif // DEMO_RENDERER_H
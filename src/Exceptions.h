@@ -24,6 +24,8 @@
 #include <EGL/egl.h>
 #include <GLES2/gl2.h>
 
+#include "gl/GLCheck.h"
+
 inline std::string getMirErrorString(MirConnection* connection)
 {
 	return mir_connection_get_error_message(connection);
@@ -74,22 +76,11 @@ inline std::string getEGLErrorString()
 
 inline std::string getGLErrorString()
 {
-	const EGLint error = eglGetError();
-	switch (error)
-	{
-	case GL_INVALID_ENUM:
-		return "GL_INVALID_ENUM";
-	case GL_INVALID_VALUE:
-		return "GL_INVALID_VALUE";
-	case GL_INVALID_OPERATION:
-		return "GL_INVALID_OPERATION";
-	case GL_INVALID_FRAMEBUFFER_OPERATION:
-		return "GL_INVALID_FRAMEBUFFER_OPERATION";
-	case GL_OUT_OF_MEMORY:
-		return "GL_OUT_OF_MEMORY";
-	default:
+	const GLenum error = glGetError();
+	if (error == GL_NO_ERROR)
 		return ""; // no info available
-	}
+
+	return getGLErrorName(error);
 }
 
 inline std::string formatErrorString(std::string&& description, const std::string& detail)
@@ -0,0 +1,99 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "FrameArena.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace
+{
+	// heap fallbacks per frame that can be tracked without growing the list
+	const size_t OVERFLOW_RESERVE = 64;
+}
+
+FrameArena::FrameArena(size_t capacity):
+	m_capacity(capacity),
+	m_current(0),
+	m_memory(MemoryCategory::Staging, "frame arena", 2 * capacity)
+{
+	for (Buffer& buffer: m_buffers)
+	{
+		buffer.data.reset(new unsigned char[capacity]);
+		buffer.offset = 0;
+		buffer.overflow.reserve(OVERFLOW_RESERVE);
+		buffer.overflowBytes = 0;
+	}
+
+	resetStatistics();
+}
+
+void* FrameArena::allocate(size_t size, size_t alignment)
+{
+	Buffer& buffer = m_buffers[m_current];
+
+	const uintptr_t base = reinterpret_cast<uintptr_t>(buffer.data.get());
+	const uintptr_t aligned = (base + buffer.offset + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+	const size_t offset = aligned - base;
+	if (offset + size <= m_capacity)
+	{
+		buffer.offset = offset + size;
+		return buffer.data.get() + offset;
+	}
+
+	// new[] returns memory aligned for any fundamental type
+	buffer.overflow.emplace_back(new unsigned char[size]);
+	buffer.overflowBytes += size;
+	m_overflowCount++;
+	m_overflowBytes += size;
+	return buffer.overflow.back().get();
+}
+
+void FrameArena::endFrame()
+{
+	m_highWaterMark = std::max(m_highWaterMark, getUsed());
+
+	m_current = 1 - m_current;
+
+	Buffer& buffer = m_buffers[m_current];
+	buffer.offset = 0;
+	if (!buffer.overflow.empty())
+	{
+		buffer.overflow.clear();
+		buffer.overflowBytes = 0;
+	}
+}
+
+size_t FrameArena::getUsed() const
+{
+	const Buffer& buffer = m_buffers[m_current];
+	return buffer.offset + buffer.overflowBytes;
+}
+
+void FrameArena::resetStatistics()
+{
+	m_highWaterMark = 0;
+	m_overflowCount = 0;
+	m_overflowBytes = 0;
+}
+
+void FrameArena::report(std::ostream& os) const
+{
+	os << "Frame arena: high-water mark " << m_highWaterMark << " of " << m_capacity << " bytes, "
+	   << m_overflowCount << " allocations (" << m_overflowBytes << " bytes) didn't fit" << std::endl;
+}
@@ -0,0 +1,148 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include "MemoryTracker.h"
+
+#include <array>
+#include <vector>
+#include <memory>
+#include <ostream>
+#include <cstddef>
+
+/**
+ * Bump allocator for data that lives for at most two frames.
+ *
+ * There are two buffers: one is allocated from during a frame, the other one
+ * holds the data of the previous frame (e.g. still needed when the frame is
+ * submitted). endFrame() swaps them and resets the one that becomes current,
+ * in O(1). Individual deallocations do nothing.
+ *
+ * If a frame needs more than the capacity, the rest is allocated from the heap
+ * (and freed on reset); the report shows that, so that the capacity can be tuned.
+ * The list of these allocations is reserved up front, so that it doesn't grow too.
+ * Not thread safe: meant to be used by the render thread only.
+ */
+class FrameArena
+{
+public:
+	explicit FrameArena(size_t capacity);
+
+	void* allocate(size_t size, size_t alignment);
+
+	/**
+	 * Start a new frame. Invalidates the data allocated in the frame before the one that just ended.
+	 */
+	void endFrame();
+
+	size_t getCapacity() const
+	{
+		return m_capacity;
+	}
+
+	/** Bytes allocated in the current frame, including the heap fallback. */
+	size_t getUsed() const;
+
+	/** Largest getUsed() at the end of a frame since the last resetStatistics(). */
+	size_t getHighWaterMark() const
+	{
+		return m_highWaterMark;
+	}
+
+	void resetStatistics();
+	void report(std::ostream& os) const;
+
+	// disallow copy and move
+	FrameArena& operator=(FrameArena&&) = delete;
+	FrameArena(FrameArena&&) = delete;
+	FrameArena& operator=(const FrameArena&) = delete;
+	FrameArena(const FrameArena&) = delete;
+
+private:
+	struct Buffer
+	{
+		std::unique_ptr<unsigned char[]> data;
+		size_t offset;
+		std::vector<std::unique_ptr<unsigned char[]>> overflow;
+		size_t overflowBytes;
+	};
+
+	size_t m_capacity;
+	std::array<Buffer, 2> m_buffers;
+	size_t m_current;
+	TrackedMemory m_memory;
+
+	size_t m_highWaterMark;
+	size_t m_overflowCount;
+	size_t m_overflowBytes;
+};
+
+/**
+ * Allocator adapter for the standard containers (std::pmr is C++17, this is the C++11 equivalent
+ * of a polymorphic_allocator over a FrameArena). A container using it must not outlive the next frame.
+ */
+template<typename T>
+class ArenaAllocator
+{
+public:
+	typedef T value_type;
+
+	explicit ArenaAllocator(FrameArena& arena):
+		m_arena(&arena)
+	{}
+
+	template<typename U>
+	ArenaAllocator(const ArenaAllocator<U>& other):
+		m_arena(other.getArena())
+	{}
+
+	T* allocate(size_t n)
+	{
+		return static_cast<T*>(m_arena->allocate(n * sizeof(T), alignof(T)));
+	}
+
+	void deallocate(T*, size_t)
+	{}
+
+	FrameArena* getArena() const
+	{
+		return m_arena;
+	}
+
+private:
+	FrameArena* m_arena;
+};
+
+template<typename T, typename U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b)
+{
+	return a.getArena() == b.getArena();
+}
+
+template<typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b)
+{
+	return a.getArena() != b.getArena();
+}
+
+template<typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+#endif // FRAME_ARENA_H
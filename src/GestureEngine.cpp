@@ -0,0 +1,196 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "GestureEngine.h"
+
+#include <cmath>
+
+namespace
+{
+	// below this spread (in pixels), the contacts are too close to measure a pinch reliably
+	const float MIN_PINCH_SPREAD = 10.0f;
+
+	float wrapAngle(float angle)
+	{
+		while (angle > M_PI)
+			angle -= 2.0 * M_PI;
+		while (angle <= -M_PI)
+			angle += 2.0 * M_PI;
+		return angle;
+	}
+}
+
+GestureEngine::GestureEngine(Listener& listener):
+	m_listener(listener),
+	m_contactCount(0),
+	m_centroid(0.0f, 0.0f),
+	m_spread(0.0f),
+	m_angle(0.0f),
+	m_swipeCount(0),
+	m_swipePointerId(0),
+	m_started(false),
+	m_pan(0.0f, 0.0f),
+	m_scale(1.0f),
+	m_rotation(0.0f),
+	m_flung(false),
+	m_fling(0.0f, 0.0f),
+	m_swipeGesture(*this)
+{
+}
+
+void GestureEngine::process(const InputFrame& frame)
+{
+	m_swipeCount = 0;
+	for (const InputSample& sample: frame.samples)
+	{
+		m_swipePointerId = sample.pointerId;
+		m_swipeGesture.addSample(sample);
+	}
+
+	m_started = false;
+	m_pan = glm::vec2(0.0f, 0.0f);
+	m_scale = 1.0f;
+	m_rotation = 0.0f;
+	m_flung = false;
+
+	for (const InputSample& sample: frame.coalesced)
+		addSample(sample);
+
+	if (m_started)
+		m_listener.onGestureStart();
+	if (m_pan.x != 0.0f || m_pan.y != 0.0f)
+		m_listener.onPan(m_pan.x, m_pan.y);
+	if (m_scale != 1.0f)
+		m_listener.onPinch(m_scale);
+	if (m_rotation != 0.0f)
+		m_listener.onRotate(m_rotation);
+	// a fling followed by a new touch in the same frame is cancelled
+	if (m_flung && m_contactCount == 0)
+		m_listener.onFling(m_fling.x, m_fling.y);
+}
+
+void GestureEngine::addSample(const InputSample& sample)
+{
+	Contact* contact = find(sample.pointerId);
+	const glm::vec2 position(sample.x, sample.y);
+
+	switch (sample.action)
+	{
+	case InputSample::Action::Down:
+		if (!contact)
+		{
+			if (m_contactCount == MAX_CONTACTS)
+				return;
+
+			if (m_contactCount == 0)
+			{
+				m_started = true;
+				m_flung = false;
+			}
+
+			contact = &m_contacts[m_contactCount++];
+			contact->id = sample.pointerId;
+		}
+		contact->position = position;
+		updateReference();
+		break;
+
+	case InputSample::Action::Move:
+		{
+			if (!contact)
+				return;
+
+			contact->position = position;
+
+			const glm::vec2 oldCentroid = m_centroid;
+			const float oldSpread = m_spread;
+			const float oldAngle = m_angle;
+			updateReference();
+
+			m_pan += m_centroid - oldCentroid;
+			if (m_contactCount >= 2)
+			{
+				if (oldSpread >= MIN_PINCH_SPREAD && m_spread >= MIN_PINCH_SPREAD)
+					m_scale *= m_spread / oldSpread;
+				m_rotation += wrapAngle(m_angle - oldAngle);
+			}
+		}
+		break;
+
+	case InputSample::Action::Up:
+		if (!contact)
+			return;
+
+		// only the release of the last contact is a fling
+		if (m_contactCount == 1)
+		{
+			for (size_t i = 0; i < m_swipeCount; i++)
+			{
+				if (m_swipes[i].id == sample.pointerId)
+				{
+					m_flung = true;
+					m_fling = m_swipes[i].distance;
+				}
+			}
+		}
+
+		// the last contact takes the place of the released one
+		*contact = m_contacts[--m_contactCount];
+		updateReference();
+		break;
+	}
+}
+
+GestureEngine::Contact* GestureEngine::find(int32_t id)
+{
+	for (size_t i = 0; i < m_contactCount; i++)
+	{
+		if (m_contacts[i].id == id)
+			return &m_contacts[i];
+	}
+
+	return nullptr;
+}
+
+void GestureEngine::updateReference()
+{
+	if (m_contactCount == 0)
+		return;
+
+	glm::vec2 sum(0.0f, 0.0f);
+	for (size_t i = 0; i < m_contactCount; i++)
+		sum += m_contacts[i].position;
+	m_centroid = sum * (1.0f / m_contactCount);
+
+	float spread = 0.0f;
+	for (size_t i = 0; i < m_contactCount; i++)
+		spread += glm::length(m_contacts[i].position - m_centroid);
+	m_spread = spread / m_contactCount;
+
+	if (m_contactCount >= 2)
+	{
+		const glm::vec2 d = m_contacts[1].position - m_contacts[0].position;
+		m_angle = std::atan2(d.y, d.x);
+	}
+}
+
+void GestureEngine::onSwipe(float dx, float dy)
+{
+	if (m_swipeCount < MAX_CONTACTS)
+		m_swipes[m_swipeCount++] = Fling{m_swipePointerId, glm::vec2(dx, dy)};
+}
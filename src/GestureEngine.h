@@ -0,0 +1,136 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GESTURE_ENGINE_H
+#define GESTURE_ENGINE_H
+
+#include "InputBatch.h"
+#include "SwipeGesture.h"
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Recognizes pan, pinch, two-finger rotation and fling at the same time,
+ * from any number of contacts (touch points or the mouse).
+ *
+ * The contacts are kept in a fixed size table, so processing an event
+ * doesn't allocate. The fling velocity is estimated from all the samples of
+ * a frame, everything else only needs the coalesced ones. The movement is
+ * accumulated and the listener is called at most once per kind of gesture
+ * and frame.
+ */
+class GestureEngine: private SwipeGesture::Listener
+{
+public:
+	struct Listener
+	{
+		/** The first contact went down. */
+		virtual void onGestureStart() = 0;
+
+		/** The centroid of the contacts moved, in pixels. */
+		virtual void onPan(float dx, float dy) = 0;
+
+		/** The contacts moved apart (scale > 1) or together (scale < 1). */
+		virtual void onPinch(float scale) = 0;
+
+		/** The first two contacts turned, in radians (clockwise on the screen is positive). */
+		virtual void onRotate(float angle) = 0;
+
+		/** The last contact was released while moving, see SwipeGesture::Listener::onSwipe(). */
+		virtual void onFling(float dx, float dy) = 0;
+	};
+
+	/** Contacts over this count are ignored. */
+	static const size_t MAX_CONTACTS = 10;
+
+	explicit GestureEngine(Listener& listener);
+
+	/**
+	 * Process the input samples of a frame and notify the listener.
+	 */
+	void process(const InputFrame& frame);
+
+	size_t getContactCount() const
+	{
+		return m_contactCount;
+	}
+
+	/**
+	 * Get the id of the only contact.
+	 * @return False if there isn't exactly one contact.
+	 */
+	bool getSingleContact(int32_t& id) const
+	{
+		if (m_contactCount != 1)
+			return false;
+
+		id = m_contacts[0].id;
+		return true;
+	}
+
+private:
+	struct Contact
+	{
+		int32_t id;
+		glm::vec2 position;
+	};
+
+	struct Fling
+	{
+		int32_t id;
+		glm::vec2 distance;
+	};
+
+	void addSample(const InputSample& sample);
+	Contact* find(int32_t id);
+
+	/** Recompute the centroid, spread and angle of the contacts without reporting any movement. */
+	void updateReference();
+
+	virtual void onSwipe(float dx, float dy) override;
+
+	Listener& m_listener;
+
+	std::array<Contact, MAX_CONTACTS> m_contacts;
+	size_t m_contactCount;
+
+	glm::vec2 m_centroid;
+	float m_spread; // mean distance of the contacts from the centroid
+	float m_angle; // of the line from the first to the second contact
+
+	// swipes of the released pointers in the current frame
+	std::array<Fling, MAX_CONTACTS> m_swipes;
+	size_t m_swipeCount;
+	int32_t m_swipePointerId;
+
+	// accumulated over a frame
+	bool m_started;
+	glm::vec2 m_pan;
+	float m_scale;
+	float m_rotation;
+	bool m_flung;
+	glm::vec2 m_fling;
+
+	SwipeGesture m_swipeGesture;
+};
+
+#endif // GESTURE_ENGINE_H
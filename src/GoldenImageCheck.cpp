@@ -0,0 +1,239 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "GoldenImageCheck.h"
+#include "PNGLoader.h"
+#include "Log.h"
+#include "gl/GLCheck.h"
+
+#include <GLES2/gl2.h>
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <cerrno>
+#include <cstdlib>
+
+#include <sys/stat.h>
+
+namespace
+{
+	// the cube from the front, from a corner, from behind (the faces 4, 5 and 6), close up and far away
+	const GoldenPose POSES[] = {
+		{ "front", 0.0f, 0.0f, 0.0f, 6.0f },
+		{ "corner", 0.6f, -0.8f, 0.0f, 6.0f },
+		{ "back", -0.4f, 2.5f, 0.7f, 6.0f },
+		{ "close", 0.3f, 0.4f, -0.3f, 3.5f },
+		{ "far", -0.9f, 1.2f, 0.2f, 16.0f }
+	};
+
+	const size_t POSE_COUNT = sizeof(POSES) / sizeof(POSES[0]);
+
+	void createDirectory(const std::string& directory)
+	{
+		if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST)
+			throw std::runtime_error("Can't create directory " + directory);
+	}
+
+	/** The differing pixels in red over a dimmed copy of the image. */
+	Image makeDiffImage(const Image& image, const Image& golden, unsigned channelTolerance)
+	{
+		const size_t size = image.getSize();
+		std::unique_ptr<unsigned char[]> data(new unsigned char[size]);
+		const unsigned char* a = image.getData();
+		const unsigned char* b = golden.getData();
+		for (size_t i = 0; i < size; i += 4)
+		{
+			unsigned difference = 0;
+			for (size_t c = 0; c < 3; c++)
+				difference = std::max<unsigned>(difference, std::abs(a[i + c] - b[i + c]));
+
+			const unsigned char gray = static_cast<unsigned char>((a[i] + a[i + 1] + a[i + 2]) / 9);
+			const bool differs = difference > channelTolerance;
+			data[i] = differs ? 255 : gray;
+			data[i + 1] = differs ? 0 : gray;
+			data[i + 2] = differs ? 0 : gray;
+			data[i + 3] = 255;
+		}
+
+		return Image(image.getWidth(), image.getHeight(), std::move(data), "golden image diff");
+	}
+}
+
+GoldenImageCheck::GoldenImageCheck(std::string directory, Mode mode, unsigned channelTolerance, float maxDifferingPercent,
+		unsigned framesPerPose):
+	m_directory(std::move(directory)),
+	m_mode(mode),
+	m_channelTolerance(channelTolerance),
+	m_maxDifferingPercent(maxDifferingPercent),
+	m_framesPerPose(framesPerPose),
+	m_frame(-1)
+{
+	if (framesPerPose == 0)
+		throw std::runtime_error("The golden image check needs at least one timed frame per pose.");
+
+	m_results.reserve(POSE_COUNT);
+}
+
+unsigned GoldenImageCheck::getTimedFrameCount() const
+{
+	return POSE_COUNT * m_framesPerPose;
+}
+
+const GoldenPose& GoldenImageCheck::beginFrame()
+{
+	m_frame++;
+
+	// the poses are kept after the last one, in case the renderer goes on
+	const size_t pose = std::min<size_t>(m_frame / (m_framesPerPose + 1), POSE_COUNT - 1);
+	return POSES[pose];
+}
+
+bool GoldenImageCheck::isCaptureFrame() const
+{
+	return m_frame >= 0 && m_frame % (m_framesPerPose + 1) == 0 && static_cast<size_t>(m_frame / (m_framesPerPose + 1)) < POSE_COUNT;
+}
+
+void GoldenImageCheck::capture(int width, int height)
+{
+	if (!isCaptureFrame())
+		return;
+
+	const GoldenPose& pose = POSES[m_frame / (m_framesPerPose + 1)];
+
+	// the same bottom to top row order as the images from loadPNG()
+	const size_t size = static_cast<size_t>(width) * height * 4;
+	std::unique_ptr<unsigned char[]> data(new unsigned char[size]);
+	GL_CHECK(glPixelStorei(GL_PACK_ALIGNMENT, 4));
+	GL_CHECK(glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, data.get()));
+
+	// the surface may have no alpha channel, only the color is compared
+	for (size_t i = 3; i < size; i += 4)
+		data[i] = 255;
+
+	const Image image(width, height, std::move(data), "golden image capture");
+
+	const std::string baseName = std::string("cube-") + pose.name + "-" + std::to_string(width) + "x" + std::to_string(height);
+	const std::string fileName = m_directory + "/" + baseName + ".png";
+
+	if (m_mode == Mode::Update)
+	{
+		createDirectory(m_directory);
+		savePNG(fileName, image);
+		m_results.push_back(Result{&pose, fileName, true, false, true, 0, 0.0, 0, 0.0});
+		LOG_INFO("Golden image written to " << fileName);
+		return;
+	}
+
+	struct stat fileStatus;
+	if (stat(fileName.c_str(), &fileStatus) != 0)
+	{
+		m_results.push_back(Result{&pose, fileName, false, true, false, 0, 0.0, 0, 0.0});
+		return;
+	}
+
+	const Image golden = loadPNG(fileName);
+	Result result = compare(pose, fileName, image, golden);
+	if (!result.passed)
+	{
+		// written to the current directory, to be picked up e.g. as CI artifacts
+		savePNG(baseName + ".actual.png", image);
+		if (golden.getWidth() == image.getWidth() && golden.getHeight() == image.getHeight())
+			savePNG(baseName + ".diff.png", makeDiffImage(image, golden, m_channelTolerance));
+		LOG_ERROR("Golden image check of pose " << pose.name << " failed, see " << baseName << ".actual.png");
+	}
+
+	m_results.push_back(std::move(result));
+}
+
+GoldenImageCheck::Result GoldenImageCheck::compare(const GoldenPose& pose, const std::string& fileName, const Image& image,
+		const Image& golden) const
+{
+	Result result{&pose, fileName, false, false, false, 0, 0.0, 0, 0.0};
+
+	const size_t pixelCount = static_cast<size_t>(image.getWidth()) * image.getHeight();
+	if (golden.getWidth() != image.getWidth() || golden.getHeight() != image.getHeight())
+	{
+		result.differingPixels = pixelCount;
+		result.differingPercent = 100.0;
+		return result;
+	}
+
+	const unsigned char* a = image.getData();
+	const unsigned char* b = golden.getData();
+	uint64_t differenceSum = 0;
+	for (size_t i = 0; i < pixelCount * 4; i += 4)
+	{
+		unsigned difference = 0;
+		for (size_t c = 0; c < 3; c++)
+		{
+			const unsigned channelDifference = std::abs(a[i + c] - b[i + c]);
+			difference = std::max(difference, channelDifference);
+			differenceSum += channelDifference;
+		}
+
+		if (difference > m_channelTolerance)
+			result.differingPixels++;
+		result.maxDifference = std::max(result.maxDifference, difference);
+	}
+
+	result.differingPercent = pixelCount > 0 ? 100.0 * result.differingPixels / pixelCount : 0.0;
+	result.meanDifference = pixelCount > 0 ? static_cast<double>(differenceSum) / (pixelCount * 3) : 0.0;
+	result.passed = result.differingPercent <= m_maxDifferingPercent;
+	return result;
+}
+
+bool GoldenImageCheck::isFinished() const
+{
+	return m_results.size() == POSE_COUNT;
+}
+
+bool GoldenImageCheck::hasPassed() const
+{
+	if (!isFinished())
+		return false;
+
+	for (const Result& result: m_results)
+		if (!result.passed)
+			return false;
+
+	return true;
+}
+
+void GoldenImageCheck::report(std::ostream& os) const
+{
+	os << "Golden image check (tolerance " << m_channelTolerance << " per channel, at most " << m_maxDifferingPercent
+	   << "% differing pixels):" << std::endl;
+
+	for (const Result& result: m_results)
+	{
+		os << "  " << result.pose->name << ": ";
+		if (result.written)
+			os << "written to " << result.fileName;
+		else if (result.missing)
+			os << "FAILED, missing " << result.fileName << " (create it with --update-golden)";
+		else
+			os << (result.passed ? "passed" : "FAILED") << ", " << result.differingPixels << " differing pixels ("
+			   << result.differingPercent << "%), max difference " << result.maxDifference
+			   << ", mean difference " << result.meanDifference;
+		os << std::endl;
+	}
+
+	if (!isFinished())
+		os << "  FAILED, only " << m_results.size() << " of " << POSE_COUNT << " poses rendered" << std::endl;
+}
@@ -0,0 +1,126 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GOLDEN_IMAGE_CHECK_H
+#define GOLDEN_IMAGE_CHECK_H
+
+#include "Image.h"
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * A fixed view of the cube, set instead of the rotation state driven by the input.
+ */
+struct GoldenPose
+{
+	const char* name;
+	float angleX;
+	float angleY;
+	float angleZ;
+	float cameraDistance;
+};
+
+/**
+ * Renders the cube in a fixed sequence of poses and compares each pose with
+ * a golden image (or writes the golden images).
+ *
+ * The renderer calls beginFrame() at the start of each frame and renders the
+ * returned pose. The first frame of a pose is read back with capture() before
+ * the swap; the following frames are timed, so a Benchmark with
+ * getTimedFrameCount() frames records the frame times of the same run. The
+ * golden images are named after the pose and the size of the surface, e.g.
+ * cube-front-256x256.png, so only runs of the same size are compared.
+ */
+class GoldenImageCheck
+{
+public:
+	enum class Mode
+	{
+		Compare,
+		Update
+	};
+
+	/**
+	 * @param channelTolerance A pixel differs if any of its R, G and B differs by more than this.
+	 * @param maxDifferingPercent The check fails if more than this percentage of the pixels differ.
+	 * @param framesPerPose Timed frames rendered after the captured one.
+	 */
+	GoldenImageCheck(std::string directory, Mode mode, unsigned channelTolerance, float maxDifferingPercent,
+			unsigned framesPerPose);
+
+	unsigned getTimedFrameCount() const;
+
+	/** Advance to the next frame and return the pose to render. */
+	const GoldenPose& beginFrame();
+
+	/** Whether the current frame is to be captured (and not timed). */
+	bool isCaptureFrame() const;
+
+	/**
+	 * Read back the current frame with glReadPixels and compare it with the golden image or write it.
+	 * Throws std::runtime_error if a file can't be read or written.
+	 */
+	void capture(int width, int height);
+
+	/** All the poses are captured. */
+	bool isFinished() const;
+
+	/** No pose differs from its golden image (or the images were written). */
+	bool hasPassed() const;
+
+	/** Write the result of each pose. */
+	void report(std::ostream& os) const;
+
+	// disallow copy and move
+	GoldenImageCheck& operator=(GoldenImageCheck&&) = delete;
+	GoldenImageCheck(GoldenImageCheck&&) = delete;
+	GoldenImageCheck& operator=(const GoldenImageCheck&) = delete;
+	GoldenImageCheck(const GoldenImageCheck&) = delete;
+
+private:
+	struct Result
+	{
+		const GoldenPose* pose;
+		std::string fileName;
+		bool written; // in the Update mode
+		bool missing; // no golden image to compare with
+		bool passed;
+		size_t differingPixels;
+		double differingPercent;
+		unsigned maxDifference;
+		double meanDifference;
+	};
+
+	Result compare(const GoldenPose& pose, const std::string& fileName, const Image& image, const Image& golden) const;
+
+	std::string m_directory;
+	Mode m_mode;
+	unsigned m_channelTolerance;
+	float m_maxDifferingPercent;
+	unsigned m_framesPerPose;
+
+	// index of the current frame, -1 before the first one
+	long m_frame;
+	std::vector<Result> m_results;
+};
+
+#endif // GOLDEN_IMAGE_CHECK_H
@@ -0,0 +1,135 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "HeadlessWindow.h"
+#include "Exceptions.h"
+#include "Trace.h"
+
+#include <utility>
+#include <iostream>
+#include <GLES2/gl2.h>
+
+HeadlessWindow::HeadlessWindow(int width, int height, std::shared_ptr<MirNativeWindowRenderer> renderer):
+	m_width(width),
+	m_height(height),
+	m_eglDisplay(EGL_NO_DISPLAY),
+	m_eglSurface(EGL_NO_SURFACE),
+	m_eglContext(EGL_NO_CONTEXT),
+	m_renderer(std::move(renderer))
+{
+	TRACE_SCOPE("HeadlessWindow setup");
+
+	m_eglDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+	if (m_eglDisplay == EGL_NO_DISPLAY)
+		throw EGLError("Can't get the default EGL display!");
+
+	EGLint major = 0, minor = 0;
+	if (eglInitialize(m_eglDisplay, &major, &minor) != EGL_TRUE)
+		throw EGLError("Can't initialize EGL!");
+
+	std::cout << "Initialized EGL " << major << "." << minor << " (headless, " << width << "x" << height << ")" << std::endl;
+
+	try
+	{
+		createContext();
+	}
+	catch (...)
+	{
+		// the destructor doesn't run; terminating the display releases whatever was created
+		eglTerminate(m_eglDisplay);
+		throw;
+	}
+}
+
+void HeadlessWindow::createContext()
+{
+	const EGLint attribList[] =
+	{
+		EGL_RED_SIZE, 8,
+		EGL_GREEN_SIZE, 8,
+		EGL_BLUE_SIZE, 8,
+		EGL_ALPHA_SIZE, 0,
+		EGL_DEPTH_SIZE, 16,
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT,
+		EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+		EGL_NONE
+	};
+	EGLConfig eglConfig;
+	EGLint numConfigs = 0;
+	eglChooseConfig(m_eglDisplay, attribList, &eglConfig, 1, &numConfigs);
+	if (numConfigs != 1)
+		throw EGLError("No suitable EGL config found!");
+
+	const EGLint surfaceAttribList[] =
+	{
+		EGL_WIDTH, m_width,
+		EGL_HEIGHT, m_height,
+		EGL_NONE
+	};
+	m_eglSurface = eglCreatePbufferSurface(m_eglDisplay, eglConfig, surfaceAttribList);
+	if (m_eglSurface == EGL_NO_SURFACE)
+		throw EGLError("Can't create EGL pbuffer surface!");
+
+	if (eglBindAPI(EGL_OPENGL_ES_API) != EGL_TRUE)
+		throw EGLError("Can't bind OpenGL ES API!");
+
+	const EGLint contextAttribList[] = {
+		EGL_CONTEXT_CLIENT_VERSION, 2,
+		EGL_NONE
+	};
+	m_eglContext = eglCreateContext(m_eglDisplay, eglConfig, EGL_NO_CONTEXT, contextAttribList);
+	if (m_eglContext == EGL_NO_CONTEXT)
+		throw EGLError("Can't create EGL context!");
+
+	if (eglMakeCurrent(m_eglDisplay, m_eglSurface, m_eglSurface, m_eglContext) != EGL_TRUE)
+		throw EGLError("Can't make context current!");
+}
+
+HeadlessWindow::~HeadlessWindow()
+{
+	eglMakeCurrent(m_eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+	eglTerminate(m_eglDisplay);
+}
+
+void HeadlessWindow::run()
+{
+	m_renderer->run(*this);
+}
+
+int HeadlessWindow::getWidth()
+{
+	return m_width;
+}
+
+int HeadlessWindow::getHeight()
+{
+	return m_height;
+}
+
+void HeadlessWindow::swapBuffers()
+{
+	TRACE_SCOPE("eglSwapBuffers");
+
+	// swapping a pbuffer does nothing; wait for the frame instead so that frames don't pile up in the driver
+	glFinish();
+}
+
+void HeadlessWindow::setSwapInterval(int)
+{
+	// a pbuffer isn't synchronized to any display
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef HEADLESS_WINDOW_H
+#define HEADLESS_WINDOW_H
+
+#include <EGL/egl.h>
+
+#include <memory>
+
+#include "MirNativeWindowControl.h"
+#include "MirNativeWindowRenderer.h"
+
+/**
+ * Runs a renderer on an off-screen EGL pbuffer surface of the default EGL
+ * display, without a Mir connection. There is no input, so it is meant for
+ * replayed input and benchmarks.
+ */
+class HeadlessWindow: private MirNativeWindowControl
+{
+public:
+	HeadlessWindow(int width, int height, std::shared_ptr<MirNativeWindowRenderer> renderer);
+	~HeadlessWindow();
+
+	// disallow copy and move
+	HeadlessWindow(const HeadlessWindow&) = delete;
+	HeadlessWindow& operator=(const HeadlessWindow&) = delete;
+
+	void run();
+
+private:
+	virtual int getWidth() override;
+	virtual int getHeight() override;
+	virtual void swapBuffers() override;
+	virtual void setSwapInterval(int interval) override;
+
+	/** Create the pbuffer surface and the context on the initialized display and make them current. */
+	void createContext();
+
+	int m_width;
+	int m_height;
+	EGLDisplay m_eglDisplay;
+	EGLSurface m_eglSurface;
+	EGLContext m_eglContext;
+
+	std::shared_ptr<MirNativeWindowRenderer> m_renderer;
+};
+
+#endif // HEADLESS_WINDOW_H
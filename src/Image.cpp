@@ -18,10 +18,19 @@
  */
 #include "Image.h"
 
-Image::Image(unsigned width, unsigned height, std::unique_ptr<unsigned char[]> data):
+Image::Image(unsigned width, unsigned height, std::unique_ptr<unsigned char[]> data, const std::string& name):
 	m_width(width),
 	m_height(height),
-	m_data(std::move(data))
+	m_data(data.get()),
+	m_storage(data.release(), std::default_delete<unsigned char[]>()),
+	m_memory(MemoryCategory::Image, name, getSize())
+{}
+
+Image::Image(unsigned width, unsigned height, unsigned char* data, std::shared_ptr<void> storage):
+	m_width(width),
+	m_height(height),
+	m_data(data),
+	m_storage(std::move(storage))
 {}
 
 unsigned Image::getWidth() const
@@ -36,5 +45,11 @@ unsigned Image::getHeight() const
 
 unsigned char* Image::getData() const
 {
-	return m_data.get();
+	return m_data;
+}
+
+size_t Image::getSize() const
+{
+	// always RGBA, 8 bits per channel
+	return static_cast<size_t>(m_width) * m_height * 4;
 }
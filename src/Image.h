@@ -19,21 +19,44 @@
 #ifndef IMAGE_H
 #define IMAGE_H
 
+#include "MemoryTracker.h"
+
 #include <memory>
+#include <string>
+#include <cstddef>
 
 class Image
 {
 public:
-	Image(unsigned width, unsigned height, std::unique_ptr<unsigned char[]> data);
+	/**
+	 * Create an image owning its pixel data. The data is accounted as MemoryCategory::Image under the given name.
+	 */
+	Image(unsigned width, unsigned height, std::unique_ptr<unsigned char[]> data, const std::string& name = std::string());
+
+	/**
+	 * Create an image from pixel data owned by something else, e.g. a mapped file.
+	 * The storage is kept alive as long as the image lives. It's not accounted in the MemoryTracker.
+	 */
+	Image(unsigned width, unsigned height, unsigned char* data, std::shared_ptr<void> storage);
+
 	unsigned getWidth() const;
 	unsigned getHeight() const;
 	unsigned char* getData() const;
+	size_t getSize() const;
 	// TODO: format
 
+	// allow move, disallow copy
+	Image& operator=(Image&&) = default;
+	Image(Image&&) = default;
+	Image& operator=(const Image&) = delete;
+	Image(const Image&) = delete;
+
 private:
 	unsigned m_width;
 	unsigned m_height;
-	std::unique_ptr<unsigned char[]> m_data;
+	unsigned char* m_data;
+	std::shared_ptr<void> m_storage;
+	TrackedMemory m_memory;
 };
 
 #endif // IMAGE_H
@@ -0,0 +1,54 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "InputBatch.h"
+
+void InputBatch::add(const InputSample& sample)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	m_pending.samples.push_back(sample);
+
+	if (sample.action == InputSample::Action::Move)
+	{
+		// merge with the pointer's previous sample if that's a move too
+		for (auto it = m_pending.coalesced.rbegin(); it != m_pending.coalesced.rend(); ++it)
+		{
+			if (it->pointerId == sample.pointerId)
+			{
+				if (it->action == InputSample::Action::Move)
+				{
+					*it = sample;
+					return;
+				}
+				break;
+			}
+		}
+	}
+
+	m_pending.coalesced.push_back(sample);
+}
+
+void InputBatch::take(InputFrame& frame)
+{
+	frame.clear();
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	std::swap(frame.samples, m_pending.samples);
+	std::swap(frame.coalesced, m_pending.coalesced);
+}
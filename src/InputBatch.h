@@ -0,0 +1,105 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef INPUT_BATCH_H
+#define INPUT_BATCH_H
+
+#include <vector>
+#include <mutex>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * A single pointer sample (touch or mouse).
+ */
+struct InputSample
+{
+	enum class Action
+	{
+		Down,
+		Move,
+		Up
+	};
+
+	/** Pointer id of the mouse; touch ids are non-negative. */
+	static const int32_t MOUSE_POINTER_ID = -1;
+
+	Action action;
+	int32_t pointerId;
+	float x;
+	float y;
+	int64_t eventTime; // ns, as returned by mir_input_event_get_event_time
+};
+
+/**
+ * Input samples received since the last frame.
+ */
+struct InputFrame
+{
+	/** Capacity reserved up front, so that typical frames don't allocate. */
+	static const size_t INITIAL_CAPACITY = 256;
+
+	InputFrame()
+	{
+		samples.reserve(INITIAL_CAPACITY);
+		coalesced.reserve(INITIAL_CAPACITY);
+	}
+
+	/** All the samples, in the order they arrived. For gesture recognizers. */
+	std::vector<InputSample> samples;
+
+	/** The same samples with consecutive moves of each pointer merged into the last one. */
+	std::vector<InputSample> coalesced;
+
+	void clear()
+	{
+		samples.clear();
+		coalesced.clear();
+	}
+};
+
+/**
+ * Accumulates input samples between frames.
+ *
+ * The event thread adds samples as they arrive, the render thread takes all of
+ * them once at the start of a frame. This way the per-frame input processing
+ * cost doesn't depend on the report rate of the input device.
+ */
+class InputBatch
+{
+public:
+	InputBatch() = default;
+
+	// disallow copy and move
+	InputBatch(const InputBatch&) = delete;
+	InputBatch& operator=(const InputBatch&) = delete;
+
+	void add(const InputSample& sample);
+
+	/**
+	 * Move the accumulated samples to frame (replacing its content). The vectors
+	 * are swapped so that their storage gets reused.
+	 */
+	void take(InputFrame& frame);
+
+private:
+	std::mutex m_mutex;
+	InputFrame m_pending;
+};
+
+#endif // INPUT_BATCH_H
@@ -0,0 +1,243 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "InputTrace.h"
+#include "MappedFile.h"
+#include "Log.h"
+
+#include <stdexcept>
+#include <cstring>
+#include <cmath>
+
+namespace
+{
+	const char MAGIC[6] = { 'M', 'G', 'D', 'I', 'N', 'P' };
+	const uint16_t VERSION = 1;
+	const size_t HEADER_SIZE = sizeof(MAGIC) + sizeof(VERSION);
+
+	// event type in the high nibble of the first byte, action in the low one
+	const unsigned char EVENT_POINTER = 0x10;
+	const unsigned char EVENT_KEY = 0x20;
+
+	// enough for the largest event
+	const size_t MAX_EVENT_SIZE = 1 + 4 * 10;
+
+	uint64_t zigzag(int64_t value)
+	{
+		return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+	}
+
+	int64_t unzigzag(uint64_t value)
+	{
+		return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+	}
+
+	unsigned char* putVarint(unsigned char* out, uint64_t value)
+	{
+		while (value >= 0x80)
+		{
+			*out++ = static_cast<unsigned char>(value | 0x80);
+			value >>= 7;
+		}
+		*out++ = static_cast<unsigned char>(value);
+		return out;
+	}
+
+	/**
+	 * @return False if the data ends in the middle of the varint.
+	 */
+	bool getVarint(const unsigned char*& in, const unsigned char* end, uint64_t& value)
+	{
+		value = 0;
+		for (unsigned shift = 0; in != end && shift < 64; shift += 7)
+		{
+			const unsigned char byte = *in++;
+			value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+			if (!(byte & 0x80))
+				return true;
+		}
+		return false;
+	}
+
+	uint32_t floatBits(float value)
+	{
+		uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		return bits;
+	}
+
+	float bitsFloat(uint32_t bits)
+	{
+		float value;
+		std::memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+}
+
+InputRecorder::InputRecorder(const std::string& fileName):
+	m_file(std::fopen(fileName.c_str(), "wb"), fclose),
+	m_fileName(fileName),
+	m_lastTime(0)
+{
+	if (!m_file)
+		throw std::runtime_error("InputRecorder: can't create " + fileName);
+
+	unsigned char header[HEADER_SIZE];
+	std::memcpy(header, MAGIC, sizeof(MAGIC));
+	std::memcpy(header + sizeof(MAGIC), &VERSION, sizeof(VERSION));
+	writeEvent(header, sizeof(header), true);
+}
+
+void InputRecorder::addSample(const InputSample& sample)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	unsigned char buffer[MAX_EVENT_SIZE];
+	unsigned char* out = buffer;
+	*out++ = EVENT_POINTER | static_cast<unsigned char>(sample.action);
+	out = putVarint(out, zigzag(sample.eventTime - m_lastTime));
+	out = putVarint(out, zigzag(sample.pointerId));
+	out = putVarint(out, floatBits(sample.x));
+	out = putVarint(out, floatBits(sample.y));
+	m_lastTime = sample.eventTime;
+
+	// flush at the end of each gesture so that a killed process loses little
+	writeEvent(buffer, out - buffer, sample.action == InputSample::Action::Up);
+}
+
+void InputRecorder::addKey(const KeySample& key)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	unsigned char buffer[MAX_EVENT_SIZE];
+	unsigned char* out = buffer;
+	*out++ = EVENT_KEY | static_cast<unsigned char>(key.action & 0x0f);
+	out = putVarint(out, zigzag(key.eventTime - m_lastTime));
+	out = putVarint(out, zigzag(key.scanCode));
+	out = putVarint(out, key.keySym);
+	m_lastTime = key.eventTime;
+
+	writeEvent(buffer, out - buffer, true);
+}
+
+void InputRecorder::writeEvent(const unsigned char* data, size_t size, bool flush)
+{
+	if (std::fwrite(data, 1, size, m_file.get()) != size || (flush && std::fflush(m_file.get()) != 0))
+		throw std::runtime_error("InputRecorder: can't write to " + m_fileName);
+}
+
+InputReplayer::InputReplayer(const std::string& fileName, double speed, int64_t step):
+	m_next(0),
+	m_speed(speed),
+	m_step(step),
+	m_started(false),
+	m_replayStart(0),
+	m_traceStart(0),
+	m_traceTime(0)
+{
+	if (!(speed > 0))
+		throw std::runtime_error("InputReplayer: the speed must be positive");
+
+	MappedFile file(fileName);
+	const unsigned char* in = file.getData();
+	const unsigned char* end = in + file.getSize();
+
+	uint16_t version = 0;
+	if (file.getSize() >= HEADER_SIZE)
+		std::memcpy(&version, in + sizeof(MAGIC), sizeof(version));
+	if (file.getSize() < HEADER_SIZE || std::memcmp(in, MAGIC, sizeof(MAGIC)) != 0 || version != VERSION)
+		throw std::runtime_error("InputReplayer: " + fileName + " is not an input trace");
+	in += HEADER_SIZE;
+
+	int64_t time = 0;
+	while (in != end)
+	{
+		const unsigned char type = *in & 0xf0;
+		const unsigned char action = *in & 0x0f;
+		in++;
+
+		Event event;
+		uint64_t delta, a, b, c;
+		if (type == EVENT_POINTER
+				&& action <= static_cast<unsigned char>(InputSample::Action::Up)
+				&& getVarint(in, end, delta) && getVarint(in, end, a) && getVarint(in, end, b) && getVarint(in, end, c))
+		{
+			time += unzigzag(delta);
+			event.isKey = false;
+			event.sample = InputSample{static_cast<InputSample::Action>(action), static_cast<int32_t>(unzigzag(a)),
+					bitsFloat(static_cast<uint32_t>(b)), bitsFloat(static_cast<uint32_t>(c)), time};
+		}
+		else if (type == EVENT_KEY && getVarint(in, end, delta) && getVarint(in, end, a) && getVarint(in, end, b))
+		{
+			time += unzigzag(delta);
+			event.isKey = true;
+			event.key = KeySample{action, static_cast<int32_t>(unzigzag(a)), static_cast<uint32_t>(b), time};
+		}
+		else
+		{
+			// most likely the recording was killed in the middle of an event
+			LOG_WARNING("InputReplayer: " << fileName << " is truncated or corrupt, replaying " << m_events.size() << " events");
+			break;
+		}
+
+		m_events.push_back(event);
+	}
+}
+
+void InputReplayer::replay(int64_t now, Listener& listener)
+{
+	if (isFinished())
+		return;
+
+	if (!m_started)
+	{
+		m_started = true;
+		m_replayStart = now;
+		m_traceStart = m_events[0].isKey ? m_events[0].key.eventTime : m_events[0].sample.eventTime;
+		m_traceTime = m_traceStart;
+	}
+	else if (m_step != 0)
+		m_traceTime += static_cast<int64_t>(std::llround(m_step * m_speed));
+	else
+		m_traceTime = m_traceStart + static_cast<int64_t>(std::llround((now - m_replayStart) * m_speed));
+
+	for (; m_next < m_events.size(); m_next++)
+	{
+		Event event = m_events[m_next];
+		int64_t& eventTime = event.isKey ? event.key.eventTime : event.sample.eventTime;
+		if (eventTime > m_traceTime)
+			break;
+
+		eventTime = toReplayTime(eventTime);
+
+		if (event.isKey)
+			listener.onReplayedKey(event.key);
+		else
+			listener.onReplayedSample(event.sample);
+	}
+}
+
+int64_t InputReplayer::getTime() const
+{
+	return toReplayTime(m_traceTime);
+}
+
+int64_t InputReplayer::toReplayTime(int64_t traceTime) const
+{
+	return m_replayStart + static_cast<int64_t>(std::llround((traceTime - m_traceStart) / m_speed));
+}
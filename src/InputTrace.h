@@ -0,0 +1,148 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef INPUT_TRACE_H
+#define INPUT_TRACE_H
+
+#include "InputBatch.h"
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <cstdio>
+#include <cstdint>
+
+/**
+ * A decoded keyboard event.
+ */
+struct KeySample
+{
+	int32_t action; // MirKeyboardAction
+	int32_t scanCode;
+	uint32_t keySym;
+	int64_t eventTime; // ns
+};
+
+/**
+ * Writes the decoded input stream into a compact binary trace file.
+ *
+ * The file starts with a 8 byte header ("MGDINP", 16 bit version). Each
+ * event is a byte with the event type and action followed by varints
+ * (zigzag encoded where the value can be negative): the time since the
+ * previous event, the pointer id and the raw bits of the x and y floats for
+ * pointer samples; the scan code and the key symbol for keys. Replaying a
+ * trace reproduces the exact same values.
+ *
+ * Thread safe.
+ */
+class InputRecorder
+{
+public:
+	explicit InputRecorder(const std::string& fileName);
+
+	// disallow copy and move
+	InputRecorder(const InputRecorder&) = delete;
+	InputRecorder& operator=(const InputRecorder&) = delete;
+
+	void addSample(const InputSample& sample);
+	void addKey(const KeySample& key);
+
+private:
+	void writeEvent(const unsigned char* data, size_t size, bool flush);
+
+	std::mutex m_mutex;
+	std::unique_ptr<FILE, decltype(&fclose)> m_file;
+	std::string m_fileName;
+	int64_t m_lastTime;
+};
+
+/**
+ * Plays back a trace written by InputRecorder.
+ *
+ * The trace time advances either with the wall clock (scaled by the speed) or
+ * by a fixed step on each replay() call (i.e. each frame), which makes the
+ * assignment of events to frames independent of timing. The timestamps of the
+ * replayed events are shifted (and scaled by the speed) to the replay clock.
+ * When stepping, the replay clock advances by the step on each replay() call
+ * and the timestamps aren't related to the wall clock (nor to latency).
+ */
+class InputReplayer
+{
+public:
+	struct Listener
+	{
+		virtual void onReplayedSample(const InputSample& sample) = 0;
+		virtual void onReplayedKey(const KeySample& key) = 0;
+	};
+
+	/**
+	 * @param speed Playback speed, 1 is the original pace.
+	 * @param step If nonzero, advance the trace by this many ns (times speed) on each replay() call.
+	 */
+	InputReplayer(const std::string& fileName, double speed, int64_t step);
+
+	/**
+	 * Deliver the events that are due at time now (in the time base of the event timestamps).
+	 */
+	void replay(int64_t now, Listener& listener);
+
+	bool isFinished() const
+	{
+		return m_next == m_events.size();
+	}
+
+	size_t getEventCount() const
+	{
+		return m_events.size();
+	}
+
+	/** The step per replay() call in ns, 0 if the replay follows the wall clock. */
+	int64_t getStep() const
+	{
+		return m_step;
+	}
+
+	/**
+	 * Time of the last replay() call on the replay clock (the time base of the replayed events).
+	 */
+	int64_t getTime() const;
+
+private:
+	struct Event
+	{
+		bool isKey;
+		InputSample sample;
+		KeySample key;
+	};
+
+	int64_t toReplayTime(int64_t traceTime) const;
+
+	std::vector<Event> m_events;
+	size_t m_next;
+
+	double m_speed;
+	int64_t m_step;
+
+	bool m_started;
+	int64_t m_replayStart;
+	int64_t m_traceStart;
+	int64_t m_traceTime;
+};
+
+#endif // INPUT_TRACE_H
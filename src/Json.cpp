@@ -0,0 +1,34 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "Json.h"
+
+void writeJsonString(FILE* file, const std::string& s)
+{
+	std::fputc('"', file);
+	for (char c: s)
+	{
+		if (c == '"' || c == '\\')
+			std::fputc('\\', file);
+		if (static_cast<unsigned char>(c) < 0x20)
+			std::fprintf(file, "\\u%04x", c);
+		else
+			std::fputc(c, file);
+	}
+	std::fputc('"', file);
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "LatencyHistogram.h"
+
+#include <algorithm>
+#include <limits>
+
+LatencyHistogram::LatencyHistogram(std::string name):
+	m_name(std::move(name))
+{
+	reset();
+}
+
+void LatencyHistogram::add(int64_t latency)
+{
+	latency = std::max<int64_t>(latency, 0);
+
+	const size_t bucket = std::min<int64_t>(latency / BUCKET_WIDTH, BUCKET_COUNT);
+	m_buckets[bucket]++;
+
+	m_count++;
+	m_sum += latency;
+	m_min = std::min(m_min, latency);
+	m_max = std::max(m_max, latency);
+}
+
+int64_t LatencyHistogram::getPercentile(double fraction) const
+{
+	if (m_count == 0)
+		return 0;
+
+	const uint64_t target = std::max<uint64_t>(1, static_cast<uint64_t>(fraction * m_count + 0.5));
+	uint64_t count = 0;
+	for (size_t i = 0; i < BUCKET_COUNT; i++)
+	{
+		count += m_buckets[i];
+		if (count >= target)
+			return std::min(static_cast<int64_t>(i + 1) * BUCKET_WIDTH, m_max);
+	}
+
+	return m_max;
+}
+
+void LatencyHistogram::reset()
+{
+	m_buckets.fill(0);
+	m_count = 0;
+	m_sum = 0;
+	m_min = std::numeric_limits<int64_t>::max();
+	m_max = 0;
+}
+
+void LatencyHistogram::report(std::ostream& os) const
+{
+	os << m_name << ": ";
+	if (m_count == 0)
+	{
+		os << "no samples" << std::endl;
+		return;
+	}
+
+	const double MS = 1e6;
+	os << m_count << " samples, min " << m_min / MS << " ms, mean " << m_sum / m_count / MS
+	   << " ms, p50 " << getPercentile(0.5) / MS << " ms, p90 " << getPercentile(0.9) / MS
+	   << " ms, p99 " << getPercentile(0.99) / MS << " ms, max " << m_max / MS << " ms" << std::endl;
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <array>
+#include <string>
+#include <ostream>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Histogram of latencies with 1 ms buckets up to 100 ms (and one bucket for
+ * anything longer). Allocates nothing, so that it can be fed every frame.
+ */
+class LatencyHistogram
+{
+public:
+	static const size_t BUCKET_COUNT = 100;
+	static const int64_t BUCKET_WIDTH = 1000000; // ns
+
+	explicit LatencyHistogram(std::string name);
+
+	/** Add a latency in ns. Negative values (clock mismatch) are counted as 0. */
+	void add(int64_t latency);
+
+	uint64_t getCount() const
+	{
+		return m_count;
+	}
+
+	/**
+	 * Latency (in ns) below which the given fraction (0-1) of the samples is,
+	 * at bucket resolution.
+	 */
+	int64_t getPercentile(double fraction) const;
+
+	void reset();
+	void report(std::ostream& os) const;
+
+private:
+	std::string m_name;
+	std::array<uint64_t, BUCKET_COUNT + 1> m_buckets; // the last one collects the overflow
+	uint64_t m_count;
+	int64_t m_sum;
+	int64_t m_min;
+	int64_t m_max;
+};
+
+#endif // LATENCY_HISTOGRAM_H
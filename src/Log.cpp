@@ -0,0 +1,230 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "Log.h"
+
+#include <cstdio>
+
+namespace
+{
+
+/** How often the writer thread looks for new messages. Producers don't wake it up to stay lock-free. */
+const std::chrono::milliseconds POLL_INTERVAL(10);
+
+/** streambuf writing into a fixed size buffer; output past the end fails (and so is truncated). */
+class SlotBuffer: public std::streambuf
+{
+public:
+	void reset(char* begin, char* end)
+	{
+		setp(begin, end);
+	}
+
+	size_t getLength() const
+	{
+		return pptr() - pbase();
+	}
+};
+
+/** The formatting stream is reused by all the messages of a thread. */
+struct ThreadStream
+{
+	ThreadStream():
+		stream(&buffer)
+	{
+	}
+
+	SlotBuffer buffer;
+	std::ostream stream;
+};
+
+thread_local ThreadStream threadStream;
+
+char getLevelChar(LogLevel level)
+{
+	switch (level)
+	{
+	case LogLevel::Debug:
+		return 'D';
+	case LogLevel::Info:
+		return 'I';
+	case LogLevel::Warning:
+		return 'W';
+	case LogLevel::Error:
+		return 'E';
+	}
+
+	return '?';
+}
+
+}
+
+Logger& Logger::get()
+{
+	static Logger logger;
+	return logger;
+}
+
+Logger::Logger():
+	m_slots(new Slot[CAPACITY]),
+	m_enqueuePosition(0),
+	m_dequeuePosition(0),
+	m_droppedCount(0),
+	m_reportedDroppedCount(0),
+	m_startTime(std::chrono::steady_clock::now()),
+	m_stop(false),
+	m_writtenPosition(0)
+{
+	for (size_t i = 0; i < CAPACITY; i++)
+		m_slots[i].sequence.store(i, std::memory_order_relaxed);
+
+	m_thread = std::thread(&Logger::run, this);
+}
+
+Logger::~Logger()
+{
+	m_stop.store(true);
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_wakeUp.notify_one();
+	}
+	m_thread.join();
+}
+
+void Logger::flush()
+{
+	const size_t target = m_enqueuePosition.load();
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_wakeUp.notify_one();
+	m_flushed.wait(lock, [this, target] { return m_writtenPosition.load() >= target; });
+}
+
+Logger::Slot* Logger::acquire(LogLevel level)
+{
+	// bounded multi-producer queue: a slot is free for position p when its sequence equals p
+	size_t position = m_enqueuePosition.load(std::memory_order_relaxed);
+	for (;;)
+	{
+		Slot* slot = &m_slots[position & (CAPACITY - 1)];
+		const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+		const ptrdiff_t diff = static_cast<ptrdiff_t>(sequence) - static_cast<ptrdiff_t>(position);
+
+		if (diff == 0)
+		{
+			if (m_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+			{
+				slot->level = level;
+				slot->time = std::chrono::steady_clock::now();
+				return slot;
+			}
+		}
+		else if (diff < 0)
+		{
+			// the writer didn't get to this slot yet: full
+			m_droppedCount.fetch_add(1, std::memory_order_relaxed);
+			return nullptr;
+		}
+		else
+			position = m_enqueuePosition.load(std::memory_order_relaxed);
+	}
+}
+
+void Logger::publish(Slot* slot, size_t length)
+{
+	slot->length = length;
+	// the slot was claimed at position sequence, mark it as filled
+	slot->sequence.store(slot->sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+bool Logger::writeOne()
+{
+	Slot& slot = m_slots[m_dequeuePosition & (CAPACITY - 1)];
+	if (slot.sequence.load(std::memory_order_acquire) != m_dequeuePosition + 1)
+		return false;
+
+	const double seconds = std::chrono::duration<double>(slot.time - m_startTime).count();
+	FILE* out = slot.level >= LogLevel::Warning ? stderr : stdout;
+	std::fprintf(out, "[%10.3f] %c %.*s\n", seconds, getLevelChar(slot.level), static_cast<int>(slot.length), slot.text);
+
+	// hand the slot back to the producers for the next round
+	slot.sequence.store(m_dequeuePosition + CAPACITY, std::memory_order_release);
+	m_dequeuePosition++;
+	return true;
+}
+
+void Logger::run()
+{
+	for (;;)
+	{
+		bool wrote = false;
+		while (writeOne())
+			wrote = true;
+
+		const uint64_t droppedCount = m_droppedCount.load(std::memory_order_relaxed);
+		if (droppedCount != m_reportedDroppedCount)
+		{
+			std::fprintf(stderr, "Logger: %llu messages dropped\n",
+					static_cast<unsigned long long>(droppedCount - m_reportedDroppedCount));
+			m_reportedDroppedCount = droppedCount;
+			wrote = true;
+		}
+
+		if (wrote)
+		{
+			std::fflush(stdout);
+			std::fflush(stderr);
+		}
+
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_writtenPosition.store(m_dequeuePosition);
+		m_flushed.notify_all();
+
+		// stop only when everything published before the stop request is written
+		if (m_stop.load() && m_dequeuePosition == m_enqueuePosition.load())
+			break;
+
+		m_wakeUp.wait_for(lock, POLL_INTERVAL);
+	}
+}
+
+Logger::Record::Record(LogLevel level):
+	m_slot(Logger::get().acquire(level)),
+	m_stream(nullptr)
+{
+	if (m_slot)
+	{
+		ThreadStream& ts = threadStream;
+		ts.buffer.reset(m_slot->text, m_slot->text + MESSAGE_SIZE);
+		ts.stream.clear();
+		ts.stream.flags(std::ios_base::dec | std::ios_base::skipws);
+		ts.stream.precision(6);
+		m_stream = &ts.stream;
+	}
+}
+
+Logger::Record::~Record()
+{
+	if (m_slot)
+		Logger::get().publish(m_slot, threadStream.buffer.getLength());
+}
+
+std::ostream& Logger::Record::stream()
+{
+	return *m_stream;
+}
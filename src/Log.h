@@ -0,0 +1,166 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LOG_H
+#define LOG_H
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <ostream>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+enum class LogLevel
+{
+	Debug,
+	Info,
+	Warning,
+	Error
+};
+
+/**
+ * Messages below this level are compiled out. Can be overridden with -DLOG_MIN_LEVEL=...
+ */
+#ifndef LOG_MIN_LEVEL
+#ifdef NDEBUG
+#define LOG_MIN_LEVEL LogLevel::Info
+#else
+#define LOG_MIN_LEVEL LogLevel::Debug
+#endif
+#endif
+
+/**
+ * Asynchronous logger.
+ *
+ * Messages are formatted directly into a fixed size slot of a bounded lock-free
+ * ring buffer and written out by a background thread, so logging never blocks on
+ * the console. When the ring is full, the message is dropped and counted.
+ *
+ * Use through the LOG_* macros:
+ *
+ *     LOG_DEBUG("onPointerMove " << x << "," << y);
+ */
+class Logger
+{
+public:
+	/** Longest message, longer ones are truncated. */
+	static const size_t MESSAGE_SIZE = 232;
+
+	class Record;
+
+	static Logger& get();
+
+	~Logger();
+
+	// disallow copy and move
+	Logger(const Logger&) = delete;
+	Logger& operator=(const Logger&) = delete;
+
+	/** Wait until all the messages logged so far are written out. */
+	void flush();
+
+	uint64_t getDroppedCount() const
+	{
+		return m_droppedCount.load(std::memory_order_relaxed);
+	}
+
+private:
+	struct Slot
+	{
+		std::atomic<size_t> sequence;
+		LogLevel level;
+		std::chrono::steady_clock::time_point time;
+		size_t length;
+		char text[MESSAGE_SIZE];
+	};
+
+	Logger();
+
+	Slot* acquire(LogLevel level);
+	void publish(Slot* slot, size_t length);
+
+	bool writeOne();
+	void run();
+
+	static const size_t CAPACITY = 1024; // power of two
+
+	std::unique_ptr<Slot[]> m_slots;
+	std::atomic<size_t> m_enqueuePosition;
+	size_t m_dequeuePosition; // only touched by the writer thread
+	std::atomic<uint64_t> m_droppedCount;
+	uint64_t m_reportedDroppedCount;
+	const std::chrono::steady_clock::time_point m_startTime;
+
+	// only used to wake up the writer, producers never wait on it
+	std::mutex m_mutex;
+	std::condition_variable m_wakeUp;
+	std::condition_variable m_flushed;
+	std::atomic<bool> m_stop;
+	std::atomic<size_t> m_writtenPosition;
+
+	std::thread m_thread;
+};
+
+/**
+ * A message being formatted. Claims a slot in the constructor and publishes it
+ * in the destructor.
+ */
+class Logger::Record
+{
+public:
+	explicit Record(LogLevel level);
+	~Record();
+
+	// disallow copy and move
+	Record(const Record&) = delete;
+	Record& operator=(const Record&) = delete;
+
+	/** False if the ring buffer is full and the message is dropped. */
+	explicit operator bool() const
+	{
+		return m_slot != nullptr;
+	}
+
+	std::ostream& stream();
+
+private:
+	Slot* m_slot;
+	std::ostream* m_stream;
+};
+
+#define LOG_AT(level, message) \
+	do \
+	{ \
+		if ((level) >= (LOG_MIN_LEVEL)) \
+		{ \
+			Logger::Record logRecord_(level); \
+			if (logRecord_) \
+				logRecord_.stream() << message; \
+		} \
+	} while (false)
+
+#define LOG_DEBUG(message) LOG_AT(LogLevel::Debug, message)
+#define LOG_INFO(message) LOG_AT(LogLevel::Info, message)
+#define LOG_WARNING(message) LOG_AT(LogLevel::Warning, message)
+#define LOG_ERROR(message) LOG_AT(LogLevel::Error, message)
+
+#endif // LOG_H
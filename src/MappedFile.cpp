@@ -0,0 +1,71 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "MappedFile.h"
+
+#include <stdexcept>
+#include <cstring>
+#include <cerrno>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+MappedFile::MappedFile(const std::string& fileName):
+	m_data(nullptr),
+	m_size(0),
+	m_modificationTime(0)
+{
+	const int fd = open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		throw std::runtime_error(std::string("Can't open file ") + fileName + ": " + std::strerror(errno));
+
+	struct stat st;
+	if (fstat(fd, &st) != 0)
+	{
+		const int e = errno;
+		close(fd);
+		throw std::runtime_error(std::string("Can't stat file ") + fileName + ": " + std::strerror(e));
+	}
+
+	m_size = st.st_size;
+	m_modificationTime = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+	if (m_size == 0)
+	{
+		// mmap() refuses empty mappings, an empty file is simply no data
+		close(fd);
+		return;
+	}
+
+	void* p = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	const int e = errno;
+	// the mapping stays valid after the descriptor is closed
+	close(fd);
+
+	if (p == MAP_FAILED)
+		throw std::runtime_error(std::string("Can't map file ") + fileName + ": " + std::strerror(e));
+
+	m_data = static_cast<unsigned char*>(p);
+}
+
+MappedFile::~MappedFile()
+{
+	if (m_data)
+		munmap(m_data, m_size);
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * A whole file mapped into memory.
+ *
+ * The mapping is private: the data can be modified in place, but the
+ * changes are never written back to the file.
+ */
+class MappedFile
+{
+public:
+	explicit MappedFile(const std::string& fileName);
+	~MappedFile();
+
+	unsigned char* getData() const
+	{
+		return m_data;
+	}
+
+	size_t getSize() const
+	{
+		return m_size;
+	}
+
+	/**
+	 * Modification time of the file at the time it was mapped, in nanoseconds.
+	 */
+	int64_t getModificationTime() const
+	{
+		return m_modificationTime;
+	}
+
+	// disallow copy and move
+	MappedFile& operator=(const MappedFile&) = delete;
+	MappedFile(const MappedFile&) = delete;
+
+private:
+	unsigned char* m_data;
+	size_t m_size;
+	int64_t m_modificationTime;
+};
+
+#endif // MAPPED_FILE_H
@@ -0,0 +1,235 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "MemoryTracker.h"
+
+#include <algorithm>
+
+namespace
+{
+	void addBytes(MemoryTracker::Usage& usage, int objectDelta, size_t addedBytes, size_t removedBytes)
+	{
+		usage.objectCount += objectDelta;
+		usage.bytes = usage.bytes + addedBytes - removedBytes;
+		usage.peakBytes = std::max(usage.peakBytes, usage.bytes);
+	}
+
+	void reportUsage(std::ostream& os, const MemoryTracker::Usage& usage)
+	{
+		const double MB = 1024.0 * 1024.0;
+		os << usage.objectCount << " objects, " << usage.bytes / MB << " MB (peak " << usage.peakBytes / MB << " MB)";
+	}
+}
+
+MemoryTracker::MemoryTracker()
+{
+	const Usage empty = {0, 0, 0};
+	m_categories.fill(empty);
+	m_gpu = empty;
+	m_cpu = empty;
+}
+
+MemoryTracker& MemoryTracker::get()
+{
+	static MemoryTracker tracker;
+	return tracker;
+}
+
+const char* MemoryTracker::getCategoryName(MemoryCategory category)
+{
+	switch (category)
+	{
+	case MemoryCategory::Texture:
+		return "texture";
+	case MemoryCategory::Buffer:
+		return "buffer";
+	case MemoryCategory::Shader:
+		return "shader";
+	case MemoryCategory::Program:
+		return "program";
+	case MemoryCategory::Image:
+		return "image";
+	case MemoryCategory::Staging:
+		return "staging";
+	}
+
+	return "unknown";
+}
+
+bool MemoryTracker::isGpuCategory(MemoryCategory category)
+{
+	return category != MemoryCategory::Image && category != MemoryCategory::Staging;
+}
+
+void MemoryTracker::add(MemoryCategory category, const std::string& name, size_t bytes)
+{
+	update(category, name, 1, bytes, 0);
+}
+
+void MemoryTracker::resize(MemoryCategory category, const std::string& name, size_t oldBytes, size_t newBytes)
+{
+	update(category, name, 0, newBytes, oldBytes);
+}
+
+void MemoryTracker::remove(MemoryCategory category, const std::string& name, size_t bytes)
+{
+	update(category, name, -1, 0, bytes);
+}
+
+MemoryTracker::Usage MemoryTracker::getGpuUsage() const
+{
+	std::lock_guard<std::mutex> guard(m_mutex);
+	return m_gpu;
+}
+
+MemoryTracker::Usage MemoryTracker::getCpuUsage() const
+{
+	std::lock_guard<std::mutex> guard(m_mutex);
+	return m_cpu;
+}
+
+MemoryTracker::Usage MemoryTracker::getCategoryUsage(MemoryCategory category) const
+{
+	std::lock_guard<std::mutex> guard(m_mutex);
+	return m_categories[static_cast<size_t>(category)];
+}
+
+std::vector<MemoryTracker::Entry> MemoryTracker::getEntries() const
+{
+	std::vector<Entry> entries;
+
+	std::lock_guard<std::mutex> guard(m_mutex);
+	entries.reserve(m_entries.size());
+	for (const auto& item: m_entries)
+	{
+		const Entry entry = { item.first.first, item.first.second, item.second };
+		entries.push_back(entry);
+	}
+
+	return entries;
+}
+
+void MemoryTracker::report(std::ostream& os) const
+{
+	std::lock_guard<std::mutex> guard(m_mutex);
+
+	os << "Memory: GPU (estimated) ";
+	reportUsage(os, m_gpu);
+	os << ", CPU ";
+	reportUsage(os, m_cpu);
+	os << std::endl;
+
+	for (size_t i = 0; i < CATEGORY_COUNT; i++)
+	{
+		const MemoryCategory category = static_cast<MemoryCategory>(i);
+		if (m_categories[i].peakBytes == 0 && m_categories[i].objectCount == 0)
+			continue;
+
+		os << "  " << getCategoryName(category) << ": ";
+		reportUsage(os, m_categories[i]);
+		os << std::endl;
+
+		for (const auto& item: m_entries)
+		{
+			if (item.first.first != category || item.second.objectCount == 0)
+				continue;
+
+			os << "    " << (item.first.second.empty() ? "(unnamed)" : item.first.second) << ": ";
+			reportUsage(os, item.second);
+			os << std::endl;
+		}
+	}
+}
+
+void MemoryTracker::update(MemoryCategory category, const std::string& name, int objectDelta, size_t addedBytes, size_t removedBytes)
+{
+	std::lock_guard<std::mutex> guard(m_mutex);
+
+	auto it = m_entries.find(std::make_pair(category, name));
+	if (it == m_entries.end())
+	{
+		const Usage empty = {0, 0, 0};
+		it = m_entries.insert(std::make_pair(std::make_pair(category, name), empty)).first;
+	}
+
+	addBytes(it->second, objectDelta, addedBytes, removedBytes);
+	addBytes(m_categories[static_cast<size_t>(category)], objectDelta, addedBytes, removedBytes);
+	addBytes(isGpuCategory(category) ? m_gpu : m_cpu, objectDelta, addedBytes, removedBytes);
+}
+
+TrackedMemory::TrackedMemory():
+	m_category(MemoryCategory::Staging),
+	m_bytes(0),
+	m_registered(false)
+{}
+
+TrackedMemory::TrackedMemory(MemoryCategory category, std::string name, size_t bytes):
+	m_category(category),
+	m_name(std::move(name)),
+	m_bytes(bytes),
+	m_registered(true)
+{
+	MemoryTracker::get().add(m_category, m_name, m_bytes);
+}
+
+TrackedMemory::~TrackedMemory()
+{
+	release();
+}
+
+void TrackedMemory::resize(size_t bytes)
+{
+	if (m_registered)
+		MemoryTracker::get().resize(m_category, m_name, m_bytes, bytes);
+
+	m_bytes = bytes;
+}
+
+TrackedMemory& TrackedMemory::operator=(TrackedMemory&& other)
+{
+	if (this != &other)
+	{
+		release();
+
+		m_category = other.m_category;
+		m_name = std::move(other.m_name);
+		m_bytes = other.m_bytes;
+		m_registered = other.m_registered;
+		other.m_registered = false;
+	}
+
+	return *this;
+}
+
+TrackedMemory::TrackedMemory(TrackedMemory&& other):
+	m_category(other.m_category),
+	m_name(std::move(other.m_name)),
+	m_bytes(other.m_bytes),
+	m_registered(other.m_registered)
+{
+	other.m_registered = false;
+}
+
+void TrackedMemory::release()
+{
+	if (m_registered)
+	{
+		MemoryTracker::get().remove(m_category, m_name, m_bytes);
+		m_registered = false;
+	}
+}
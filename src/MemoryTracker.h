@@ -0,0 +1,140 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MEMORY_TRACKER_H
+#define MEMORY_TRACKER_H
+
+#include <map>
+#include <array>
+#include <vector>
+#include <string>
+#include <mutex>
+#include <ostream>
+#include <utility>
+#include <cstddef>
+
+enum class MemoryCategory
+{
+	// driver (GPU) memory, estimated
+	Texture,
+	Buffer,
+	Shader,
+	Program,
+	// CPU memory
+	Image,
+	Staging
+};
+
+/**
+ * Bookkeeping of the memory held by textures, buffers, images etc., by category and debug name.
+ *
+ * The sizes are estimates: the driver may pad or compress the data, so this is meant for
+ * budgeting rather than exact numbers. The objects register themselves through TrackedMemory.
+ * All the methods are thread safe.
+ */
+class MemoryTracker
+{
+public:
+	static const size_t CATEGORY_COUNT = 6;
+
+	struct Usage
+	{
+		size_t objectCount;
+		size_t bytes;
+		size_t peakBytes;
+	};
+
+	struct Entry
+	{
+		MemoryCategory category;
+		std::string name;
+		Usage usage;
+	};
+
+	static MemoryTracker& get();
+	static const char* getCategoryName(MemoryCategory category);
+	static bool isGpuCategory(MemoryCategory category);
+
+	void add(MemoryCategory category, const std::string& name, size_t bytes);
+	void resize(MemoryCategory category, const std::string& name, size_t oldBytes, size_t newBytes);
+	void remove(MemoryCategory category, const std::string& name, size_t bytes);
+
+	Usage getGpuUsage() const;
+	Usage getCpuUsage() const;
+	Usage getCategoryUsage(MemoryCategory category) const;
+
+	/**
+	 * All the names seen so far, including the ones with nothing allocated at the moment (for the peaks).
+	 */
+	std::vector<Entry> getEntries() const;
+
+	void report(std::ostream& os) const;
+
+	// disallow copy and move
+	MemoryTracker& operator=(MemoryTracker&&) = delete;
+	MemoryTracker(MemoryTracker&&) = delete;
+	MemoryTracker& operator=(const MemoryTracker&) = delete;
+	MemoryTracker(const MemoryTracker&) = delete;
+
+private:
+	MemoryTracker();
+
+	void update(MemoryCategory category, const std::string& name, int objectDelta, size_t addedBytes, size_t removedBytes);
+
+	mutable std::mutex m_mutex;
+	std::map<std::pair<MemoryCategory, std::string>, Usage> m_entries;
+	std::array<Usage, CATEGORY_COUNT> m_categories;
+	Usage m_gpu;
+	Usage m_cpu;
+};
+
+/**
+ * An allocation registered in the MemoryTracker for as long as this object lives.
+ * Moving transfers the registration.
+ */
+class TrackedMemory
+{
+public:
+	/** Nothing is registered. */
+	TrackedMemory();
+	TrackedMemory(MemoryCategory category, std::string name, size_t bytes = 0);
+	~TrackedMemory();
+
+	size_t getSize() const
+	{
+		return m_bytes;
+	}
+
+	void resize(size_t bytes);
+
+	// allow move, disallow copy
+	TrackedMemory& operator=(TrackedMemory&& other);
+	TrackedMemory(TrackedMemory&& other);
+	TrackedMemory& operator=(const TrackedMemory&) = delete;
+	TrackedMemory(const TrackedMemory&) = delete;
+
+private:
+	void release();
+
+	MemoryCategory m_category;
+	std::string m_name;
+	size_t m_bytes;
+	bool m_registered;
+};
+
+#endif // MEMORY_TRACKER_H
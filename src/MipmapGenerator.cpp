@@ -0,0 +1,66 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "MipmapGenerator.h"
+
+#include <memory>
+#include <algorithm>
+
+Image generateMipmapLevel(const Image& image)
+{
+	const unsigned srcWidth = image.getWidth();
+	const unsigned srcHeight = image.getHeight();
+	const unsigned width = std::max(srcWidth / 2, 1u);
+	const unsigned height = std::max(srcHeight / 2, 1u);
+
+	const unsigned char* src = image.getData();
+	const size_t srcRowSize = srcWidth * 4;
+
+	std::unique_ptr<unsigned char[]> data(new unsigned char[width * height * 4]);
+	unsigned char* dst = data.get();
+
+	for (unsigned y = 0; y < height; y++)
+	{
+		// odd sizes above 1 drop the last row/column (the size is halved, rounding down); the clamp
+		// only matters for a size of 1, where the single row/column is averaged with itself
+		const unsigned char* row0 = src + std::min(2*y, srcHeight - 1) * srcRowSize;
+		const unsigned char* row1 = src + std::min(2*y + 1, srcHeight - 1) * srcRowSize;
+
+		for (unsigned x = 0; x < width; x++)
+		{
+			const unsigned x0 = std::min(2*x, srcWidth - 1) * 4;
+			const unsigned x1 = std::min(2*x + 1, srcWidth - 1) * 4;
+
+			for (unsigned c = 0; c < 4; c++)
+				*dst++ = (row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) / 4;
+		}
+	}
+
+	return Image(width, height, std::move(data), "mipmap");
+}
+
+std::vector<Image> generateMipmaps(Image baseLevel)
+{
+	std::vector<Image> levels;
+	levels.push_back(std::move(baseLevel));
+
+	while (levels.back().getWidth() > 1 || levels.back().getHeight() > 1)
+		levels.push_back(generateMipmapLevel(levels.back()));
+
+	return levels;
+}
@@ -0,0 +1,37 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MIPMAP_GENERATOR_H
+#define MIPMAP_GENERATOR_H
+
+#include "Image.h"
+
+#include <vector>
+
+/**
+ * Compute the next mipmap level (half the size, rounded down, at least 1)
+ * of an RGBA image using a box filter.
+ */
+Image generateMipmapLevel(const Image& image);
+
+/**
+ * Compute the full mipmap chain down to 1x1. The base level is the first element.
+ */
+std::vector<Image> generateMipmaps(Image baseLevel);
+
+#endif // MIPMAP_GENERATOR_H
@@ -18,10 +18,14 @@
  */
 #include "Exceptions.h"
 #include "MirConnectionWrapper.h"
+#include "Trace.h"
 
 MirConnectionWrapper::MirConnectionWrapper(const char* server, const char* appName):
-	m_connection(mir_connect_sync(server, appName), mir_connection_release)
+	m_connection(nullptr, mir_connection_release)
 {
+	TRACE_SCOPE("mir_connect_sync");
+	m_connection.reset(mir_connect_sync(server, appName));
+
 	if (!m_connection || !mir_connection_is_valid(m_connection.get()))
 		throw MirConnectionError(m_connection.get());
 }
@@ -18,11 +18,19 @@
  */
 #include "MirConnectionWrapper.h"
 #include "MirNativeWindow.h"
-#include "DemoRenderer.h"
+#include "HeadlessWindow.h"
+#include "AssetPipeline.h"
+#include "PhaseTimer.h"
+#include "Benchmark.h"
+#include "GoldenImageCheck.h"
+#include "Options.h"
+#include "scenarios/ScenarioRegistry.h"
 
 #include <memory>
 #include <iostream>
 #include <iomanip>
+#include <thread>
+#include <algorithm>
 
 namespace
 {
@@ -186,19 +194,126 @@ namespace
 
 		std::cout << std::endl;
 	}
+
+	unsigned getAssetWorkerCount()
+	{
+		// hardware_concurrency() may return 0 if unknown; there is not that much work anyway
+		return std::max(1u, std::min(std::thread::hardware_concurrency(), 4u));
+	}
+
+	void writeBenchmarkResults(const Benchmark& benchmark, const std::string& fileName, const PhaseTimer& startupTimer)
+	{
+		benchmark.writeJson(fileName, startupTimer);
+		std::cout << "Benchmark results written to " << fileName << std::endl;
+	}
+
+	/**
+	 * Write the results of a benchmark or a golden image check, if any. Returns the exit code.
+	 */
+	int finishRun(const Benchmark* benchmark, const GoldenImageCheck* goldenCheck, const Options& options, const PhaseTimer& startupTimer)
+	{
+		if (benchmark)
+			writeBenchmarkResults(*benchmark, options.benchmarkOutput, startupTimer);
+
+		if (!goldenCheck)
+			return 0;
+
+		goldenCheck->report(std::cout);
+		return goldenCheck->hasPassed() ? 0 : 1;
+	}
 }
 
-int main()
+int main(int argc, char* argv[])
 {
+	Options options;
+	try
+	{
+		options = parseOptions(argc, argv);
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << std::endl;
+		printUsage(std::cerr, argv[0]);
+		return 1;
+	}
+
+	if (options.showHelp)
+	{
+		printUsage(std::cout, argv[0]);
+		return 0;
+	}
+
+	if (options.listScenarios)
+	{
+		listScenarios(std::cout);
+		return 0;
+	}
+
+	ScenarioSpec scenario;
+	std::shared_ptr<Benchmark> benchmark;
+	std::shared_ptr<GoldenImageCheck> goldenCheck;
+	try
+	{
+		scenario = parseScenarioSpec(options.scenario);
+		if (!options.goldenDirectory.empty())
+		{
+			goldenCheck = std::make_shared<GoldenImageCheck>(options.goldenDirectory,
+					options.updateGolden ? GoldenImageCheck::Mode::Update : GoldenImageCheck::Mode::Compare,
+					options.goldenTolerance, options.goldenMaxDifferingPercent, options.goldenFrames);
+			// the frame times of the same run, without the captured frames
+			benchmark = std::make_shared<Benchmark>(scenario.toString() + " (golden image check)",
+					goldenCheck->getTimedFrameCount(), 0.0);
+		}
+		else if (options.benchmark)
+			benchmark = std::make_shared<Benchmark>(scenario.toString(), options.benchmarkFrames, options.benchmarkSeconds);
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+
+	std::shared_ptr<PhaseTimer> startupTimer = std::make_shared<PhaseTimer>();
+
+	// start loading the assets right away so that it overlaps with the Mir and EGL initialization
+	std::shared_ptr<AssetPipeline> assets = std::make_shared<AssetPipeline>(getAssetWorkerCount(), startupTimer);
+	if (scenario.info->preloadAssets)
+		scenario.info->preloadAssets(*assets);
+	startupTimer->mark("start asset preloading");
+
+	std::shared_ptr<MirNativeWindowRenderer> renderer;
+	try
+	{
+		renderer = createScenario(scenario, ScenarioContext{nullptr, assets, startupTimer, benchmark, goldenCheck, &options});
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+
+	if (options.headless)
+	{
+		HeadlessWindow headlessWindow(options.headlessWidth, options.headlessHeight, renderer);
+		startupTimer->mark("headless EGL setup");
+
+		// returns only when the benchmark is done
+		headlessWindow.run();
+		return finishRun(benchmark.get(), goldenCheck.get(), options, *startupTimer);
+	}
+
 	MirConnectionWrapper mirConnection(nullptr /*default*/, "MirGLESDemo");
+	startupTimer->mark("Mir connection");
 
 	listFormats(mirConnection.get());
 
 	const int outputId = chooseOutputId(mirConnection.get());
 	std::cout << "Using output #" << outputId << std::endl;
+	startupTimer->mark("output selection");
 
-	MirNativeWindow mirNativeWindow(mirConnection.get(), outputId, "MirGLESDemo Surface", std::make_shared<DemoRenderer>());
-	mirNativeWindow.run();
+	MirNativeWindow mirNativeWindow(mirConnection.get(), outputId, "MirGLESDemo Surface", renderer);
+	startupTimer->mark("window and EGL setup");
 
-	return 0;
+	mirNativeWindow.run();
+	return finishRun(benchmark.get(), goldenCheck.get(), options, *startupTimer);
 }
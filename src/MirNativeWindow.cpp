@@ -18,6 +18,7 @@
  */
 #include "MirNativeWindow.h"
 #include "Exceptions.h"
+#include "Trace.h"
 
 #include <utility>
 #include <iostream>
@@ -33,6 +34,8 @@ MirNativeWindow::MirNativeWindow(MirConnection* connection, int outputId, const
 	m_eglSurface(EGL_NO_SURFACE),
 	m_renderer(std::move(renderer))
 {
+	TRACE_SCOPE("MirNativeWindow setup");
+
 	if (!m_connection)
 		throw std::runtime_error("MirNativeWindow::MirNativeWindow: created with null mir connection!");
 
@@ -56,6 +59,7 @@ MirNativeWindow::MirNativeWindow(MirConnection* connection, int outputId, const
 	if (m_eglSurface == EGL_NO_SURFACE)
 		throw std::runtime_error("Can't create EGL surface!");
 
+	TRACE_SCOPE("EGL context setup");
 	if (eglBindAPI(EGL_OPENGL_ES_API) != EGL_TRUE)
 		throw EGLError("Can't bind OpenGL ES API!");
 
@@ -94,9 +98,16 @@ int MirNativeWindow::getHeight()
 
 void MirNativeWindow::swapBuffers()
 {
+	TRACE_SCOPE("eglSwapBuffers");
 	eglSwapBuffers(m_eglDisplay, m_eglSurface);
 }
 
+void MirNativeWindow::setSwapInterval(int interval)
+{
+	if (eglSwapInterval(m_eglDisplay, interval) != EGL_TRUE)
+		throw EGLError("Can't set the swap interval!");
+}
+
 void MirNativeWindow::surfaceEventHandler(const MirEvent* event)
 {
 	std::lock_guard<std::mutex> guard(m_eventMutex);
@@ -105,6 +116,8 @@ void MirNativeWindow::surfaceEventHandler(const MirEvent* event)
 
 void MirNativeWindow::initEGL()
 {
+	TRACE_SCOPE("initEGL");
+
 	/*
 	 * EGLNativeDisplayType is a typedef to XDisplay even though it's in fact MirEGLNativeDisplayType with Mir
 	 * but this is nothing a little reinterpret_cast couldn't fix...
@@ -115,7 +128,7 @@ void MirNativeWindow::initEGL()
 	if (eglInitialize(m_eglDisplay, &major, &minor) != EGL_TRUE)
 		throw EGLError("Can't initialize EGL!");
 
-	std::cout << "Initalized EGL " << major << "." << minor << std::endl;
+	std::cout << "Initialized EGL " << major << "." << minor << std::endl;
 }
 
 EGLConfig MirNativeWindow::getEglConfig()
@@ -44,6 +44,7 @@ private:
 	virtual int getWidth() override;
 	virtual int getHeight() override;
 	virtual void swapBuffers() override;
+	virtual void setSwapInterval(int interval) override;
 
 	void surfaceEventHandler(const MirEvent* event);
 
@@ -26,6 +26,9 @@ public:
 	virtual int getHeight() = 0;
 	virtual void swapBuffers() = 0;
 
+	/** 0 disables the wait for the vertical sync, 1 is the default. */
+	virtual void setSwapInterval(int interval) = 0;
+
 	virtual ~MirNativeWindowControl()
 	{}
 };
@@ -0,0 +1,331 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "Options.h"
+
+#include <string>
+#include <stdexcept>
+#include <limits>
+
+namespace
+{
+	// frames rendered before --assert-no-allocations takes effect, if not given
+	const unsigned DEFAULT_ALLOCATION_WARMUP_FRAMES = 100;
+
+	// length of a benchmark run if neither --benchmark-frames nor --benchmark-seconds is given
+	const unsigned DEFAULT_BENCHMARK_FRAMES = 1000;
+}
+
+unsigned parseUnsigned(const std::string& option, const std::string& value)
+{
+	size_t end = 0;
+	unsigned long result = 0;
+	try
+	{
+		result = std::stoul(value, &end);
+	}
+	catch (const std::exception&)
+	{
+		end = 0;
+	}
+
+	if (value.empty() || end != value.size() || value[0] == '-' || result > std::numeric_limits<unsigned>::max())
+		throw std::runtime_error("invalid value for " + option + ": " + value);
+
+	return static_cast<unsigned>(result);
+}
+
+float parseFloat(const std::string& option, const std::string& value)
+{
+	size_t end = 0;
+	float result = 0;
+	try
+	{
+		result = std::stof(value, &end);
+	}
+	catch (const std::exception&)
+	{
+		end = 0;
+	}
+
+	if (value.empty() || end != value.size())
+		throw std::runtime_error("invalid value for " + option + ": " + value);
+
+	return result;
+}
+
+Options::Options():
+	showHelp(false),
+	listScenarios(false),
+	touchPrediction(false),
+	predictionHorizonMs(33),
+	predictionMaxOvershoot(50.0f),
+	measurePrediction(false),
+	headless(false),
+	headlessWidth(720),
+	headlessHeight(1280),
+	replaySpeed(1.0),
+	replayStepMs(0.0),
+	traceFrames(300),
+	assertNoAllocationsAfter(0),
+	scenario("cube"),
+	benchmark(false),
+	benchmarkFrames(0),
+	benchmarkSeconds(0.0),
+	benchmarkOutput("benchmark.json"),
+	updateGolden(false),
+	goldenTolerance(3),
+	goldenMaxDifferingPercent(0.1f),
+	goldenFrames(50)
+{
+}
+
+Options parseOptions(int argc, char* argv[])
+{
+	Options options;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string arg(argv[i]);
+
+		// --name or --name=value
+		const size_t equals = arg.find('=');
+		const std::string name = arg.substr(0, equals);
+		const bool hasValue = equals != std::string::npos;
+		const std::string value = hasValue ? arg.substr(equals + 1) : std::string();
+
+		auto requireValue = [&]()
+		{
+			if (!hasValue)
+				throw std::runtime_error("option " + name + " needs a value");
+		};
+		auto requireNoValue = [&]()
+		{
+			if (hasValue)
+				throw std::runtime_error("option " + name + " takes no value");
+		};
+
+		if (name == "--help" || name == "-h")
+		{
+			requireNoValue();
+			options.showHelp = true;
+		}
+		else if (name == "--list-scenarios")
+		{
+			requireNoValue();
+			options.listScenarios = true;
+		}
+		else if (name == "--scenario")
+		{
+			requireValue();
+			options.scenario = value;
+		}
+		else if (name == "--touch-prediction")
+		{
+			requireNoValue();
+			options.touchPrediction = true;
+		}
+		else if (name == "--prediction-horizon")
+		{
+			requireValue();
+			options.predictionHorizonMs = parseUnsigned(name, value);
+		}
+		else if (name == "--prediction-max-overshoot")
+		{
+			requireValue();
+			options.predictionMaxOvershoot = parseFloat(name, value);
+		}
+		else if (name == "--measure-prediction")
+		{
+			requireNoValue();
+			options.measurePrediction = true;
+		}
+		else if (name == "--headless")
+		{
+			options.headless = true;
+			if (hasValue)
+			{
+				const size_t x = value.find('x');
+				if (x == std::string::npos)
+					throw std::runtime_error("invalid value for " + name + ": " + value);
+				options.headlessWidth = parseUnsigned(name, value.substr(0, x));
+				options.headlessHeight = parseUnsigned(name, value.substr(x + 1));
+				if (options.headlessWidth == 0 || options.headlessHeight == 0)
+					throw std::runtime_error("invalid value for " + name + ": " + value);
+			}
+		}
+		else if (name == "--record-input")
+		{
+			requireValue();
+			options.recordInputFile = value;
+		}
+		else if (name == "--replay-input")
+		{
+			requireValue();
+			options.replayInputFile = value;
+		}
+		else if (name == "--replay-speed")
+		{
+			requireValue();
+			options.replaySpeed = parseFloat(name, value);
+			if (!(options.replaySpeed > 0))
+				throw std::runtime_error("invalid value for " + name + ": " + value);
+		}
+		else if (name == "--replay-step")
+		{
+			requireValue();
+			options.replayStepMs = parseFloat(name, value);
+			if (options.replayStepMs < 0)
+				throw std::runtime_error("invalid value for " + name + ": " + value);
+		}
+		else if (name == "--trace" || name == "--trace-frames")
+		{
+#ifdef MIRGLESDEMO_TRACING
+			requireValue();
+			if (name == "--trace")
+				options.traceFile = value;
+			else
+				options.traceFrames = parseUnsigned(name, value);
+#else
+			throw std::runtime_error("option " + name + " needs a build with MIRGLESDEMO_TRACING enabled");
+#endif
+		}
+		else if (name == "--assert-no-allocations")
+		{
+#ifdef MIRGLESDEMO_ALLOCATION_TRACKING
+			options.assertNoAllocationsAfter = hasValue ? parseUnsigned(name, value) : DEFAULT_ALLOCATION_WARMUP_FRAMES;
+			if (options.assertNoAllocationsAfter == 0)
+				throw std::runtime_error("invalid value for " + name + ": " + value);
+#else
+			throw std::runtime_error("option " + name + " needs a build with MIRGLESDEMO_ALLOCATION_TRACKING enabled");
+#endif
+		}
+		else if (name == "--benchmark")
+		{
+			options.benchmark = true;
+			if (hasValue)
+				options.scenario = value;
+		}
+		else if (name == "--benchmark-frames")
+		{
+			requireValue();
+			options.benchmarkFrames = parseUnsigned(name, value);
+			if (options.benchmarkFrames == 0)
+				throw std::runtime_error("invalid value for " + name + ": " + value);
+		}
+		else if (name == "--benchmark-seconds")
+		{
+			requireValue();
+			options.benchmarkSeconds = parseFloat(name, value);
+			if (!(options.benchmarkSeconds > 0))
+				throw std::runtime_error("invalid value for " + name + ": " + value);
+		}
+		else if (name == "--benchmark-output")
+		{
+			requireValue();
+			options.benchmarkOutput = value;
+		}
+		else if (name == "--golden")
+		{
+			requireValue();
+			options.goldenDirectory = value;
+		}
+		else if (name == "--update-golden")
+		{
+			requireNoValue();
+			options.updateGolden = true;
+		}
+		else if (name == "--golden-tolerance")
+		{
+			requireValue();
+			options.goldenTolerance = parseUnsigned(name, value);
+		}
+		else if (name == "--golden-max-differing")
+		{
+			requireValue();
+			options.goldenMaxDifferingPercent = parseFloat(name, value);
+			if (!(options.goldenMaxDifferingPercent >= 0))
+				throw std::runtime_error("invalid value for " + name + ": " + value);
+		}
+		else if (name == "--golden-frames")
+		{
+			requireValue();
+			options.goldenFrames = parseUnsigned(name, value);
+			if (options.goldenFrames == 0)
+				throw std::runtime_error("invalid value for " + name + ": " + value);
+		}
+		else
+			throw std::runtime_error("unknown option " + arg);
+	}
+
+	// the golden image check times its own frames
+	if (!options.goldenDirectory.empty() && options.benchmark)
+		throw std::runtime_error("option --golden can't be combined with --benchmark");
+	if (options.updateGolden && options.goldenDirectory.empty())
+		throw std::runtime_error("option --update-golden needs --golden");
+
+	if (options.benchmark && options.benchmarkFrames == 0 && options.benchmarkSeconds == 0)
+		options.benchmarkFrames = DEFAULT_BENCHMARK_FRAMES;
+
+	return options;
+}
+
+void printUsage(std::ostream& os, const char* programName)
+{
+	const Options defaults;
+
+	os << "Usage: " << programName << " [OPTION]..." << std::endl
+	   << std::endl
+	   << "  -h, --help                      show this help" << std::endl
+	   << "  --touch-prediction              extrapolate the dragged pointer to the expected presentation time" << std::endl
+	   << "  --prediction-horizon=MS         how far ahead to predict (default " << defaults.predictionHorizonMs << ")" << std::endl
+	   << "  --prediction-max-overshoot=PX   maximal distance of the prediction from the last position (default "
+	   << defaults.predictionMaxOvershoot << ")" << std::endl
+	   << "  --measure-prediction            compare the predictions with the actual positions (with or without" << std::endl
+	   << "                                  --touch-prediction)" << std::endl
+	   << "  --headless[=WxH]                render off-screen without Mir (default " << defaults.headlessWidth << "x"
+	   << defaults.headlessHeight << ")" << std::endl
+	   << "  --record-input=FILE             record the input into FILE" << std::endl
+	   << "  --replay-input=FILE             replay the input recorded in FILE" << std::endl
+	   << "  --replay-speed=X                replay X times faster than recorded (default 1)" << std::endl
+	   << "  --replay-step=MS                advance the replay by MS (times the speed) each frame instead of" << std::endl
+	   << "                                  following the clock, for deterministic runs" << std::endl
+	   << "  --trace=FILE                    write a Chrome trace-event JSON of the first frames into FILE" << std::endl
+	   << "                                  (needs a build with MIRGLESDEMO_TRACING)" << std::endl
+	   << "  --trace-frames=N                how many frames to trace (default " << defaults.traceFrames << ")" << std::endl
+	   << "  --assert-no-allocations[=N]     abort if the render or input path allocates after N frames (default "
+	   << DEFAULT_ALLOCATION_WARMUP_FRAMES << ")" << std::endl
+	   << "                                  (needs a build with MIRGLESDEMO_ALLOCATION_TRACKING)" << std::endl
+	   << "  --scenario=SCENARIO             what to render (default " << defaults.scenario << "), SCENARIO is" << std::endl
+	   << "                                  NAME[:PARAMETER=VALUE,...]" << std::endl
+	   << "  --list-scenarios                list the scenarios and their parameters" << std::endl
+	   << "  --benchmark[=SCENARIO]          render the scenario as fast as possible, write the results and exit" << std::endl
+	   << "  --benchmark-frames=N            stop the benchmark after N frames (default " << DEFAULT_BENCHMARK_FRAMES
+	   << " if there is no time limit)" << std::endl
+	   << "  --benchmark-seconds=S           stop the benchmark after S seconds" << std::endl
+	   << "  --benchmark-output=FILE         write the benchmark results as JSON into FILE (default "
+	   << defaults.benchmarkOutput << ")" << std::endl
+	   << "  --golden=DIR                    render the cube in fixed poses, compare them with the golden images in" << std::endl
+	   << "                                  DIR, write the frame times as with --benchmark and exit (1 on a mismatch)" << std::endl
+	   << "  --update-golden                 write the golden images into the --golden DIR instead" << std::endl
+	   << "  --golden-tolerance=N            a pixel differs if a channel differs by more than N (default "
+	   << defaults.goldenTolerance << ")" << std::endl
+	   << "  --golden-max-differing=PERCENT  fail if more than PERCENT of the pixels differ (default "
+	   << defaults.goldenMaxDifferingPercent << ")" << std::endl
+	   << "  --golden-frames=N               timed frames rendered in each pose (default " << defaults.goldenFrames << ")" << std::endl;
+}
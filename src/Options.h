@@ -0,0 +1,81 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef OPTIONS_H
+#define OPTIONS_H
+
+#include <ostream>
+#include <string>
+
+/**
+ * Command line options.
+ */
+struct Options
+{
+	Options();
+
+	bool showHelp;
+	bool listScenarios;
+
+	bool touchPrediction;
+	unsigned predictionHorizonMs;
+	float predictionMaxOvershoot; // pixels
+	bool measurePrediction;
+
+	bool headless;
+	int headlessWidth;
+	int headlessHeight;
+
+	std::string recordInputFile;
+	std::string replayInputFile;
+	double replaySpeed;
+	double replayStepMs; // 0: follow the wall clock
+
+	std::string traceFile;
+	unsigned traceFrames;
+
+	unsigned assertNoAllocationsAfter; // frames of warmup, 0: off
+
+	std::string scenario; // NAME[:PARAMETER=VALUE,...]
+	bool benchmark;
+	unsigned benchmarkFrames; // 0: no limit
+	double benchmarkSeconds; // 0: no limit
+	std::string benchmarkOutput;
+
+	std::string goldenDirectory; // empty: no golden image check
+	bool updateGolden;
+	unsigned goldenTolerance; // per channel
+	float goldenMaxDifferingPercent;
+	unsigned goldenFrames; // timed frames per pose
+};
+
+/**
+ * Parse the command line. Throws std::runtime_error on invalid options.
+ */
+Options parseOptions(int argc, char* argv[]);
+
+/**
+ * Parse a number given as the value of an option (or a parameter). Throws std::runtime_error
+ * mentioning the option if it's invalid.
+ */
+unsigned parseUnsigned(const std::string& option, const std::string& value);
+float parseFloat(const std::string& option, const std::string& value);
+
+void printUsage(std::ostream& os, const char* programName);
+
+#endif // OPTIONS_H
@@ -18,6 +18,8 @@
  */
 #include "PNGLoader.h"
 #include "Image.h"
+#include "Trace.h"
+#include "Log.h"
 
 #include <memory>
 
@@ -25,7 +27,7 @@
 #include <cstdio>
 #include <csetjmp>
 #include <cstring>
-#include <iostream>
+#include <stdexcept>
 
 /**
  * Read any color_type into 8bit depth, RGBA format.
@@ -59,61 +61,147 @@ static void setPngReadOptions(png_structp pngReader, png_infop pngInfo)
 	png_read_update_info(pngReader, pngInfo);
 }
 
-// inspired by
-// https://blog.nobel-joergensen.com/2010/11/07/loading-a-png-as-texture-in-opengl-using-libpng/
-// http://www.libpng.org/pub/png/book/chapter13.html
-// https://gist.github.com/niw/5963798
+namespace
+{
+	struct MemoryReader
+	{
+		const unsigned char* data;
+		size_t size;
+		size_t offset;
+	};
+
+	void readFromMemory(png_structp pngReader, png_bytep out, png_size_t length)
+	{
+		MemoryReader* reader = static_cast<MemoryReader*>(png_get_io_ptr(pngReader));
+		if (length > reader->size - reader->offset)
+			png_error(pngReader, "unexpected end of data");
+
+		std::memcpy(out, reader->data + reader->offset, length);
+		reader->offset += length;
+	}
+
+	void initFileIO(png_structp pngReader, void* file)
+	{
+		png_init_io(pngReader, static_cast<FILE*>(file));
+	}
+
+	void initMemoryIO(png_structp pngReader, void* reader)
+	{
+		png_set_read_fn(pngReader, reader, readFromMemory);
+	}
+
+	// inspired by
+	// https://blog.nobel-joergensen.com/2010/11/07/loading-a-png-as-texture-in-opengl-using-libpng/
+	// http://www.libpng.org/pub/png/book/chapter13.html
+	// https://gist.github.com/niw/5963798
+	Image decodePNG(void (*initIO)(png_structp, void*), void* ioContext, const std::string& name)
+	{
+		png_infop pngInfo = nullptr;
+		auto pngDeleter = [&pngInfo](png_structp pngReader){
+			png_destroy_read_struct(&pngReader, &pngInfo, nullptr);
+		};
+		std::unique_ptr<png_struct, decltype(pngDeleter)> pngReader(nullptr, pngDeleter);
+
+		pngReader.reset(png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr));
+		if (!pngReader)
+			throw std::runtime_error("Can't create PNG reader!");
+
+		pngInfo = png_create_info_struct(pngReader.get());
+		if (!pngInfo)
+			throw std::runtime_error("Can't create PNG reader info structure!");
+
+		if (setjmp(png_jmpbuf(pngReader.get())))
+			throw std::runtime_error("Can't decode the file.");
+
+		initIO(pngReader.get(), ioContext);
+		png_set_sig_bytes(pngReader.get(), 0);
+		png_read_info(pngReader.get(), pngInfo);
+
+		const png_uint_32 width = png_get_image_width(pngReader.get(), pngInfo);
+		const png_uint_32 height = png_get_image_height(pngReader.get(), pngInfo);
+		LOG_DEBUG("loadPNG: width = " << width << ", height = " << height);
+
+		setPngReadOptions(pngReader.get(), pngInfo);
+
+		const size_t rowSize = png_get_rowbytes(pngReader.get(), pngInfo);
+
+		// buffer holding the whole image
+		std::unique_ptr<unsigned char[]> data(new unsigned char[rowSize * height]);
+
+		/*
+		 * Allocate and fill an array of row pointers: one pointer for each row.
+		 * The rows in a PNG are ordered top to bottom but OpenGL expects the rows bottom to top.
+		 * So the rowPointers vectors is filled reversed: first row pointer points to the last
+		 * row in the output buffer etc.
+		 */
+		std::unique_ptr<png_bytep[]> rowPointers(new png_bytep[height]);
+		for (size_t i = 0; i < height; i++)
+			rowPointers[i] = data.get() + (height - 1 - i) * rowSize;
+
+		png_read_image(pngReader.get(), rowPointers.get());
+
+		return Image(width, height, std::move(data), name);
+	}
+}
+
 Image loadPNG(const std::string& fileName)
 {
-	std::cout << "Loading file: " << fileName.c_str() << std::endl;
+	TRACE_SCOPE("loadPNG");
+	LOG_DEBUG("Loading file: " << fileName);
 
 	std::unique_ptr<FILE,decltype(&fclose)> file(std::fopen(fileName.c_str(), "rb"), fclose);
 	if (!file)
 		throw std::runtime_error(std::string("Can't open file ") + fileName);
 
-	png_infop pngInfo = nullptr;
-	auto pngDeleter = [&pngInfo](png_structp pngReader){
-		png_destroy_read_struct(&pngReader, &pngInfo, nullptr);
-	};
-	std::unique_ptr<png_struct, decltype(pngDeleter)> pngReader(nullptr, pngDeleter);
-
-	pngReader.reset(png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr));
-	if (!pngReader)
-		throw std::runtime_error("Can't create PNG reader!");
+	return decodePNG(initFileIO, file.get(), fileName);
+}
 
-	pngInfo = png_create_info_struct(pngReader.get());
-	if (!pngInfo)
-		throw std::runtime_error("Can't create PNG reader info structure!");
+Image loadPNG(const unsigned char* data, size_t size, const std::string& name)
+{
+	TRACE_SCOPE("loadPNG");
+	LOG_DEBUG("Decoding PNG: " << name);
 
-	if (setjmp(png_jmpbuf(pngReader.get())))
-		throw std::runtime_error("Can't decode the file.");
+	MemoryReader reader = { data, size, 0 };
+	return decodePNG(initMemoryIO, &reader, name);
+}
 
-	png_init_io(pngReader.get(), file.get());
-	png_set_sig_bytes(pngReader.get(), 0);
-	png_read_info(pngReader.get(), pngInfo);
+void savePNG(const std::string& fileName, const Image& image)
+{
+	TRACE_SCOPE("savePNG");
+	LOG_DEBUG("Saving file: " << fileName);
 
-	const png_uint_32 width = png_get_image_width(pngReader.get(), pngInfo);
-	const png_uint_32 height = png_get_image_height(pngReader.get(), pngInfo);
-	std::cout << "loadPNG: width = " << width << ", height = " << height << std::endl;
+	std::unique_ptr<FILE,decltype(&fclose)> file(std::fopen(fileName.c_str(), "wb"), fclose);
+	if (!file)
+		throw std::runtime_error(std::string("Can't create file ") + fileName);
 
-	setPngReadOptions(pngReader.get(), pngInfo);
+	png_infop pngInfo = nullptr;
+	auto pngDeleter = [&pngInfo](png_structp pngWriter){
+		png_destroy_write_struct(&pngWriter, &pngInfo);
+	};
+	std::unique_ptr<png_struct, decltype(pngDeleter)> pngWriter(nullptr, pngDeleter);
 
-	const size_t rowSize = png_get_rowbytes(pngReader.get(), pngInfo);
+	pngWriter.reset(png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr));
+	if (!pngWriter)
+		throw std::runtime_error("Can't create PNG writer!");
 
-	// buffer holding the whole image
-	std::unique_ptr<unsigned char[]> data(new unsigned char[rowSize * height]);
+	pngInfo = png_create_info_struct(pngWriter.get());
+	if (!pngInfo)
+		throw std::runtime_error("Can't create PNG writer info structure!");
 
-	/*
-	 * Allocate and fill an array of row pointers: one pointer for each row.
-	 * The rows in a PNG are ordered top to bottom but OpenGL expects the rows bottom to top.
-	 * So the rowPointers vectors is filled reversed: first row pointer points to the last
-	 * row in the output buffer etc.
-	 */
+	// the same reversed order as in decodePNG()
+	const unsigned height = image.getHeight();
+	const size_t rowSize = static_cast<size_t>(image.getWidth()) * 4;
 	std::unique_ptr<png_bytep[]> rowPointers(new png_bytep[height]);
 	for (size_t i = 0; i < height; i++)
-		rowPointers[i] = data.get() + (height - 1 - i) * rowSize;
+		rowPointers[i] = image.getData() + (height - 1 - i) * rowSize;
 
-	png_read_image(pngReader.get(), rowPointers.get());
+	if (setjmp(png_jmpbuf(pngWriter.get())))
+		throw std::runtime_error(std::string("Can't write the file ") + fileName);
 
-	return Image(width, height, std::move(data));
+	png_init_io(pngWriter.get(), file.get());
+	png_set_IHDR(pngWriter.get(), pngInfo, image.getWidth(), height, 8, PNG_COLOR_TYPE_RGB_ALPHA,
+			PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+	png_write_info(pngWriter.get(), pngInfo);
+	png_write_image(pngWriter.get(), rowPointers.get());
+	png_write_end(pngWriter.get(), nullptr);
 }
@@ -22,7 +22,18 @@
 #include "Image.h"
 
 #include <string>
+#include <cstddef>
 
 Image loadPNG(const std::string& fileName);
 
+/**
+ * Decode a PNG image held in memory. The name is only used in messages.
+ */
+Image loadPNG(const unsigned char* data, size_t size, const std::string& name);
+
+/**
+ * Write an RGBA image (rows bottom to top, as loaded by loadPNG or read by glReadPixels) as an 8bit RGBA PNG.
+ */
+void savePNG(const std::string& fileName, const Image& image);
+
 #endif // PNG_LOADER_H
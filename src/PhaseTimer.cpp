@@ -0,0 +1,85 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "PhaseTimer.h"
+
+#include <iomanip>
+
+namespace
+{
+	double toMilliseconds(PhaseTimer::clock::duration d)
+	{
+		return std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(d).count();
+	}
+}
+
+PhaseTimer::PhaseTimer():
+	m_start(clock::now()),
+	m_lastMark(m_start),
+	m_isStopped(false)
+{}
+
+void PhaseTimer::mark(std::string phaseName)
+{
+	const clock::time_point now = clock::now();
+
+	std::lock_guard<std::mutex> guard(m_mutex);
+	if (m_isStopped)
+		return;
+
+	m_phases.push_back(Phase{std::move(phaseName), m_lastMark - m_start, now - m_lastMark, false});
+	m_lastMark = now;
+}
+
+void PhaseTimer::addConcurrent(std::string name, clock::time_point start, clock::time_point end)
+{
+	std::lock_guard<std::mutex> guard(m_mutex);
+	if (!m_isStopped)
+		m_phases.push_back(Phase{std::move(name), start - m_start, end - start, true});
+}
+
+void PhaseTimer::stop()
+{
+	std::lock_guard<std::mutex> guard(m_mutex);
+	m_isStopped = true;
+}
+
+std::vector<PhaseTimer::Phase> PhaseTimer::getPhases() const
+{
+	std::lock_guard<std::mutex> guard(m_mutex);
+	return m_phases;
+}
+
+void PhaseTimer::report(std::ostream& os) const
+{
+	std::lock_guard<std::mutex> guard(m_mutex);
+
+	const std::ios::fmtflags flags = os.flags();
+	os << std::fixed << std::setprecision(2);
+
+	for (const Phase& phase: m_phases)
+	{
+		os << (phase.concurrent ? "  [bg] " : "       ")
+		   << std::setw(9) << toMilliseconds(phase.start) << " ms +"
+		   << std::setw(9) << toMilliseconds(phase.duration) << " ms  "
+		   << phase.name << std::endl;
+	}
+	os << "total: " << toMilliseconds(m_lastMark - m_start) << " ms" << std::endl;
+
+	os.flags(flags);
+}
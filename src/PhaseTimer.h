@@ -0,0 +1,76 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef PHASE_TIMER_H
+#define PHASE_TIMER_H
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <ostream>
+
+/**
+ * Records the wall clock duration of consecutive phases (e.g. of the startup).
+ * Each mark() ends the current phase. Thread safe, so that background work
+ * can be recorded too (see addConcurrent()). After stop(), nothing more is
+ * recorded, so that work repeated at runtime (e.g. texture reloads) doesn't
+ * grow the list.
+ */
+class PhaseTimer
+{
+public:
+	typedef std::chrono::steady_clock clock;
+
+	struct Phase
+	{
+		std::string name;
+		clock::duration start; // relative to the creation of the timer
+		clock::duration duration;
+		bool concurrent; // ran in the background, not part of the critical path
+	};
+
+	PhaseTimer();
+
+	/**
+	 * End the current phase and start a new one.
+	 */
+	void mark(std::string phaseName);
+
+	/**
+	 * Record work done on another thread.
+	 */
+	void addConcurrent(std::string name, clock::time_point start, clock::time_point end);
+
+	/**
+	 * Stop recording; the later mark() and addConcurrent() calls are ignored.
+	 */
+	void stop();
+
+	std::vector<Phase> getPhases() const;
+	void report(std::ostream& os) const;
+
+private:
+	mutable std::mutex m_mutex;
+	clock::time_point m_start;
+	clock::time_point m_lastMark;
+	std::vector<Phase> m_phases;
+	bool m_isStopped;
+};
+
+#endif // PHASE_TIMER_H
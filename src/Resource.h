@@ -0,0 +1,82 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef RESOURCE_H
+#define RESOURCE_H
+
+#include <string>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Read-only view of a resource's data, either inside the resource archive
+ * or in a loose file. The underlying storage is kept alive by the resource.
+ */
+class Resource
+{
+public:
+	Resource():
+		m_data(nullptr),
+		m_size(0),
+		m_modificationTime(0)
+	{}
+
+	Resource(std::string sourceName, const unsigned char* data, size_t size, int64_t modificationTime, std::shared_ptr<void> storage):
+		m_sourceName(std::move(sourceName)),
+		m_data(data),
+		m_size(size),
+		m_modificationTime(modificationTime),
+		m_storage(std::move(storage))
+	{}
+
+	/**
+	 * Unique name of the resource source, e.g. an absolute path.
+	 */
+	const std::string& getSourceName() const
+	{
+		return m_sourceName;
+	}
+
+	const unsigned char* getData() const
+	{
+		return m_data;
+	}
+
+	size_t getSize() const
+	{
+		return m_size;
+	}
+
+	/**
+	 * Modification time of the file the resource comes from, in nanoseconds.
+	 */
+	int64_t getModificationTime() const
+	{
+		return m_modificationTime;
+	}
+
+private:
+	std::string m_sourceName;
+	const unsigned char* m_data;
+	size_t m_size;
+	int64_t m_modificationTime;
+	std::shared_ptr<void> m_storage;
+};
+
+#endif // RESOURCE_H
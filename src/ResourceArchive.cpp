@@ -0,0 +1,106 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ResourceArchive.h"
+#include "Hash.h"
+
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+	const char ARCHIVE_MAGIC[8] = { 'M', 'G', 'D', 'P', 'A', 'K', '\0', '\0' };
+	const uint32_t ARCHIVE_VERSION = 1;
+
+	/*
+	 * Archive layout (little endian, written by tools/pack-resources.py):
+	 *
+	 * ArchiveHeader
+	 * IndexEntry[entryCount], sorted by (nameHash, name)
+	 * entry names (not terminated)
+	 * entry data, each entry aligned to ENTRY_ALIGNMENT (64) bytes
+	 */
+	struct ArchiveHeader
+	{
+		char magic[8];
+		uint32_t version;
+		uint32_t entryCount;
+	};
+
+	static_assert(sizeof(ArchiveHeader) == 16, "unexpected ArchiveHeader layout");
+	static_assert(sizeof(ResourceArchive::IndexEntry) == 32, "unexpected IndexEntry layout");
+}
+
+ResourceArchive::ResourceArchive(const std::string& fileName):
+	m_fileName(fileName),
+	m_file(std::make_shared<MappedFile>(fileName)),
+	m_index(nullptr),
+	m_entryCount(0)
+{
+	const size_t size = m_file->getSize();
+
+	ArchiveHeader header;
+	if (size < sizeof(header))
+		throw std::runtime_error(std::string("Resource archive ") + fileName + " is truncated");
+
+	std::memcpy(&header, m_file->getData(), sizeof(header));
+	if (std::memcmp(header.magic, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC)) != 0 || header.version != ARCHIVE_VERSION)
+		throw std::runtime_error(std::string("File ") + fileName + " is not a resource archive");
+
+	if (sizeof(header) + static_cast<uint64_t>(header.entryCount) * sizeof(IndexEntry) > size)
+		throw std::runtime_error(std::string("Resource archive ") + fileName + " is truncated");
+
+	// the mapping is page aligned and the index follows the 16 byte header, so this is properly aligned
+	m_index = reinterpret_cast<const IndexEntry*>(m_file->getData() + sizeof(header));
+	m_entryCount = header.entryCount;
+
+	for (uint32_t i = 0; i < m_entryCount; i++)
+	{
+		const IndexEntry& entry = m_index[i];
+		if (static_cast<uint64_t>(entry.nameOffset) + entry.nameLength > size || entry.dataOffset > size
+				|| entry.dataSize > size - entry.dataOffset)
+			throw std::runtime_error(std::string("Resource archive ") + fileName + " has a corrupted index");
+
+		if (i > 0 && m_index[i - 1].nameHash > entry.nameHash)
+			throw std::runtime_error(std::string("Resource archive ") + fileName + " has an unsorted index");
+	}
+}
+
+bool ResourceArchive::find(const std::string& name, Resource& resource) const
+{
+	const uint64_t hash = fnv1a64(name.data(), name.size());
+
+	const IndexEntry* end = m_index + m_entryCount;
+	const IndexEntry* entry = std::lower_bound(m_index, end, hash,
+			[](const IndexEntry& e, uint64_t h) { return e.nameHash < h; });
+
+	// there may be (very unlikely) several entries with the same hash
+	for (; entry != end && entry->nameHash == hash; ++entry)
+	{
+		if (entry->nameLength == name.size()
+				&& std::memcmp(m_file->getData() + entry->nameOffset, name.data(), name.size()) == 0)
+		{
+			resource = Resource(m_fileName + ":" + name, m_file->getData() + entry->dataOffset, entry->dataSize,
+					m_file->getModificationTime(), m_file);
+			return true;
+		}
+	}
+
+	return false;
+}
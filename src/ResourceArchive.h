@@ -0,0 +1,72 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef RESOURCE_ARCHIVE_H
+#define RESOURCE_ARCHIVE_H
+
+#include "Resource.h"
+#include "MappedFile.h"
+
+#include <string>
+#include <memory>
+#include <cstdint>
+
+/**
+ * A packed archive of resources (see tools/pack-resources.py).
+ *
+ * The archive is mapped into memory once. The index is sorted by the
+ * FNV-1a hash of the entry names, so a lookup is a binary search and
+ * the returned resources point directly into the mapping.
+ */
+class ResourceArchive
+{
+public:
+	explicit ResourceArchive(const std::string& fileName);
+
+	/**
+	 * Look up an entry. Returns false if there is no such entry.
+	 */
+	bool find(const std::string& name, Resource& resource) const;
+
+	const std::string& getFileName() const
+	{
+		return m_fileName;
+	}
+
+	uint32_t getEntryCount() const
+	{
+		return m_entryCount;
+	}
+
+	struct IndexEntry
+	{
+		uint64_t nameHash;
+		uint64_t dataOffset;
+		uint64_t dataSize;
+		uint32_t nameOffset;
+		uint32_t nameLength;
+	};
+
+private:
+	std::string m_fileName;
+	std::shared_ptr<MappedFile> m_file;
+	const IndexEntry* m_index;
+	uint32_t m_entryCount;
+};
+
+#endif // RESOURCE_ARCHIVE_H
@@ -0,0 +1,192 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ResourceManager.h"
+
+#include <utility>
+#include <iomanip>
+
+ResourceManager::ResourceManager(std::shared_ptr<AssetPipeline> assets, size_t retainedCount):
+	m_assets(std::move(assets)),
+	m_maxRetainedCount(retainedCount)
+{}
+
+std::shared_ptr<Shader> ResourceManager::getShader(ShaderType type, const std::string& resource)
+{
+	const std::string id = (type == ShaderType::Vertex ? "vertex shader:" : "fragment shader:") + resource;
+
+	return std::static_pointer_cast<Shader>(get(id, [this, type, &resource](size_t& bytes) -> std::shared_ptr<void>
+	{
+		const std::string source = m_assets->getShaderSource(resource);
+		bytes = source.size();
+		return std::make_shared<Shader>(type, source.c_str(), resource);
+	}));
+}
+
+std::shared_ptr<Program> ResourceManager::getProgram(const std::string& vertexShader, const std::string& fragmentShader)
+{
+	const std::string id = "program:" + vertexShader + "|" + fragmentShader;
+
+	return std::static_pointer_cast<Program>(get(id, [this, &vertexShader, &fragmentShader](size_t& bytes) -> std::shared_ptr<void>
+	{
+		// the shaders are kept alive by GL as long as they are attached to the program
+		std::shared_ptr<Program> program = std::make_shared<Program>(*getShader(ShaderType::Vertex, vertexShader),
+				*getShader(ShaderType::Fragment, fragmentShader), vertexShader + "|" + fragmentShader);
+		program->link();
+
+		bytes = 0; // unknown, and small anyway
+		return program;
+	}));
+}
+
+ResourceManager::MemoryUsage ResourceManager::getMemoryUsage() const
+{
+	MemoryUsage usage = {0, 0, 0, 0};
+
+	std::lock_guard<std::mutex> guard(m_mutex);
+	for (const auto& item: m_entries)
+	{
+		const Entry& entry = item.second;
+		if (entry.retained)
+		{
+			usage.retainedBytes += entry.bytes;
+			usage.retainedCount++;
+		}
+		else if (!entry.handle.expired())
+		{
+			usage.liveBytes += entry.bytes;
+			usage.liveCount++;
+		}
+	}
+
+	return usage;
+}
+
+void ResourceManager::report(std::ostream& os) const
+{
+	const MemoryUsage usage = getMemoryUsage();
+	os << "Resources: " << usage.liveCount << " live (" << usage.liveBytes / 1024 << " KiB), "
+	   << usage.retainedCount << " retained (" << usage.retainedBytes / 1024 << " KiB)" << std::endl;
+}
+
+std::shared_ptr<void> ResourceManager::get(const std::string& id, const std::function<std::shared_ptr<void>(size_t& bytes)>& create)
+{
+	std::shared_ptr<std::promise<std::shared_ptr<void>>> promise;
+	std::shared_future<std::shared_ptr<void>> pending;
+
+	{
+		std::lock_guard<std::mutex> guard(m_mutex);
+		Entry& entry = m_entries[id];
+
+		std::shared_ptr<void> handle = entry.handle.lock();
+		if (handle)
+			return handle;
+
+		if (entry.retained)
+		{
+			// released recently, hand it out again
+			m_retainedIds.remove(id);
+			handle = makeHandle(id, std::move(entry.retained));
+			entry.handle = handle;
+			return handle;
+		}
+
+		if (entry.pending.valid())
+			pending = entry.pending;
+		else
+		{
+			promise = std::make_shared<std::promise<std::shared_ptr<void>>>();
+			entry.pending = promise->get_future().share();
+		}
+	}
+
+	if (!promise)
+	{
+		// someone else is already creating the object
+		return pending.get();
+	}
+
+	try
+	{
+		size_t bytes = 0;
+		std::shared_ptr<void> handle = makeHandle(id, create(bytes));
+
+		{
+			std::lock_guard<std::mutex> guard(m_mutex);
+			Entry& entry = m_entries[id];
+			entry.handle = handle;
+			entry.pending = std::shared_future<std::shared_ptr<void>>();
+			entry.bytes = bytes;
+		}
+
+		promise->set_value(handle);
+		return handle;
+	}
+	catch (...)
+	{
+		{
+			std::lock_guard<std::mutex> guard(m_mutex);
+			m_entries.erase(id);
+		}
+
+		promise->set_exception(std::current_exception());
+		throw;
+	}
+}
+
+std::shared_ptr<void> ResourceManager::makeHandle(const std::string& id, std::shared_ptr<void> object)
+{
+	void* p = object.get();
+
+	// the deleter owns the object: when the last handle goes away, the object is passed to release()
+	return std::shared_ptr<void>(p, [this, id, object](void*) mutable
+	{
+		release(id, std::move(object));
+	});
+}
+
+void ResourceManager::release(const std::string& id, std::shared_ptr<void> object)
+{
+	// objects to be destroyed, only after the mutex is unlocked
+	std::shared_ptr<void> evicted;
+
+	std::lock_guard<std::mutex> guard(m_mutex);
+
+	auto it = m_entries.find(id);
+	if (it == m_entries.end() || it->second.retained || !it->second.handle.expired() || m_maxRetainedCount == 0)
+	{
+		// not tracked (anymore) or replaced in the meantime: just destroy it
+		if (it != m_entries.end() && it->second.handle.expired() && !it->second.pending.valid() && !it->second.retained)
+			m_entries.erase(it);
+
+		evicted = std::move(object);
+		return;
+	}
+
+	it->second.retained = std::move(object);
+	m_retainedIds.push_back(id);
+
+	if (m_retainedIds.size() > m_maxRetainedCount)
+	{
+		auto oldest = m_entries.find(m_retainedIds.front());
+		m_retainedIds.pop_front();
+
+		evicted = std::move(oldest->second.retained);
+		m_entries.erase(oldest);
+	}
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef RESOURCE_MANAGER_H
+#define RESOURCE_MANAGER_H
+
+#include "AssetPipeline.h"
+#include "gl/Shader.h"
+#include "gl/Program.h"
+
+#include <string>
+#include <memory>
+#include <map>
+#include <list>
+#include <mutex>
+#include <future>
+#include <functional>
+#include <ostream>
+#include <cstddef>
+
+/**
+ * Shares GL objects (shaders and programs) by resource ID. Textures are owned
+ * by the TextureResidencyManager instead, which keeps them within the GPU
+ * memory budget; retaining them here would hold on to evicted textures.
+ *
+ * Requesting the same ID again returns the same object as long as it is
+ * referenced. Concurrent requests for an ID that is being created wait for
+ * the first request instead of creating the object again. Released objects
+ * are not destroyed right away: the last few are retained so that they can
+ * be handed out again cheaply.
+ *
+ * The manager must outlive all the handles it gives out.
+ */
+class ResourceManager
+{
+public:
+	ResourceManager(std::shared_ptr<AssetPipeline> assets, size_t retainedCount);
+
+	std::shared_ptr<Shader> getShader(ShaderType type, const std::string& resource);
+	std::shared_ptr<Program> getProgram(const std::string& vertexShader, const std::string& fragmentShader);
+
+	struct MemoryUsage
+	{
+		size_t liveBytes; // objects referenced by handles
+		size_t retainedBytes; // released objects kept for reuse
+		unsigned liveCount;
+		unsigned retainedCount;
+	};
+
+	MemoryUsage getMemoryUsage() const;
+	void report(std::ostream& os) const;
+
+private:
+	struct Entry
+	{
+		// the handle given out, the object itself is owned by the handle's deleter (or the retained list)
+		std::weak_ptr<void> handle;
+		std::shared_future<std::shared_ptr<void>> pending;
+		std::shared_ptr<void> retained;
+		size_t bytes;
+	};
+
+	/**
+	 * Get a handle for an ID, creating the object if needed. create() returns the object
+	 * and its estimated memory size.
+	 */
+	std::shared_ptr<void> get(const std::string& id, const std::function<std::shared_ptr<void>(size_t& bytes)>& create);
+	std::shared_ptr<void> makeHandle(const std::string& id, std::shared_ptr<void> object);
+	void release(const std::string& id, std::shared_ptr<void> object);
+
+	std::shared_ptr<AssetPipeline> m_assets;
+	size_t m_maxRetainedCount;
+
+	mutable std::mutex m_mutex;
+	std::map<std::string, Entry> m_entries;
+	std::list<std::string> m_retainedIds; // least recently released first
+};
+
+#endif // RESOURCE_MANAGER_H
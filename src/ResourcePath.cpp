@@ -17,23 +17,159 @@
  * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "ResourcePath.h"
+#include "ResourceArchive.h"
+#include "MappedFile.h"
 
 #include <stdexcept>
 #include <memory>
 #include <iostream>
 #include <cstring>
+#include <cerrno>
+#include <cstdlib>
 #include <unistd.h>
 #include <limits.h>
+#include <sys/stat.h>
 
-static const char MEDIA_PREFIX[] = "media/";
+static const char MEDIA_DIRECTORY[] = "media";
+static const char ARCHIVE_NAME[] = "media.pak";
+
+// set this to use the loose files even if the archive is present (handy while editing the media)
+static const char LOOSE_RESOURCES_ENV[] = "MIRGLESDEMO_LOOSE_RESOURCES";
+
+// must match the application name in manifest.json, confined apps can only write there
+static const char APP_NAME[] = "zub.mirglesdemo";
+
+static std::string getExecutableDirectory()
+{
+	char path[PATH_MAX];
+	const ssize_t len = readlink("/proc/self/exe", path, sizeof(path) - 1);
+	if (len <= 0)
+		return std::string();
+
+	path[len] = 0;
+	char* lastSlash = std::strrchr(path, '/');
+	if (!lastSlash)
+		return std::string();
+
+	return std::string(path, lastSlash);
+}
+
+static bool isDirectory(const std::string& path)
+{
+	struct stat st;
+	return stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+static const std::string& getMediaDirectory()
+{
+	// initialized once, thread safe
+	static const std::string mediaDirectory = []() -> std::string
+	{
+		// prefer the media next to the executable (installed layout) and fall back to the working directory
+		const std::string executableDirectory = getExecutableDirectory();
+		if (!executableDirectory.empty())
+		{
+			std::string path = executableDirectory + "/" + MEDIA_DIRECTORY;
+			if (isDirectory(path))
+				return path;
+		}
+
+		return std::string(MEDIA_DIRECTORY);
+	}();
+
+	return mediaDirectory;
+}
+
+static const ResourceArchive* getArchive()
+{
+	static const std::unique_ptr<ResourceArchive> archive = []() -> std::unique_ptr<ResourceArchive>
+	{
+		std::unique_ptr<ResourceArchive> result;
+
+		if (std::getenv(LOOSE_RESOURCES_ENV))
+			return result;
+
+		const std::string executableDirectory = getExecutableDirectory();
+		if (executableDirectory.empty())
+			return result;
+
+		const std::string archiveFileName = executableDirectory + "/" + ARCHIVE_NAME;
+		if (access(archiveFileName.c_str(), R_OK) != 0)
+			return result; // no archive, e.g. a development build
+
+		try
+		{
+			result.reset(new ResourceArchive(archiveFileName));
+			std::cout << "Using resource archive " << archiveFileName << " (" << result->getEntryCount() << " entries)" << std::endl;
+		}
+		catch (const std::runtime_error& e)
+		{
+			std::cerr << "Can't use resource archive, falling back to loose files: " << e.what() << std::endl;
+		}
+
+		return result;
+	}();
+
+	return archive.get();
+}
 
 std::string getResourcePath(const std::string& resource)
 {
 	std::string result;
 
-	// assume the working directory contains the media inside the media directory
-	result.reserve(sizeof(MEDIA_PREFIX) -1 /* for the 0 terminating byte */+ resource.size());
-	result = MEDIA_PREFIX;
+	const std::string& mediaDirectory = getMediaDirectory();
+	result.reserve(mediaDirectory.size() + 1 + resource.size());
+	result = mediaDirectory;
+	result += '/';
 	result += resource;
 	return result;
 }
+
+Resource openResource(const std::string& resource)
+{
+	Resource result;
+
+	const ResourceArchive* archive = getArchive();
+	if (archive && archive->find(resource, result))
+		return result;
+
+	// loose file
+	const std::string path = getResourcePath(resource);
+	std::unique_ptr<char, decltype(&free)> absolutePath(realpath(path.c_str(), nullptr), free);
+	if (!absolutePath)
+		throw std::runtime_error(std::string("Can't find resource '") + resource + "' (" + path + ": " + std::strerror(errno) + ")");
+
+	std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>(absolutePath.get());
+	return Resource(absolutePath.get(), file->getData(), file->getSize(), file->getModificationTime(), file);
+}
+
+static void makeDirectory(const std::string& path)
+{
+	if (mkdir(path.c_str(), 0700) != 0 && errno != EEXIST)
+		throw std::runtime_error(std::string("Can't create directory ") + path + ": " + std::strerror(errno));
+}
+
+std::string getCacheDirectory()
+{
+	std::string result;
+
+	const char* xdgCacheHome = std::getenv("XDG_CACHE_HOME");
+	if (xdgCacheHome && *xdgCacheHome)
+		result = xdgCacheHome;
+	else
+	{
+		const char* home = std::getenv("HOME");
+		if (!home || !*home)
+			throw std::runtime_error("Can't determine the cache directory: neither XDG_CACHE_HOME nor HOME is set");
+
+		result = home;
+		result += "/.cache";
+	}
+	makeDirectory(result);
+
+	result += "/";
+	result += APP_NAME;
+	makeDirectory(result);
+
+	return result;
+}
@@ -19,8 +19,25 @@
 #ifndef RESOURCE_PATH_H
 #define RESOURCE_PATH_H
 
+#include "Resource.h"
+
 #include <string>
 
+/**
+ * Get the path of the loose file of a resource. Prefer openResource().
+ */
 std::string getResourcePath(const std::string& resource);
 
+/**
+ * Open a resource by name. The resource is looked up in the resource archive
+ * next to the executable first and in the media directory if there's no archive
+ * (or if MIRGLESDEMO_LOOSE_RESOURCES is set).
+ */
+Resource openResource(const std::string& resource);
+
+/**
+ * Get the per-application cache directory. The directory is created if it doesn't exist yet.
+ */
+std::string getCacheDirectory();
+
 #endif // RESOURCE_PATH_H
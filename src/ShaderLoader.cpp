@@ -17,27 +17,8 @@
  * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "ShaderLoader.h"
-#include "gl/Shader.h"
-#include "ResourcePath.h"
 
-#include <stdexcept>
-#include <fstream>
-#include <memory>
-#include <iostream>
-
-std::shared_ptr<Shader> loadShader(ShaderType type, const std::string& fileName)
+std::string readShaderSource(const Resource& resource)
 {
-	std::ifstream shaderFile(fileName);
-	if (!shaderFile.good())
-		throw std::runtime_error(std::string("Can't open shader file '") + fileName + "'");
-
-	shaderFile.seekg(0, shaderFile.end);
-	const size_t shaderSize = shaderFile.tellg();
-	shaderFile.seekg(0, shaderFile.beg);
-
-	std::unique_ptr<char[]> shaderProgram(new char[shaderSize + 1]);
-	shaderFile.read(shaderProgram.get(), shaderSize);
-	shaderProgram[shaderSize] = 0;
-
-	return std::make_shared<Shader>(type, shaderProgram.get());
+	return std::string(reinterpret_cast<const char*>(resource.getData()), resource.getSize());
 }
@@ -19,11 +19,10 @@
 #ifndef SHADER_LOADER_H
 #define SHADER_LOADER_H
 
-#include "gl/Shader.h"
+#include "Resource.h"
 
 #include <string>
-#include <memory>
 
-std::shared_ptr<Shader> loadShader(ShaderType type, const std::string& fileName);
+std::string readShaderSource(const Resource& resource);
 
 #endif // SHADER_LOADER_H
@@ -19,39 +19,31 @@
 
 #include "SwipeGesture.h"
 
-#include <iostream>
+#include "Log.h"
 
-const SwipeGesture::clock::duration SwipeGesture::SWIPE_DURATION = std::chrono::milliseconds(200);
+const std::chrono::milliseconds SwipeGesture::SWIPE_DURATION(200);
 const float SwipeGesture::SWIPE_MIN_LENGTH_SQUARE = 300.0f;
 
-void SwipeGesture::down(float x, float y)
+void SwipeGesture::addSample(const InputSample& sample)
 {
-	if (!m_isDown)
-	{
-		m_isDown = true;
-		m_timeStamp = clock::now();
-		m_x = x;
-		m_y = y;
-	}
-}
+	m_velocityTracker.addSample(sample);
 
-void SwipeGesture::up(float x, float y)
-{
-	if (m_isDown)
+	if (sample.action == InputSample::Action::Up)
 	{
-		const clock::duration dt = clock::now() - m_timeStamp;
-		if (dt < SWIPE_DURATION)
+		glm::vec2 velocity;
+		if (m_velocityTracker.getVelocity(sample.pointerId, velocity))
 		{
-			const float dx = x - m_x;
-			const float dy = y - m_y;
+			const float swipeSeconds = std::chrono::duration<float>(SWIPE_DURATION).count();
+			const float dx = velocity.x * swipeSeconds;
+			const float dy = velocity.y * swipeSeconds;
 
 			if (dx*dx + dy*dy >= SWIPE_MIN_LENGTH_SQUARE)
 			{
-				const float swipeCoeff = static_cast<float>(SWIPE_DURATION.count()) / static_cast<float>(dt.count());
-				std::cout << "SwipeGesture::up: dx=" << dx << ", dy=" << dy << ", swipeCoeff=" << swipeCoeff << std::endl;
-				m_listener.onSwipe(dx * swipeCoeff, dy * swipeCoeff);
+				LOG_DEBUG("SwipeGesture: velocity=" << velocity.x << "," << velocity.y << " px/s");
+				m_listener.onSwipe(dx, dy);
 			}
 		}
-		m_isDown = false;
+
+		m_velocityTracker.reset(sample.pointerId);
 	}
 }
@@ -19,13 +19,22 @@
 #ifndef SWIPE_GESTURE_H
 #define SWIPE_GESTURE_H
 
+#include "InputBatch.h"
+#include "VelocityTracker.h"
+
 #include <chrono>
 
+/**
+ * Recognizes a swipe (fling): the pointer is released while moving fast enough.
+ */
 class SwipeGesture
 {
 public:
 	struct Listener
 	{
+		/**
+		 * dx and dy is the distance the pointer would travel in SWIPE_DURATION at the release velocity.
+		 */
 		virtual void onSwipe(float dx, float dy) = 0;
 	};
 
@@ -33,19 +42,17 @@ public:
 		m_listener(listener)
 	{}
 
-	void down(float x, float y);
-	void up(float x, float y);
+	/**
+	 * Feed all the input samples (not just the coalesced ones) in the order they arrived.
+	 */
+	void addSample(const InputSample& sample);
 
-private:
-	typedef std::chrono::steady_clock clock;
+	static const std::chrono::milliseconds SWIPE_DURATION;
 
+private:
 	Listener& m_listener;
-	bool m_isDown;
-	clock::time_point m_timeStamp;
-	float m_x;
-	float m_y;
+	VelocityTracker m_velocityTracker;
 
-	static const clock::duration SWIPE_DURATION;
 	static const float SWIPE_MIN_LENGTH_SQUARE;
 };
 
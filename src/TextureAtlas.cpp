@@ -0,0 +1,241 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "TextureAtlas.h"
+
+#include <stdexcept>
+#include <algorithm>
+#include <memory>
+#include <cstring>
+
+namespace
+{
+	unsigned alignUp(unsigned value, unsigned alignment)
+	{
+		return alignment > 1 ? (value + alignment - 1) / alignment * alignment : value;
+	}
+}
+
+TextureAtlas::TextureAtlas(unsigned pageWidth, unsigned pageHeight, unsigned gutter):
+	m_pageWidth(pageWidth),
+	m_pageHeight(pageHeight),
+	m_gutter(gutter)
+{}
+
+void TextureAtlas::add(const std::string& name, Image image)
+{
+	if (alignUp(image.getWidth() + 2*m_gutter, m_gutter) > m_pageWidth
+			|| alignUp(image.getHeight() + 2*m_gutter, m_gutter) > m_pageHeight)
+		throw std::runtime_error("TextureAtlas: image " + name + " doesn't fit into an atlas page");
+
+	if (m_regions.find(name) != m_regions.end())
+		throw std::runtime_error("TextureAtlas: image " + name + " added twice");
+
+	m_pending.emplace_back(name, std::move(image));
+}
+
+void TextureAtlas::build()
+{
+	// tallest first gives a flatter skyline
+	std::stable_sort(m_pending.begin(), m_pending.end(),
+			[](const std::pair<std::string, Image>& a, const std::pair<std::string, Image>& b)
+			{
+				return a.second.getHeight() > b.second.getHeight();
+			});
+
+	std::vector<Page> pages(m_pages.size());
+	for (Page& page: pages)
+		page.skyline.push_back(SkylineSegment{0, m_pageHeight, 0}); // existing pages are full
+
+	for (const auto& item: m_pending)
+	{
+		const Image& image = item.second;
+		const unsigned width = alignUp(image.getWidth() + 2*m_gutter, m_gutter);
+		const unsigned height = alignUp(image.getHeight() + 2*m_gutter, m_gutter);
+
+		size_t pageIndex = 0;
+		size_t segmentIndex = 0;
+		unsigned x = 0;
+		unsigned y = 0;
+		while (pageIndex < pages.size() && !findPosition(pages[pageIndex], width, height, segmentIndex, x, y))
+			pageIndex++;
+
+		if (pageIndex == pages.size())
+		{
+			// start a new page
+			Page page;
+			page.skyline.push_back(SkylineSegment{0, 0, m_pageWidth});
+			pages.push_back(std::move(page));
+
+			const size_t pageSize = static_cast<size_t>(m_pageWidth) * m_pageHeight * 4;
+			std::unique_ptr<unsigned char[]> data(new unsigned char[pageSize]);
+			std::memset(data.get(), 0, pageSize);
+			m_pages.emplace_back(m_pageWidth, m_pageHeight, std::move(data), "atlas page");
+
+			findPosition(pages.back(), width, height, segmentIndex, x, y);
+		}
+
+		place(pages[pageIndex], segmentIndex, x, y, width, height);
+
+		Region region;
+		region.page = pageIndex;
+		region.x = x + m_gutter;
+		region.y = y + m_gutter;
+		region.width = image.getWidth();
+		region.height = image.getHeight();
+		region.texCoordMin = glm::vec2(static_cast<float>(region.x) / m_pageWidth,
+				static_cast<float>(region.y) / m_pageHeight);
+		region.texCoordMax = glm::vec2(static_cast<float>(region.x + region.width) / m_pageWidth,
+				static_cast<float>(region.y + region.height) / m_pageHeight);
+
+		blit(m_pages[pageIndex], region, image);
+		m_regions[item.first] = region;
+	}
+
+	m_pending.clear();
+}
+
+const TextureAtlas::Region& TextureAtlas::getRegion(const std::string& name) const
+{
+	auto it = m_regions.find(name);
+	if (it == m_regions.end())
+		throw std::runtime_error("TextureAtlas: no image " + name + " (not added or not built yet)");
+
+	return it->second;
+}
+
+glm::vec2 TextureAtlas::remap(const std::string& name, const glm::vec2& texCoord) const
+{
+	const Region& region = getRegion(name);
+	return glm::vec2(region.texCoordMin.x + texCoord.x * (region.texCoordMax.x - region.texCoordMin.x),
+			region.texCoordMin.y + texCoord.y * (region.texCoordMax.y - region.texCoordMin.y));
+}
+
+void TextureAtlas::remap(const std::string& name, std::vector<glm::vec2>& texCoords) const
+{
+	const Region& region = getRegion(name);
+	const glm::vec2 size(region.texCoordMax.x - region.texCoordMin.x, region.texCoordMax.y - region.texCoordMin.y);
+
+	for (glm::vec2& texCoord: texCoords)
+		texCoord = glm::vec2(region.texCoordMin.x + texCoord.x * size.x, region.texCoordMin.y + texCoord.y * size.y);
+}
+
+std::vector<Image> TextureAtlas::takePages()
+{
+	std::vector<Image> pages = std::move(m_pages);
+	m_pages.clear();
+	return pages;
+}
+
+bool TextureAtlas::findPosition(const Page& page, unsigned width, unsigned height, size_t& segmentIndex, unsigned& x, unsigned& y) const
+{
+	bool found = false;
+	unsigned bestBottom = 0;
+	unsigned bestX = 0;
+
+	for (size_t i = 0; i < page.skyline.size(); i++)
+	{
+		const unsigned left = page.skyline[i].x;
+		if (left + width > m_pageWidth)
+			break;
+
+		// the image rests on the highest segment below it
+		unsigned top = 0;
+		unsigned covered = 0;
+		for (size_t j = i; j < page.skyline.size() && covered < width; j++)
+		{
+			top = std::max(top, page.skyline[j].y);
+			covered += page.skyline[j].width;
+		}
+
+		if (top + height > m_pageHeight)
+			continue;
+
+		// bottom-left: the lowest resulting top edge wins, then the leftmost position
+		if (!found || top + height < bestBottom || (top + height == bestBottom && left < bestX))
+		{
+			found = true;
+			bestBottom = top + height;
+			bestX = left;
+			segmentIndex = i;
+			x = left;
+			y = top;
+		}
+	}
+
+	return found;
+}
+
+void TextureAtlas::place(Page& page, size_t segmentIndex, unsigned x, unsigned y, unsigned width, unsigned height)
+{
+	std::vector<SkylineSegment>& skyline = page.skyline;
+	skyline.insert(skyline.begin() + segmentIndex, SkylineSegment{x, y + height, width});
+
+	// cut away the parts of the following segments covered by the new one
+	const unsigned right = x + width;
+	size_t i = segmentIndex + 1;
+	while (i < skyline.size() && skyline[i].x < right)
+	{
+		const unsigned segmentRight = skyline[i].x + skyline[i].width;
+		if (segmentRight <= right)
+			skyline.erase(skyline.begin() + i);
+		else
+		{
+			skyline[i].width = segmentRight - right;
+			skyline[i].x = right;
+			break;
+		}
+	}
+
+	// merge neighbours at the same height
+	for (i = 0; i + 1 < skyline.size(); )
+	{
+		if (skyline[i].y == skyline[i + 1].y)
+		{
+			skyline[i].width += skyline[i + 1].width;
+			skyline.erase(skyline.begin() + i + 1);
+		}
+		else
+			i++;
+	}
+}
+
+void TextureAtlas::blit(Image& page, const Region& region, const Image& image) const
+{
+	const int gutter = m_gutter;
+	const int width = image.getWidth();
+	const int height = image.getHeight();
+	const size_t pageRowSize = static_cast<size_t>(page.getWidth()) * 4;
+	const size_t imageRowSize = static_cast<size_t>(width) * 4;
+
+	// copy the image including the gutter; the gutter repeats the edge pixels
+	for (int sy = -gutter; sy < height + gutter; sy++)
+	{
+		const unsigned char* src = image.getData() + std::min(std::max(sy, 0), height - 1) * imageRowSize;
+		unsigned char* dst = page.getData() + (region.y + sy) * pageRowSize + (region.x - gutter) * 4;
+
+		for (int sx = -gutter; sx < 0; sx++, dst += 4)
+			std::memcpy(dst, src, 4);
+
+		std::memcpy(dst, src, imageRowSize);
+		dst += imageRowSize;
+
+		for (int sx = 0; sx < gutter; sx++, dst += 4)
+			std::memcpy(dst, src + imageRowSize - 4, 4);
+	}
+}
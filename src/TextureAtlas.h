@@ -0,0 +1,115 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef TEXTURE_ATLAS_H
+#define TEXTURE_ATLAS_H
+
+#include "Image.h"
+
+#include <glm/glm.hpp>
+
+#include <string>
+#include <vector>
+#include <map>
+
+/**
+ * Packs many small images into a few large atlas pages so that objects using
+ * different images can share a texture (less texture binds, larger draw batches).
+ *
+ * Usage: add() all the images, build() the pages, create a texture for each page
+ * and remap the texture coordinates of the meshes using the images.
+ *
+ * The images are packed with the skyline bottom-left heuristic, tallest first.
+ * Each image is surrounded by a gutter made of copies of its edge pixels, so
+ * that bilinear filtering doesn't bleed the neighbours in. The image positions
+ * are aligned to the gutter size; with a gutter of 2^k pixels the first k mipmap
+ * levels stay clean too.
+ */
+class TextureAtlas
+{
+public:
+	struct Region
+	{
+		unsigned page;
+		// position of the image in the page, in pixels (without the gutter)
+		unsigned x;
+		unsigned y;
+		unsigned width;
+		unsigned height;
+		// texture coordinates of the image corners
+		glm::vec2 texCoordMin;
+		glm::vec2 texCoordMax;
+	};
+
+	TextureAtlas(unsigned pageWidth, unsigned pageHeight, unsigned gutter);
+
+	/**
+	 * Add an image to be packed. The image must fit into a page (including the gutter).
+	 */
+	void add(const std::string& name, Image image);
+
+	/**
+	 * Pack all the added images into pages.
+	 */
+	void build();
+
+	const Region& getRegion(const std::string& name) const;
+
+	/**
+	 * Map texture coordinates relative to the original image to coordinates in its atlas page.
+	 */
+	glm::vec2 remap(const std::string& name, const glm::vec2& texCoord) const;
+	void remap(const std::string& name, std::vector<glm::vec2>& texCoords) const;
+
+	const std::vector<Image>& getPages() const
+	{
+		return m_pages;
+	}
+
+	/**
+	 * Take the built pages, e.g. to create textures from them.
+	 */
+	std::vector<Image> takePages();
+
+private:
+	struct SkylineSegment
+	{
+		unsigned x;
+		unsigned y;
+		unsigned width;
+	};
+
+	struct Page
+	{
+		std::vector<SkylineSegment> skyline;
+	};
+
+	bool findPosition(const Page& page, unsigned width, unsigned height, size_t& segmentIndex, unsigned& x, unsigned& y) const;
+	void place(Page& page, size_t segmentIndex, unsigned x, unsigned y, unsigned width, unsigned height);
+	void blit(Image& page, const Region& region, const Image& image) const;
+
+	unsigned m_pageWidth;
+	unsigned m_pageHeight;
+	unsigned m_gutter;
+
+	std::vector<std::pair<std::string, Image>> m_pending;
+	std::map<std::string, Region> m_regions;
+	std::vector<Image> m_pages;
+};
+
+#endif // TEXTURE_ATLAS_H
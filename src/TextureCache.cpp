@@ -0,0 +1,317 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "TextureCache.h"
+#include "PNGLoader.h"
+#include "MipmapGenerator.h"
+#include "MappedFile.h"
+#include "Hash.h"
+
+#include <stdexcept>
+#include <memory>
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <cerrno>
+
+#include <unistd.h>
+
+namespace
+{
+	const char CACHE_MAGIC[8] = { 'M', 'G', 'D', 'T', 'E', 'X', '\0', '\0' };
+	const uint32_t CACHE_VERSION = 1;
+	const uint32_t FORMAT_RGBA8888 = 1;
+
+	// level data (and the level table) are aligned so that they can be handed to GL directly
+	const size_t PAYLOAD_ALIGNMENT = 16;
+
+	/*
+	 * Cache file layout (native byte order, the cache is never shared between machines):
+	 *
+	 * CacheHeader
+	 * source name (sourceNameLength bytes, not terminated)
+	 * padding to PAYLOAD_ALIGNMENT
+	 * CacheLevel[levelCount]
+	 * padding to PAYLOAD_ALIGNMENT
+	 * level data, each level starts at a PAYLOAD_ALIGNMENT boundary
+	 */
+	struct CacheHeader
+	{
+		char magic[8];
+		uint32_t version;
+		uint32_t format;
+		uint64_t sourceSize;
+		int64_t sourceMTime; // nanoseconds
+		uint64_t sourceHash;
+		uint32_t sourceNameLength;
+		uint32_t levelCount;
+	};
+
+	struct CacheLevel
+	{
+		uint32_t width;
+		uint32_t height;
+		uint64_t offset;
+	};
+
+	size_t align(size_t offset)
+	{
+		return (offset + PAYLOAD_ALIGNMENT - 1) / PAYLOAD_ALIGNMENT * PAYLOAD_ALIGNMENT;
+	}
+
+	/**
+	 * Map a cache file and check that it is sane and belongs to sourceName.
+	 * Returns null if there is no usable cache file.
+	 */
+	std::shared_ptr<MappedFile> openCacheFile(const std::string& cacheFileName, const std::string& sourceName, CacheHeader& header)
+	{
+		if (access(cacheFileName.c_str(), R_OK) != 0)
+			return nullptr;
+
+		std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>(cacheFileName);
+		const size_t size = file->getSize();
+		if (size < sizeof(header))
+			return nullptr;
+
+		std::memcpy(&header, file->getData(), sizeof(header));
+		if (std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 || header.version != CACHE_VERSION
+				|| header.format != FORMAT_RGBA8888 || header.levelCount == 0)
+			return nullptr;
+
+		// guard against a (very unlikely) collision of the name hashes
+		if (sizeof(header) + header.sourceNameLength > size || header.sourceNameLength != sourceName.size()
+				|| std::memcmp(file->getData() + sizeof(header), sourceName.data(), sourceName.size()) != 0)
+			return nullptr;
+
+		return file;
+	}
+
+	/**
+	 * Create images pointing directly into the mapped cache file.
+	 */
+	std::vector<Image> mapLevels(const std::shared_ptr<MappedFile>& file, const CacheHeader& header)
+	{
+		const size_t levelTableOffset = align(sizeof(header) + header.sourceNameLength);
+		if (levelTableOffset + header.levelCount * sizeof(CacheLevel) > file->getSize())
+			throw std::runtime_error("Truncated texture cache file.");
+
+		std::vector<Image> levels;
+		levels.reserve(header.levelCount);
+
+		for (uint32_t i = 0; i < header.levelCount; i++)
+		{
+			CacheLevel level;
+			std::memcpy(&level, file->getData() + levelTableOffset + i * sizeof(level), sizeof(level));
+
+			const uint64_t levelSize = static_cast<uint64_t>(level.width) * level.height * 4;
+			if (level.offset % PAYLOAD_ALIGNMENT != 0 || level.offset + levelSize > file->getSize())
+				throw std::runtime_error("Truncated texture cache file.");
+
+			levels.emplace_back(level.width, level.height, file->getData() + level.offset, file);
+		}
+
+		return levels;
+	}
+
+	void writePadding(FILE* file, size_t& offset)
+	{
+		static const char zeros[PAYLOAD_ALIGNMENT] = {};
+		const size_t aligned = align(offset);
+		if (std::fwrite(zeros, 1, aligned - offset, file) != aligned - offset)
+			throw std::runtime_error("Can't write texture cache file.");
+
+		offset = aligned;
+	}
+
+	void write(FILE* file, const void* data, size_t size, size_t& offset)
+	{
+		if (std::fwrite(data, 1, size, file) != size)
+			throw std::runtime_error("Can't write texture cache file.");
+
+		offset += size;
+	}
+
+	void writeCacheFile(const std::string& cacheFileName, const Resource& source, uint64_t sourceHash, const std::vector<Image>& levels)
+	{
+		// write a temporary file first so that a crash can't leave a half-written cache file behind
+		// (unique name: the same texture may be written by several threads at once)
+		std::string tmpFileName = cacheFileName + ".XXXXXX";
+		const int fd = mkstemp(&tmpFileName[0]);
+		if (fd < 0)
+			throw std::runtime_error(std::string("Can't create file ") + tmpFileName + ": " + std::strerror(errno));
+
+		{
+			std::unique_ptr<FILE,decltype(&fclose)> file(fdopen(fd, "wb"), fclose);
+			if (!file)
+			{
+				close(fd);
+				std::remove(tmpFileName.c_str());
+				throw std::runtime_error(std::string("Can't open file ") + tmpFileName);
+			}
+
+			CacheHeader header;
+			std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+			header.version = CACHE_VERSION;
+			header.format = FORMAT_RGBA8888;
+			header.sourceSize = source.getSize();
+			header.sourceMTime = source.getModificationTime();
+			header.sourceHash = sourceHash;
+			header.sourceNameLength = source.getSourceName().size();
+			header.levelCount = levels.size();
+
+			size_t offset = 0;
+			write(file.get(), &header, sizeof(header), offset);
+			write(file.get(), source.getSourceName().data(), source.getSourceName().size(), offset);
+			writePadding(file.get(), offset);
+
+			// compute the level offsets first
+			size_t dataOffset = align(offset + levels.size() * sizeof(CacheLevel));
+			for (const Image& image: levels)
+			{
+				CacheLevel level;
+				level.width = image.getWidth();
+				level.height = image.getHeight();
+				level.offset = dataOffset;
+				write(file.get(), &level, sizeof(level), offset);
+
+				dataOffset = align(dataOffset + image.getSize());
+			}
+
+			for (const Image& image: levels)
+			{
+				writePadding(file.get(), offset);
+				write(file.get(), image.getData(), image.getSize(), offset);
+			}
+
+			if (std::fflush(file.get()) != 0)
+				throw std::runtime_error(std::string("Can't write file ") + tmpFileName);
+		}
+
+		if (std::rename(tmpFileName.c_str(), cacheFileName.c_str()) != 0)
+		{
+			std::remove(tmpFileName.c_str());
+			throw std::runtime_error(std::string("Can't rename ") + tmpFileName + " to " + cacheFileName);
+		}
+	}
+
+	void updateCacheTimeStamp(const std::string& cacheFileName, int64_t mtime)
+	{
+		std::unique_ptr<FILE,decltype(&fclose)> file(std::fopen(cacheFileName.c_str(), "r+b"), fclose);
+		if (!file || std::fseek(file.get(), offsetof(CacheHeader, sourceMTime), SEEK_SET) != 0
+				|| std::fwrite(&mtime, sizeof(mtime), 1, file.get()) != 1)
+			throw std::runtime_error(std::string("Can't update file ") + cacheFileName);
+	}
+}
+
+TextureCache::TextureCache(std::string directory, bool storeMipmaps):
+	m_directory(std::move(directory)),
+	m_storeMipmaps(storeMipmaps),
+	m_hitCount(0),
+	m_missCount(0)
+{}
+
+std::vector<Image> TextureCache::load(const Resource& resource)
+{
+	if (!isEnabled())
+	{
+		m_missCount++;
+		return decode(resource);
+	}
+
+	const std::string& sourceName = resource.getSourceName();
+	const std::string cacheFileName = getCacheFileName(sourceName);
+
+	bool haveSourceHash = false;
+	uint64_t sourceHash = 0;
+
+	try
+	{
+		CacheHeader header;
+		std::shared_ptr<MappedFile> cacheFile = openCacheFile(cacheFileName, sourceName, header);
+		if (cacheFile && header.sourceSize == resource.getSize())
+		{
+			bool isValid = header.sourceMTime == resource.getModificationTime();
+			if (!isValid)
+			{
+				// the file has been touched (or reinstalled), but may be still the same
+				sourceHash = fnv1a64(resource.getData(), resource.getSize());
+				haveSourceHash = true;
+
+				if (sourceHash == header.sourceHash)
+				{
+					isValid = true;
+					updateCacheTimeStamp(cacheFileName, resource.getModificationTime());
+				}
+			}
+
+			if (isValid)
+			{
+				// even if the cache has been built with the other m_storeMipmaps setting, the data is usable
+				std::vector<Image> levels = mapLevels(cacheFile, header);
+				m_hitCount++;
+				return levels;
+			}
+		}
+	}
+	catch (const std::runtime_error& e)
+	{
+		// a broken cache is not fatal, just decode the source again
+		std::cerr << "TextureCache: ignoring cache file " << cacheFileName << ": " << e.what() << std::endl;
+	}
+
+	m_missCount++;
+
+	if (!haveSourceHash)
+		sourceHash = fnv1a64(resource.getData(), resource.getSize());
+
+	std::vector<Image> levels = decode(resource);
+
+	try
+	{
+		writeCacheFile(cacheFileName, resource, sourceHash, levels);
+	}
+	catch (const std::runtime_error& e)
+	{
+		std::cerr << "TextureCache: can't store " << sourceName << " in the cache: " << e.what() << std::endl;
+	}
+
+	return levels;
+}
+
+std::vector<Image> TextureCache::decode(const Resource& resource) const
+{
+	Image image = loadPNG(resource.getData(), resource.getSize(), resource.getSourceName());
+
+	std::vector<Image> levels;
+	if (m_storeMipmaps)
+		levels = generateMipmaps(std::move(image));
+	else
+		levels.push_back(std::move(image));
+
+	return levels;
+}
+
+std::string TextureCache::getCacheFileName(const std::string& sourceName) const
+{
+	char name[32];
+	std::snprintf(name, sizeof(name), "/%016llx.tex", static_cast<unsigned long long>(fnv1a64(sourceName.data(), sourceName.size())));
+	return m_directory + name;
+}
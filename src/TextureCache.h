@@ -0,0 +1,81 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef TEXTURE_CACHE_H
+#define TEXTURE_CACHE_H
+
+#include "Image.h"
+#include "Resource.h"
+
+#include <string>
+#include <vector>
+#include <atomic>
+
+/**
+ * Persistent cache of decoded images.
+ *
+ * Decoded pixels are stored in a raw file (a small header followed by the
+ * GPU-ready RGBA data of all levels) that is simply mapped into memory on
+ * the next load. A cache entry is keyed by the resource source name and is
+ * valid as long as the source size and modification time match. If only
+ * the modification time differs, the content hash decides.
+ *
+ * load() can be called from several threads at once.
+ */
+class TextureCache
+{
+public:
+	/**
+	 * @param directory Directory holding the cache files. If empty, the cache is disabled and
+	 * load() always decodes the resource.
+	 * @param storeMipmaps If true, the whole mipmap chain is computed once and stored too.
+	 */
+	TextureCache(std::string directory, bool storeMipmaps);
+
+	/**
+	 * Load a PNG image, either from the cache or by decoding the resource.
+	 * Returns the base level followed by the mipmap levels (if enabled).
+	 */
+	std::vector<Image> load(const Resource& resource);
+
+	unsigned getHitCount() const
+	{
+		return m_hitCount;
+	}
+
+	unsigned getMissCount() const
+	{
+		return m_missCount;
+	}
+
+	bool isEnabled() const
+	{
+		return !m_directory.empty();
+	}
+
+private:
+	std::vector<Image> decode(const Resource& resource) const;
+	std::string getCacheFileName(const std::string& sourceName) const;
+
+	std::string m_directory;
+	bool m_storeMipmaps;
+	std::atomic<unsigned> m_hitCount;
+	std::atomic<unsigned> m_missCount;
+};
+
+#endif // TEXTURE_CACHE_H
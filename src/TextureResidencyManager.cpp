@@ -0,0 +1,126 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "TextureResidencyManager.h"
+#include "Log.h"
+
+#include <stdexcept>
+#include <iostream>
+
+TextureResidencyManager::TextureResidencyManager(size_t budgetBytes, unsigned minIdleFrames):
+	m_budgetBytes(budgetBytes),
+	m_minIdleFrames(minIdleFrames),
+	m_frame(0),
+	m_residentBytes(0),
+	m_evictedBytes(0),
+	m_evictionCount(0),
+	m_reloadCount(0)
+{}
+
+TextureResidencyManager::TextureId TextureResidencyManager::add(std::string name, Loader loader)
+{
+	Entry entry;
+	entry.name = std::move(name);
+	entry.loader = std::move(loader);
+	entry.bytes = 0;
+	entry.lastUsedFrame = 0;
+	entry.wasEvicted = false;
+
+	m_entries.push_back(std::move(entry));
+	return m_entries.size() - 1;
+}
+
+const Texture2D& TextureResidencyManager::use(TextureId id)
+{
+	if (id >= m_entries.size())
+		throw std::runtime_error("TextureResidencyManager::use: invalid texture id " + std::to_string(id));
+
+	Entry& entry = m_entries[id];
+	entry.lastUsedFrame = m_frame;
+
+	if (entry.texture)
+	{
+		// move to the most recently used end
+		m_lru.splice(m_lru.end(), m_lru, entry.lruPosition);
+		return *entry.texture;
+	}
+
+	// make room first so that the old and the new textures don't have to fit at the same time
+	evictToFit(entry.bytes);
+
+	entry.texture = entry.loader();
+	if (!entry.texture)
+		throw std::runtime_error("TextureResidencyManager: can't load texture " + entry.name);
+
+	if (entry.wasEvicted)
+	{
+		m_evictedBytes -= entry.bytes;
+		entry.wasEvicted = false;
+		m_reloadCount++;
+		LOG_INFO("TextureResidencyManager: reloaded " << entry.name);
+	}
+
+	entry.bytes = entry.texture->getMemorySize();
+	m_residentBytes += entry.bytes;
+	entry.lruPosition = m_lru.insert(m_lru.end(), id);
+
+	return *entry.texture;
+}
+
+void TextureResidencyManager::endFrame()
+{
+	evictToFit(0);
+	m_frame++;
+}
+
+void TextureResidencyManager::report(std::ostream& os) const
+{
+	os << "Textures: " << m_lru.size() << " resident (" << m_residentBytes / 1024 << " KiB of "
+	   << m_budgetBytes / 1024 << " KiB budget), " << m_evictedBytes / 1024 << " KiB evicted, "
+	   << m_evictionCount << " evictions, " << m_reloadCount << " reloads" << std::endl;
+}
+
+void TextureResidencyManager::evict(Entry& entry)
+{
+	LOG_INFO("TextureResidencyManager: evicting " << entry.name << " (" << entry.bytes / 1024 << " KiB)");
+
+	m_lru.erase(entry.lruPosition);
+	entry.texture.reset();
+	entry.wasEvicted = true;
+
+	m_residentBytes -= entry.bytes;
+	m_evictedBytes += entry.bytes;
+	m_evictionCount++;
+}
+
+void TextureResidencyManager::evictToFit(size_t extraBytes)
+{
+	auto it = m_lru.begin();
+	while (m_residentBytes + extraBytes > m_budgetBytes && it != m_lru.end())
+	{
+		Entry& entry = m_entries[*it];
+
+		// the list is ordered by last use, so all the remaining textures have been used recently too
+		// (textures used in the current frame are never evicted, references to them may be still in use)
+		if (entry.lastUsedFrame == m_frame || entry.lastUsedFrame + m_minIdleFrames > m_frame)
+			break;
+
+		++it;
+		evict(entry);
+	}
+}
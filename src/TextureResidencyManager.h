@@ -0,0 +1,112 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef TEXTURE_RESIDENCY_MANAGER_H
+#define TEXTURE_RESIDENCY_MANAGER_H
+
+#include "gl/Texture.h"
+
+#include <string>
+#include <vector>
+#include <list>
+#include <memory>
+#include <functional>
+#include <ostream>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Keeps the GPU memory held by textures within a budget.
+ *
+ * Textures are registered with a loader and made resident on use. When the
+ * resident textures exceed the budget, the least recently used ones that have
+ * not been used for a while are evicted (the GL texture is deleted). An evicted
+ * texture is reloaded by its loader the next time it is used.
+ *
+ * Must only be used from the GL thread.
+ */
+class TextureResidencyManager
+{
+public:
+	typedef size_t TextureId;
+	typedef std::function<std::shared_ptr<Texture2D>()> Loader;
+
+	/**
+	 * @param budgetBytes Maximum GPU memory of the resident textures (soft limit, textures
+	 * used recently are never evicted).
+	 * @param minIdleFrames Only textures not used for at least this many frames can be evicted.
+	 */
+	TextureResidencyManager(size_t budgetBytes, unsigned minIdleFrames);
+
+	/**
+	 * Register a texture. It is not loaded until it's used.
+	 */
+	TextureId add(std::string name, Loader loader);
+
+	/**
+	 * Make the texture resident (reload it if needed) and mark it as used in the current frame.
+	 * The returned reference is valid until the next endFrame().
+	 */
+	const Texture2D& use(TextureId id);
+
+	/**
+	 * Finish a frame: evict textures if over budget.
+	 */
+	void endFrame();
+
+	size_t getResidentBytes() const
+	{
+		return m_residentBytes;
+	}
+
+	size_t getEvictedBytes() const
+	{
+		return m_evictedBytes;
+	}
+
+	void report(std::ostream& os) const;
+
+private:
+	struct Entry
+	{
+		std::string name;
+		Loader loader;
+		std::shared_ptr<Texture2D> texture;
+		size_t bytes; // size when last resident
+		uint64_t lastUsedFrame;
+		bool wasEvicted;
+		std::list<TextureId>::iterator lruPosition; // valid only when resident
+	};
+
+	void evict(Entry& entry);
+	void evictToFit(size_t extraBytes);
+
+	size_t m_budgetBytes;
+	unsigned m_minIdleFrames;
+	uint64_t m_frame;
+
+	std::vector<Entry> m_entries;
+	std::list<TextureId> m_lru; // resident textures, least recently used first
+
+	size_t m_residentBytes;
+	size_t m_evictedBytes;
+	unsigned m_evictionCount;
+	unsigned m_reloadCount;
+};
+
+#endif // TEXTURE_RESIDENCY_MANAGER_H
@@ -0,0 +1,160 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "TouchPredictor.h"
+
+#include <algorithm>
+
+namespace
+{
+	// never extrapolate further than this from the last sample (e.g. when the pointer stopped moving), in ns
+	const int64_t MAX_EXTRAPOLATION = 100000000;
+
+	// a moving pointer reports at least at 60 Hz; without a sample for this long it's likely held still, in ns
+	const int64_t STILL_TIME = 33000000;
+	// then the extrapolation fades out over this time, so that the prediction settles at the last position, in ns
+	const int64_t STILL_FADE_TIME = 33000000;
+
+	/** How much of the extrapolation to keep when the newest sample is age ns old. */
+	float getStillFactor(int64_t age)
+	{
+		if (age <= STILL_TIME)
+			return 1.0f;
+		if (age >= STILL_TIME + STILL_FADE_TIME)
+			return 0.0f;
+		return 1.0f - static_cast<float>(age - STILL_TIME) / STILL_FADE_TIME;
+	}
+}
+
+TouchPredictor::TouchPredictor(int64_t horizon, float maxOvershoot, bool measure):
+	m_horizon(horizon),
+	m_maxOvershoot(maxOvershoot),
+	m_measure(measure),
+	m_pendingCount(0),
+	m_measuredCount(0),
+	m_predictedErrorSum(0),
+	m_lastKnownErrorSum(0),
+	m_predictedErrorMax(0),
+	m_lastKnownErrorMax(0)
+{
+}
+
+void TouchPredictor::addSample(const InputSample& sample)
+{
+	if (m_measure)
+		measure(sample);
+
+	m_velocityTracker.addSample(sample);
+
+	if (sample.action == InputSample::Action::Up)
+		m_velocityTracker.reset(sample.pointerId);
+}
+
+bool TouchPredictor::predict(int32_t pointerId, int64_t frameTime, glm::vec2& predictedOffset)
+{
+	glm::vec2 lastPosition;
+	int64_t lastTime;
+	if (!m_velocityTracker.getLastSample(pointerId, lastPosition, lastTime))
+		return false;
+
+	glm::vec2 predicted = lastPosition;
+
+	glm::vec2 velocity;
+	glm::vec2 acceleration;
+	if (m_velocityTracker.getMotion(pointerId, velocity, acceleration))
+	{
+		const int64_t targetTime = frameTime + m_horizon;
+		const float dt = std::min(std::max<int64_t>(targetTime - lastTime, 0), MAX_EXTRAPOLATION) * 1e-9f;
+		glm::vec2 offset = velocity * dt + 0.5f * acceleration * (dt * dt);
+
+		// acceleration estimates are noisy, don't let the prediction run away
+		const float distance = glm::length(offset);
+		if (distance > m_maxOvershoot)
+			offset *= m_maxOvershoot / distance;
+
+		// the velocity of the last samples stays until a new one arrives, don't keep extrapolating with it
+		offset *= getStillFactor(frameTime - lastTime);
+
+		predicted = lastPosition + offset;
+
+		if (m_measure && m_pendingCount < MAX_PENDING_PREDICTIONS)
+			m_pending[m_pendingCount++] = PendingPrediction{pointerId, targetTime, predicted, lastPosition};
+	}
+
+	predictedOffset = predicted - lastPosition;
+	return true;
+}
+
+void TouchPredictor::measure(const InputSample& sample)
+{
+	glm::vec2 lastPosition;
+	int64_t lastTime;
+	const bool hasLast = sample.action != InputSample::Action::Down
+			&& m_velocityTracker.getLastSample(sample.pointerId, lastPosition, lastTime);
+
+	const glm::vec2 position(sample.x, sample.y);
+
+	size_t kept = 0;
+	for (size_t i = 0; i < m_pendingCount; i++)
+	{
+		const PendingPrediction& prediction = m_pending[i];
+		if (prediction.pointerId != sample.pointerId || prediction.targetTime > sample.eventTime)
+		{
+			m_pending[kept++] = prediction;
+			continue;
+		}
+
+		// the pointer went down again: there's nothing to compare with
+		if (!hasLast)
+			continue;
+
+		// the actual position at the target time, interpolated between the samples around it
+		glm::vec2 actual = position;
+		if (sample.eventTime > lastTime)
+		{
+			const float f = static_cast<float>(std::max(prediction.targetTime - lastTime, int64_t(0)))
+					/ static_cast<float>(sample.eventTime - lastTime);
+			actual = lastPosition + (position - lastPosition) * std::min(f, 1.0f);
+		}
+
+		const float predictedError = glm::length(prediction.predicted - actual);
+		const float lastKnownError = glm::length(prediction.lastKnown - actual);
+
+		m_measuredCount++;
+		m_predictedErrorSum += predictedError;
+		m_lastKnownErrorSum += lastKnownError;
+		m_predictedErrorMax = std::max(m_predictedErrorMax, predictedError);
+		m_lastKnownErrorMax = std::max(m_lastKnownErrorMax, lastKnownError);
+	}
+	m_pendingCount = kept;
+}
+
+void TouchPredictor::report(std::ostream& os) const
+{
+	if (!m_measure)
+		return;
+
+	os << "Touch prediction: " << m_measuredCount << " predictions measured";
+	if (m_measuredCount > 0)
+	{
+		os << ", error " << m_predictedErrorSum / m_measuredCount << " px mean, " << m_predictedErrorMax
+		   << " px max; without prediction " << m_lastKnownErrorSum / m_measuredCount << " px mean, "
+		   << m_lastKnownErrorMax << " px max";
+	}
+	os << std::endl;
+}
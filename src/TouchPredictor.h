@@ -0,0 +1,95 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef TOUCH_PREDICTOR_H
+#define TOUCH_PREDICTOR_H
+
+#include "InputBatch.h"
+#include "VelocityTracker.h"
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <ostream>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Extrapolates the position of a pointer to the time a frame is expected to be
+ * presented, from its recent velocity and acceleration.
+ *
+ * Optionally measures the prediction error: each prediction is compared with
+ * the actual position at the predicted time (interpolated from the samples that
+ * arrive later), and so is the last known position the frame would use otherwise.
+ */
+class TouchPredictor
+{
+public:
+	/**
+	 * @param horizon How far ahead of the frame time to predict (the expected frame to photon time), in ns.
+	 * @param maxOvershoot Maximal distance (in pixels) of the prediction from the last known position.
+	 * @param measure Measure the prediction error.
+	 */
+	TouchPredictor(int64_t horizon, float maxOvershoot, bool measure);
+
+	/**
+	 * Feed all the input samples in the order they arrived.
+	 */
+	void addSample(const InputSample& sample);
+
+	/**
+	 * Predict where the pointer is going to be at frameTime + horizon.
+	 * If no sample arrived for a while (the pointer is held still), the prediction fades
+	 * out to the last known position.
+	 * @param offset The predicted position relative to the last known one.
+	 * @return False if the pointer isn't known, offset is not changed then.
+	 */
+	bool predict(int32_t pointerId, int64_t frameTime, glm::vec2& offset);
+
+	void report(std::ostream& os) const;
+
+private:
+	struct PendingPrediction
+	{
+		int32_t pointerId;
+		int64_t targetTime;
+		glm::vec2 predicted;
+		glm::vec2 lastKnown;
+	};
+
+	void measure(const InputSample& sample);
+
+	static const size_t MAX_PENDING_PREDICTIONS = 16;
+
+	int64_t m_horizon;
+	float m_maxOvershoot;
+	bool m_measure;
+
+	VelocityTracker m_velocityTracker;
+
+	// measurement
+	std::array<PendingPrediction, MAX_PENDING_PREDICTIONS> m_pending;
+	size_t m_pendingCount;
+	uint64_t m_measuredCount;
+	double m_predictedErrorSum;
+	double m_lastKnownErrorSum;
+	float m_predictedErrorMax;
+	float m_lastKnownErrorMax;
+};
+
+#endif // TOUCH_PREDICTOR_H
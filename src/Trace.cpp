@@ -0,0 +1,171 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "Trace.h"
+#include "Json.h"
+
+#ifdef MIRGLESDEMO_TRACING
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <stdexcept>
+#include <cstdio>
+
+namespace
+{
+	// events per thread, the rest is dropped
+	const size_t THREAD_BUFFER_SIZE = 64 * 1024;
+
+	struct Event
+	{
+		const char* name;
+		int64_t start;
+		int64_t end;
+	};
+
+	/**
+	 * Written only by its thread; the writer publishes each event by incrementing count.
+	 */
+	struct ThreadBuffer
+	{
+		explicit ThreadBuffer(unsigned threadId):
+			id(threadId),
+			events(new Event[THREAD_BUFFER_SIZE]),
+			count(0),
+			droppedCount(0)
+		{}
+
+		const unsigned id;
+		std::string name; // protected by the registry mutex
+		std::unique_ptr<Event[]> events;
+		std::atomic<size_t> count;
+		std::atomic<uint64_t> droppedCount;
+	};
+
+	/**
+	 * All the thread buffers. They outlive their threads, so that the events can be written at any time.
+	 */
+	struct Registry
+	{
+		std::mutex mutex;
+		std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+	};
+
+	Registry& getRegistry()
+	{
+		static Registry registry;
+		return registry;
+	}
+
+	thread_local ThreadBuffer* threadBuffer = nullptr;
+
+	ThreadBuffer& getThreadBuffer()
+	{
+		if (!threadBuffer)
+		{
+			Registry& registry = getRegistry();
+			std::lock_guard<std::mutex> lock(registry.mutex);
+			registry.buffers.emplace_back(new ThreadBuffer(registry.buffers.size() + 1));
+			threadBuffer = registry.buffers.back().get();
+		}
+
+		return *threadBuffer;
+	}
+}
+
+int64_t getTraceTime()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void recordTraceEvent(const char* name, int64_t start, int64_t end)
+{
+	ThreadBuffer& buffer = getThreadBuffer();
+
+	const size_t count = buffer.count.load(std::memory_order_relaxed);
+	if (count == THREAD_BUFFER_SIZE)
+	{
+		buffer.droppedCount.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	buffer.events[count] = Event{name, start, end};
+	buffer.count.store(count + 1, std::memory_order_release);
+}
+
+void setTraceThreadName(const std::string& name)
+{
+	ThreadBuffer& buffer = getThreadBuffer();
+
+	std::lock_guard<std::mutex> lock(getRegistry().mutex);
+	buffer.name = name;
+}
+
+void writeTraceJson(const std::string& fileName)
+{
+	std::unique_ptr<FILE, decltype(&fclose)> file(std::fopen(fileName.c_str(), "w"), fclose);
+	if (!file)
+		throw std::runtime_error("Can't create trace file " + fileName);
+
+	Registry& registry = getRegistry();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+
+	uint64_t droppedCount = 0;
+	bool first = true;
+	auto separator = [&]()
+	{
+		std::fputs(first ? "\n" : ",\n", file.get());
+		first = false;
+	};
+
+	std::fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", file.get());
+	for (const std::unique_ptr<ThreadBuffer>& buffer: registry.buffers)
+	{
+		if (!buffer->name.empty())
+		{
+			separator();
+			std::fprintf(file.get(), "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":", buffer->id);
+			writeJsonString(file.get(), buffer->name);
+			std::fputs("}}", file.get());
+		}
+
+		// the thread may keep recording, take only what's published
+		const size_t count = buffer->count.load(std::memory_order_acquire);
+		for (size_t i = 0; i < count; i++)
+		{
+			const Event& event = buffer->events[i];
+			separator();
+			std::fputs("{\"ph\":\"X\",\"name\":", file.get());
+			writeJsonString(file.get(), event.name);
+			// the timestamps are in microseconds
+			std::fprintf(file.get(), ",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+					buffer->id, event.start / 1000.0, (event.end - event.start) / 1000.0);
+		}
+
+		droppedCount += buffer->droppedCount.load(std::memory_order_relaxed);
+	}
+	std::fprintf(file.get(), "\n],\"otherData\":{\"droppedEvents\":%llu}}\n", static_cast<unsigned long long>(droppedCount));
+
+	if (std::ferror(file.get()))
+		throw std::runtime_error("Can't write trace file " + fileName);
+}
+
+#endif // MIRGLESDEMO_TRACING
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef TRACE_H
+#define TRACE_H
+
+/*
+ * Scoped CPU trace zones, exported as Chrome trace-event JSON (viewable in
+ * chrome://tracing or https://ui.perfetto.dev).
+ *
+ * Tracing is compiled in only with MIRGLESDEMO_TRACING defined (the CMake
+ * option of the same name). Otherwise the macros expand to nothing.
+ *
+ *     void loadSomething()
+ *     {
+ *         TRACE_SCOPE("loadSomething");
+ *         ...
+ *     }
+ */
+
+#ifdef MIRGLESDEMO_TRACING
+
+#include <string>
+#include <cstdint>
+
+/** Current time for trace events, in ns. */
+int64_t getTraceTime();
+
+/**
+ * Record a complete event. Lock-free: each thread records into its own buffer.
+ * @param name Must stay valid until the trace is written (e.g. a string literal).
+ */
+void recordTraceEvent(const char* name, int64_t start, int64_t end);
+
+/** Name the calling thread in the trace. */
+void setTraceThreadName(const std::string& name);
+
+/** Write all the events recorded so far. Throws std::runtime_error on failure. */
+void writeTraceJson(const std::string& fileName);
+
+class TraceScope
+{
+public:
+	explicit TraceScope(const char* name):
+		m_name(name),
+		m_start(getTraceTime())
+	{}
+
+	~TraceScope()
+	{
+		recordTraceEvent(m_name, m_start, getTraceTime());
+	}
+
+	// disallow copy and move
+	TraceScope(const TraceScope&) = delete;
+	TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+	const char* m_name;
+	int64_t m_start;
+};
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope_, __LINE__)(name)
+#define TRACE_THREAD_NAME(name) setTraceThreadName(name)
+
+#else
+
+#define TRACE_SCOPE(name) do {} while (false)
+#define TRACE_THREAD_NAME(name) do {} while (false)
+
+#endif // MIRGLESDEMO_TRACING
+
+#endif // TRACE_H
@@ -0,0 +1,217 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "VelocityTracker.h"
+
+#include <cmath>
+
+namespace
+{
+	// weight of the oldest sample in the window, the newest one has weight 1
+	const double OLDEST_SAMPLE_WEIGHT = 0.5;
+}
+
+VelocityTracker::VelocityTracker(int64_t window):
+	m_window(window)
+{
+	for (Pointer& pointer: m_pointers)
+	{
+		pointer.active = false;
+		pointer.count = 0;
+	}
+}
+
+void VelocityTracker::addSample(const InputSample& sample)
+{
+	Pointer& pointer = acquire(sample.pointerId);
+
+	if (sample.action == InputSample::Action::Down)
+		pointer.count = 0;
+
+	// samples must be ordered by time, a sample from the past means a new stream of events
+	if (pointer.count > 0 && sample.eventTime < pointer.samples[pointer.newest].time)
+		pointer.count = 0;
+
+	pointer.newest = (pointer.newest + 1) % HISTORY_SIZE;
+	pointer.samples[pointer.newest] = Sample{sample.x, sample.y, sample.eventTime};
+	if (pointer.count < HISTORY_SIZE)
+		pointer.count++;
+	pointer.lastTime = sample.eventTime;
+}
+
+bool VelocityTracker::getVelocity(int32_t pointerId, glm::vec2& velocity) const
+{
+	Moments m;
+	if (!getMoments(pointerId, m))
+		return false;
+
+	// fit x = a + b*t and y = c + d*t
+	const double denominator = m.t[0] * m.t[2] - m.t[1] * m.t[1];
+	if (std::fabs(denominator) < 1e-12)
+		return false;
+
+	velocity.x = static_cast<float>((m.t[0] * m.x[1] - m.t[1] * m.x[0]) / denominator);
+	velocity.y = static_cast<float>((m.t[0] * m.y[1] - m.t[1] * m.y[0]) / denominator);
+	return true;
+}
+
+bool VelocityTracker::getMotion(int32_t pointerId, glm::vec2& velocity, glm::vec2& acceleration) const
+{
+	Moments m;
+	if (!getMoments(pointerId, m))
+		return false;
+
+	if (m.count < 3)
+	{
+		acceleration = glm::vec2(0.0f, 0.0f);
+		return getVelocity(pointerId, velocity);
+	}
+
+	// fit x = a + b*t + c*t^2, solve the normal equations by Cramer's rule
+	const double* t = m.t;
+	const double determinant =
+			t[0] * (t[2] * t[4] - t[3] * t[3])
+			- t[1] * (t[1] * t[4] - t[3] * t[2])
+			+ t[2] * (t[1] * t[3] - t[2] * t[2]);
+	if (std::fabs(determinant) < 1e-18)
+	{
+		acceleration = glm::vec2(0.0f, 0.0f);
+		return getVelocity(pointerId, velocity);
+	}
+
+	auto solve = [t, determinant](const double* v, double& b, double& c)
+	{
+		b = (t[0] * (v[1] * t[4] - t[3] * v[2])
+				- v[0] * (t[1] * t[4] - t[3] * t[2])
+				+ t[2] * (t[1] * v[2] - v[1] * t[2])) / determinant;
+		c = (t[0] * (t[2] * v[2] - v[1] * t[3])
+				- t[1] * (t[1] * v[2] - v[1] * t[2])
+				+ v[0] * (t[1] * t[3] - t[2] * t[2])) / determinant;
+	};
+
+	double b, c;
+	solve(m.x, b, c);
+	velocity.x = static_cast<float>(b);
+	acceleration.x = static_cast<float>(2.0 * c);
+	solve(m.y, b, c);
+	velocity.y = static_cast<float>(b);
+	acceleration.y = static_cast<float>(2.0 * c);
+	return true;
+}
+
+bool VelocityTracker::getLastSample(int32_t pointerId, glm::vec2& position, int64_t& time) const
+{
+	const Pointer* pointer = find(pointerId);
+	if (!pointer || pointer->count == 0)
+		return false;
+
+	const Sample& sample = pointer->samples[pointer->newest];
+	position = glm::vec2(sample.x, sample.y);
+	time = sample.time;
+	return true;
+}
+
+bool VelocityTracker::getMoments(int32_t pointerId, Moments& m) const
+{
+	const Pointer* pointer = find(pointerId);
+	if (!pointer || pointer->count < 2)
+		return false;
+
+	for (double& v: m.t)
+		v = 0;
+	for (size_t i = 0; i < 3; i++)
+		m.x[i] = m.y[i] = 0;
+	m.count = 0;
+
+	// t is relative to the newest sample (in seconds)
+	const int64_t newestTime = pointer->samples[pointer->newest].time;
+	for (size_t i = 0; i < pointer->count; i++)
+	{
+		const Sample& sample = pointer->samples[(pointer->newest + HISTORY_SIZE - i) % HISTORY_SIZE];
+		const int64_t age = newestTime - sample.time;
+		if (age > m_window)
+			break;
+
+		const double w = 1.0 - (1.0 - OLDEST_SAMPLE_WEIGHT) * static_cast<double>(age) / m_window;
+		const double t = -static_cast<double>(age) * 1e-9;
+
+		double tn = w;
+		for (size_t k = 0; k < 5; k++)
+		{
+			if (k < 3)
+			{
+				m.x[k] += tn * sample.x;
+				m.y[k] += tn * sample.y;
+			}
+			m.t[k] += tn;
+			tn *= t;
+		}
+		m.count++;
+	}
+
+	return m.count >= 2;
+}
+
+void VelocityTracker::reset(int32_t pointerId)
+{
+	Pointer* pointer = find(pointerId);
+	if (pointer)
+		pointer->active = false;
+}
+
+VelocityTracker::Pointer* VelocityTracker::find(int32_t pointerId)
+{
+	for (Pointer& pointer: m_pointers)
+	{
+		if (pointer.active && pointer.id == pointerId)
+			return &pointer;
+	}
+
+	return nullptr;
+}
+
+const VelocityTracker::Pointer* VelocityTracker::find(int32_t pointerId) const
+{
+	return const_cast<VelocityTracker*>(this)->find(pointerId);
+}
+
+VelocityTracker::Pointer& VelocityTracker::acquire(int32_t pointerId)
+{
+	Pointer* pointer = find(pointerId);
+	if (pointer)
+		return *pointer;
+
+	// take a free slot, or the least recently used one if there's none
+	pointer = &m_pointers[0];
+	for (Pointer& candidate: m_pointers)
+	{
+		if (!candidate.active)
+		{
+			pointer = &candidate;
+			break;
+		}
+		if (candidate.lastTime < pointer->lastTime)
+			pointer = &candidate;
+	}
+
+	pointer->id = pointerId;
+	pointer->active = true;
+	pointer->count = 0;
+	pointer->newest = 0;
+	return *pointer;
+}
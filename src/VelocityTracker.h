@@ -0,0 +1,119 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef VELOCITY_TRACKER_H
+#define VELOCITY_TRACKER_H
+
+#include "InputBatch.h"
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Estimates pointer velocities from timestamped input samples.
+ *
+ * The recent samples of each pointer are kept in a fixed size ring buffer. The
+ * velocity is the slope of a weighted least-squares line fit over the samples
+ * within a time window before the newest one, newer samples weighing more.
+ * Using the event timestamps (not the time of delivery) keeps batched or
+ * delayed events from skewing the result. Nothing is allocated.
+ */
+class VelocityTracker
+{
+public:
+	/** How many pointers are tracked at once. */
+	static const size_t MAX_POINTERS = 10;
+
+	/** How many samples are kept for each pointer. */
+	static const size_t HISTORY_SIZE = 20;
+
+	/**
+	 * @param window Only samples at most this old (relative to the newest one) are used, in ns.
+	 */
+	explicit VelocityTracker(int64_t window = 100000000);
+
+	/**
+	 * Add a sample. A Down sample starts a new history for the pointer.
+	 */
+	void addSample(const InputSample& sample);
+
+	/**
+	 * Get the velocity of a pointer in pixels per second.
+	 * @return False if there aren't enough recent samples for the pointer.
+	 */
+	bool getVelocity(int32_t pointerId, glm::vec2& velocity) const;
+
+	/**
+	 * Get the velocity (pixels/s) and acceleration (pixels/s^2) of a pointer, using
+	 * a quadratic fit. The acceleration is zero if there are just two samples.
+	 * @return False if there aren't enough recent samples for the pointer.
+	 */
+	bool getMotion(int32_t pointerId, glm::vec2& velocity, glm::vec2& acceleration) const;
+
+	/**
+	 * Get the newest sample of a pointer.
+	 * @return False if there's no sample for the pointer.
+	 */
+	bool getLastSample(int32_t pointerId, glm::vec2& position, int64_t& time) const;
+
+	/** Forget the pointer's samples. */
+	void reset(int32_t pointerId);
+
+private:
+	struct Sample
+	{
+		float x;
+		float y;
+		int64_t time;
+	};
+
+	struct Pointer
+	{
+		int32_t id;
+		bool active;
+		size_t count;
+		size_t newest;
+		int64_t lastTime; // to find the least recently used pointer
+		std::array<Sample, HISTORY_SIZE> samples;
+	};
+
+	/**
+	 * Weighted sums over the samples in the window: t^0..t^4, x*t^0..x*t^2 and y*t^0..y*t^2.
+	 */
+	struct Moments
+	{
+		double t[5];
+		double x[3];
+		double y[3];
+		size_t count;
+	};
+
+	bool getMoments(int32_t pointerId, Moments& moments) const;
+
+	Pointer* find(int32_t pointerId);
+	const Pointer* find(int32_t pointerId) const;
+	Pointer& acquire(int32_t pointerId);
+
+	int64_t m_window;
+	std::array<Pointer, MAX_POINTERS> m_pointers;
+};
+
+#endif // VELOCITY_TRACKER_H
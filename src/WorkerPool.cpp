@@ -0,0 +1,73 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "WorkerPool.h"
+#include "Trace.h"
+
+WorkerPool::WorkerPool(unsigned threadCount):
+	m_stopping(false)
+{
+	m_threads.reserve(threadCount);
+	for (unsigned i = 0; i < threadCount; i++)
+		m_threads.emplace_back(&WorkerPool::workerLoop, this);
+}
+
+WorkerPool::~WorkerPool()
+{
+	{
+		std::lock_guard<std::mutex> guard(m_mutex);
+		m_stopping = true;
+	}
+	m_condition.notify_all();
+
+	for (std::thread& thread: m_threads)
+		thread.join();
+}
+
+void WorkerPool::enqueue(std::function<void()> task)
+{
+	{
+		std::lock_guard<std::mutex> guard(m_mutex);
+		m_tasks.push_back(std::move(task));
+	}
+	m_condition.notify_one();
+}
+
+void WorkerPool::workerLoop()
+{
+	TRACE_THREAD_NAME("worker");
+
+	while (true)
+	{
+		std::function<void()> task;
+
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_condition.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+
+			if (m_tasks.empty())
+				return; // stopping and nothing left to do
+
+			task = std::move(m_tasks.front());
+			m_tasks.pop_front();
+		}
+
+		// exceptions are stored in the future by packaged_task
+		task();
+	}
+}
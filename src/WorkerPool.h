@@ -0,0 +1,70 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <deque>
+#include <vector>
+#include <type_traits>
+
+/**
+ * A fixed set of threads executing submitted tasks in FIFO order.
+ * Tasks that are already queued are still executed when the pool is destroyed.
+ */
+class WorkerPool
+{
+public:
+	explicit WorkerPool(unsigned threadCount);
+	~WorkerPool();
+
+	template<typename F>
+	std::future<typename std::result_of<F()>::type> submit(F f)
+	{
+		typedef typename std::result_of<F()>::type R;
+
+		// std::function needs a copyable callable, packaged_task is move-only
+		std::shared_ptr<std::packaged_task<R()>> task = std::make_shared<std::packaged_task<R()>>(std::move(f));
+		std::future<R> result = task->get_future();
+		enqueue([task]() { (*task)(); });
+
+		return result;
+	}
+
+	// disallow copy and move
+	WorkerPool& operator=(const WorkerPool&) = delete;
+	WorkerPool(const WorkerPool&) = delete;
+
+private:
+	void enqueue(std::function<void()> task);
+	void workerLoop();
+
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+	std::deque<std::function<void()>> m_tasks;
+	bool m_stopping;
+	std::vector<std::thread> m_threads;
+};
+
+#endif // WORKER_POOL_H
@@ -0,0 +1,33 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+#include "MicroBenchmark.h"
+
+/** PNG decoding at several sizes, the conversion of the PNG color types to RGBA and the mipmap generation. */
+void addImageBenchmarks(MicroBenchmarkSuite& suite);
+
+/** Cube geometry generation, the per-frame matrix composition and the rotation. */
+void addCubeBenchmarks(MicroBenchmarkSuite& suite);
+
+/** Swipe recognition, velocity tracking and the gesture engine. */
+void addInputBenchmarks(MicroBenchmarkSuite& suite);
+
+#endif // BENCHMARKS_H
@@ -0,0 +1,124 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "Benchmarks.h"
+#include "../CubeModel.h"
+#include "../FrameArena.h"
+
+#include <memory>
+#include <vector>
+#include <cmath>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace
+{
+	// the same as in DemoRenderer (the camera distance is the initial one)
+	const size_t FRAME_ARENA_SIZE = 64 * 1024;
+	const float CAMERA_DISTANCE = 6.0f;
+
+	// a frame at 60 Hz
+	const float FRAME_SECONDS = 1.0f / 60.0f;
+}
+
+void addCubeBenchmarks(MicroBenchmarkSuite& suite)
+{
+	suite.add("cube/geometry/vector", [](uint64_t iterations)
+	{
+		std::vector<glm::vec3> v;
+		std::vector<glm::vec2> c;
+		for (uint64_t i = 0; i < iterations; i++)
+		{
+			v.clear();
+			c.clear();
+			v.reserve(CUBE_VERTEX_COUNT);
+			c.reserve(CUBE_VERTEX_COUNT);
+			addCubeGeometry(v, c);
+			keepValue(v[0]);
+			keepValue(c[0]);
+		}
+	});
+
+	// the same in the frame arena, for comparison with the vectors above
+	std::shared_ptr<FrameArena> arena = std::make_shared<FrameArena>(FRAME_ARENA_SIZE);
+	suite.add("cube/geometry/arena", [arena](uint64_t iterations)
+	{
+		for (uint64_t i = 0; i < iterations; i++)
+		{
+			{
+				ArenaVector<glm::vec3> v{ArenaAllocator<glm::vec3>(*arena)};
+				ArenaVector<glm::vec2> c{ArenaAllocator<glm::vec2>(*arena)};
+				v.reserve(CUBE_VERTEX_COUNT);
+				c.reserve(v.capacity());
+				addCubeGeometry(v, c);
+				keepValue(v[0]);
+				keepValue(c[0]);
+			}
+			arena->endFrame();
+		}
+	});
+
+	// as in DemoRenderer::renderFrame(), with the angles changing every frame
+	suite.add("cube/mvpMatrix", [](uint64_t iterations)
+	{
+		const glm::mat4 projection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+		float angle = 0.0f;
+		for (uint64_t i = 0; i < iterations; i++)
+		{
+			const glm::mat4 view = glm::lookAt(glm::vec3(0, 0, CAMERA_DISTANCE), glm::vec3(0, 0, 0), glm::vec3(0, 1, 0));
+			const glm::mat4 mvpMatrix = getCubeMvpMatrix(projection, view, angle, -0.5f * angle, 0.25f * angle);
+			keepValue(mvpMatrix);
+			angle += 0.01f;
+		}
+	});
+
+	// two axes per frame, as in renderFrame(); the spin is restarted whenever it stops
+	suite.add("cube/rotateAlongAxis", [](uint64_t iterations)
+	{
+		float angleX = 0.0f;
+		float angleY = 0.0f;
+		float speedX = 0.0f;
+		float speedY = 0.0f;
+		for (uint64_t i = 0; i < iterations; i++)
+		{
+			if (speedX == 0.0f)
+			{
+				speedX = 12.0f;
+				speedY = -7.0f;
+			}
+
+			rotateAlongAxis(angleX, speedX, FRAME_SECONDS);
+			rotateAlongAxis(angleY, speedY, FRAME_SECONDS);
+			keepValue(angleX);
+			keepValue(angleY);
+		}
+	});
+
+	// mostly small steps out of the range, as after a drag; every 16th one is several turns off
+	suite.add("cube/clampAngle", [](uint64_t iterations)
+	{
+		float step = 0.0f;
+		for (uint64_t i = 0; i < iterations; i++)
+		{
+			float angle = (i % 16 == 0 ? 5.0f * M_PI : M_PI) + step;
+			clampAngle(angle);
+			keepValue(angle);
+			step = step > 0.1f ? -0.1f : step + 0.001f;
+		}
+	});
+}
@@ -0,0 +1,172 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "Benchmarks.h"
+#include "../PNGLoader.h"
+#include "../MipmapGenerator.h"
+
+#include <png.h>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <csetjmp>
+#include <cstdint>
+
+namespace
+{
+	const unsigned DECODE_SIZES[] = { 64, 256, 1024 };
+
+	// size of the images the color type conversions are measured on
+	const unsigned CONVERSION_SIZE = 256;
+
+	struct PNGFormat
+	{
+		const char* name;
+		int colorType;
+		int bitDepth;
+	};
+
+	const PNGFormat CONVERSION_FORMATS[] = {
+		{ "rgba", PNG_COLOR_TYPE_RGB_ALPHA, 8 },
+		{ "rgb", PNG_COLOR_TYPE_RGB, 8 },
+		{ "gray", PNG_COLOR_TYPE_GRAY, 8 },
+		{ "palette", PNG_COLOR_TYPE_PALETTE, 8 },
+		{ "rgba16", PNG_COLOR_TYPE_RGB_ALPHA, 16 }
+	};
+
+	void writeToVector(png_structp pngWriter, png_bytep data, png_size_t length)
+	{
+		std::vector<unsigned char>* out = static_cast<std::vector<unsigned char>*>(png_get_io_ptr(pngWriter));
+		out->insert(out->end(), data, data + length);
+	}
+
+	void flushVector(png_structp)
+	{}
+
+	/**
+	 * A smooth gradient with some noise, so that it compresses roughly like a texture does.
+	 * The content only depends on the position, so the files are the same in every run.
+	 */
+	unsigned char getSample(unsigned x, unsigned y, unsigned channel)
+	{
+		uint32_t h = (x * 73856093u) ^ (y * 19349663u) ^ (channel * 83492791u);
+		h ^= h >> 13;
+		h *= 0x5bd1e995u;
+		h ^= h >> 15;
+		return static_cast<unsigned char>((x + 2 * y + 64 * channel) / 4 + (h & 0x0f));
+	}
+
+	/** Encode a generated size x size image in the given format. */
+	std::vector<unsigned char> encodePNG(unsigned size, const PNGFormat& format)
+	{
+		png_infop pngInfo = nullptr;
+		auto pngDeleter = [&pngInfo](png_structp pngWriter){
+			png_destroy_write_struct(&pngWriter, &pngInfo);
+		};
+		std::unique_ptr<png_struct, decltype(pngDeleter)> pngWriter(nullptr, pngDeleter);
+
+		pngWriter.reset(png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr));
+		if (!pngWriter)
+			throw std::runtime_error("Can't create PNG writer!");
+
+		pngInfo = png_create_info_struct(pngWriter.get());
+		if (!pngInfo)
+			throw std::runtime_error("Can't create PNG writer info structure!");
+
+		unsigned channels = 1;
+		if (format.colorType == PNG_COLOR_TYPE_RGB)
+			channels = 3;
+		else if (format.colorType == PNG_COLOR_TYPE_RGB_ALPHA)
+			channels = 4;
+		const unsigned bytesPerSample = format.bitDepth / 8;
+		const size_t rowSize = size * channels * bytesPerSample;
+
+		std::vector<unsigned char> pixels(rowSize * size);
+		std::vector<png_bytep> rowPointers(size);
+		for (unsigned y = 0; y < size; y++)
+		{
+			unsigned char* row = &pixels[y * rowSize];
+			rowPointers[y] = row;
+			for (unsigned x = 0; x < size; x++)
+				for (unsigned channel = 0; channel < channels; channel++)
+					for (unsigned i = 0; i < bytesPerSample; i++)
+						row[(x * channels + channel) * bytesPerSample + i] = getSample(x, y, channel + i);
+		}
+
+		std::vector<png_color> palette(256);
+		for (unsigned i = 0; i < palette.size(); i++)
+			palette[i] = png_color{ static_cast<png_byte>(i), static_cast<png_byte>(255 - i), static_cast<png_byte>(i / 2) };
+
+		std::vector<unsigned char> encoded;
+		if (setjmp(png_jmpbuf(pngWriter.get())))
+			throw std::runtime_error("Can't encode the benchmark image.");
+
+		png_set_write_fn(pngWriter.get(), &encoded, writeToVector, flushVector);
+		png_set_IHDR(pngWriter.get(), pngInfo, size, size, format.bitDepth, format.colorType,
+				PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+		if (format.colorType == PNG_COLOR_TYPE_PALETTE)
+			png_set_PLTE(pngWriter.get(), pngInfo, palette.data(), palette.size());
+		png_write_info(pngWriter.get(), pngInfo);
+		png_write_image(pngWriter.get(), rowPointers.data());
+		png_write_end(pngWriter.get(), nullptr);
+
+		return encoded;
+	}
+
+	void addDecodeBenchmark(MicroBenchmarkSuite& suite, const std::string& name, unsigned size, const PNGFormat& format)
+	{
+		std::shared_ptr<std::vector<unsigned char>> encoded =
+				std::make_shared<std::vector<unsigned char>>(encodePNG(size, format));
+
+		// the throughput is of the decoded RGBA pixels
+		suite.add(name, [encoded, name](uint64_t iterations)
+		{
+			for (uint64_t i = 0; i < iterations; i++)
+			{
+				Image image = loadPNG(encoded->data(), encoded->size(), name);
+				keepValue(image.getData()[0]);
+			}
+		}, size * size * 4);
+	}
+}
+
+void addImageBenchmarks(MicroBenchmarkSuite& suite)
+{
+	for (unsigned size: DECODE_SIZES)
+		addDecodeBenchmark(suite, "png/decode/" + std::to_string(size), size, CONVERSION_FORMATS[0]);
+
+	for (const PNGFormat& format: CONVERSION_FORMATS)
+		addDecodeBenchmark(suite, std::string("png/convert/") + format.name, CONVERSION_SIZE, format);
+
+	for (unsigned size: DECODE_SIZES)
+	{
+		const std::vector<unsigned char> encoded = encodePNG(size, CONVERSION_FORMATS[0]);
+		std::shared_ptr<Image> image = std::make_shared<Image>(loadPNG(encoded.data(), encoded.size(), "mipmap source"));
+
+		suite.add("mipmap/level/" + std::to_string(size), [image](uint64_t iterations)
+		{
+			for (uint64_t i = 0; i < iterations; i++)
+			{
+				Image level = generateMipmapLevel(*image);
+				keepValue(level.getData()[0]);
+			}
+		}, image->getSize());
+	}
+}
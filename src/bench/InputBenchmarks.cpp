@@ -0,0 +1,175 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "Benchmarks.h"
+#include "../SwipeGesture.h"
+#include "../VelocityTracker.h"
+#include "../GestureEngine.h"
+
+#include <memory>
+#include <vector>
+#include <cmath>
+
+namespace
+{
+	// a stroke of a finger, sampled at 120 Hz
+	const unsigned STROKE_MOVES = 16;
+	const int64_t SAMPLE_INTERVAL = 8333333; // ns
+
+	// frames at 60 Hz, two samples each
+	const unsigned GESTURE_FRAMES = 8;
+
+	struct SwipeCounter: SwipeGesture::Listener
+	{
+		unsigned count = 0;
+
+		virtual void onSwipe(float, float) override
+		{
+			count++;
+		}
+	};
+
+	struct GestureCounter: GestureEngine::Listener
+	{
+		unsigned count = 0;
+
+		virtual void onGestureStart() override
+		{
+			count++;
+		}
+
+		virtual void onPan(float, float) override
+		{
+			count++;
+		}
+
+		virtual void onPinch(float) override
+		{
+			count++;
+		}
+
+		virtual void onRotate(float) override
+		{
+			count++;
+		}
+
+		virtual void onFling(float, float) override
+		{
+			count++;
+		}
+	};
+
+	InputSample makeSample(InputSample::Action action, int32_t pointerId, float x, float y, int64_t eventTime)
+	{
+		InputSample sample;
+		sample.action = action;
+		sample.pointerId = pointerId;
+		sample.x = x;
+		sample.y = y;
+		sample.eventTime = eventTime;
+		return sample;
+	}
+
+	/** A fast, accelerating horizontal stroke: down, moves and up. */
+	std::vector<InputSample> makeStroke(int32_t pointerId)
+	{
+		std::vector<InputSample> stroke;
+		stroke.push_back(makeSample(InputSample::Action::Down, pointerId, 100, 300, 0));
+		for (unsigned i = 1; i <= STROKE_MOVES; i++)
+			stroke.push_back(makeSample(InputSample::Action::Move, pointerId, 100 + 2.0f * i * i, 300 + i, i * SAMPLE_INTERVAL));
+		stroke.push_back(makeSample(InputSample::Action::Up, pointerId, 100 + 2.0f * STROKE_MOVES * STROKE_MOVES, 300 + STROKE_MOVES,
+				(STROKE_MOVES + 1) * SAMPLE_INTERVAL));
+		return stroke;
+	}
+
+	/** A two finger pinch and rotation, then both fingers released. Nothing needs to be coalesced. */
+	std::vector<InputFrame> makePinchFrames()
+	{
+		std::vector<InputFrame> frames(GESTURE_FRAMES + 1);
+		int64_t t = 0;
+		for (unsigned f = 0; f <= GESTURE_FRAMES; f++)
+		{
+			const float radius = 100.0f + 20.0f * f;
+			const float angle = 0.05f * f;
+			const float dx = radius * std::cos(angle);
+			const float dy = radius * std::sin(angle);
+
+			InputSample::Action action = InputSample::Action::Move;
+			if (f == 0)
+				action = InputSample::Action::Down;
+			else if (f == GESTURE_FRAMES)
+				action = InputSample::Action::Up;
+
+			frames[f].samples.push_back(makeSample(action, 0, 400 + dx, 400 + dy, t));
+			frames[f].samples.push_back(makeSample(action, 1, 400 - dx, 400 - dy, t + 1000000));
+			frames[f].coalesced = frames[f].samples;
+			t += 2 * SAMPLE_INTERVAL;
+		}
+		return frames;
+	}
+}
+
+void addInputBenchmarks(MicroBenchmarkSuite& suite)
+{
+	std::shared_ptr<std::vector<InputSample>> stroke = std::make_shared<std::vector<InputSample>>(makeStroke(0));
+
+	// an iteration is a whole stroke that ends with a swipe
+	suite.add("input/swipeGesture/stroke", [stroke](uint64_t iterations)
+	{
+		SwipeCounter counter;
+		SwipeGesture swipe(counter);
+		for (uint64_t i = 0; i < iterations; i++)
+			for (const InputSample& sample: *stroke)
+				swipe.addSample(sample);
+		keepValue(counter.count);
+	});
+
+	// a sample and a velocity estimate, as when predicting the touch position each frame
+	suite.add("input/velocityTracker/sample", [stroke](uint64_t iterations)
+	{
+		VelocityTracker tracker;
+		tracker.addSample((*stroke)[0]);
+		const size_t moves = STROKE_MOVES;
+		int64_t timeOffset = 0;
+		glm::vec2 velocity;
+		for (uint64_t i = 0; i < iterations; i++)
+		{
+			// keep the time increasing so that the window always holds the same number of samples
+			InputSample sample = (*stroke)[1 + i % moves];
+			if (i % moves == 0 && i > 0)
+				timeOffset += moves * SAMPLE_INTERVAL;
+			sample.eventTime += timeOffset;
+			tracker.addSample(sample);
+			tracker.getVelocity(sample.pointerId, velocity);
+			keepValue(velocity);
+		}
+	});
+
+	std::shared_ptr<std::vector<InputFrame>> frames = std::make_shared<std::vector<InputFrame>>(makePinchFrames());
+
+	// an iteration is the whole pinch, frame by frame
+	suite.add("input/gestureEngine/pinch", [frames](uint64_t iterations)
+	{
+		GestureCounter counter;
+		GestureEngine engine(counter);
+		for (uint64_t i = 0; i < iterations; i++)
+			for (const InputFrame& frame: *frames)
+				engine.process(frame);
+		keepValue(counter.count);
+	});
+}
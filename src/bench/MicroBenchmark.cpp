@@ -0,0 +1,190 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "MicroBenchmark.h"
+#include "../Json.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <memory>
+#include <stdexcept>
+#include <cmath>
+#include <cstdio>
+
+namespace
+{
+	// upper bound of the iteration count growth between two calibration runs
+	const uint64_t MAX_CALIBRATION_GROWTH = 10;
+
+	double getNs(MicroBenchmarkSuite::clock::duration d)
+	{
+		return std::chrono::duration<double, std::nano>(d).count();
+	}
+
+	MicroBenchmarkSuite::clock::duration timeIterations(const MicroBenchmarkSuite::Body& body, uint64_t iterations)
+	{
+		const MicroBenchmarkSuite::clock::time_point start = MicroBenchmarkSuite::clock::now();
+		body(iterations);
+		return MicroBenchmarkSuite::clock::now() - start;
+	}
+
+	/** Grow the iteration count until a run takes at least minTime. */
+	uint64_t calibrate(const MicroBenchmarkSuite::Body& body, MicroBenchmarkSuite::clock::duration minTime)
+	{
+		uint64_t iterations = 1;
+		for (;;)
+		{
+			const double elapsedNs = getNs(timeIterations(body, iterations));
+			const double minNs = getNs(minTime);
+			if (elapsedNs >= minNs)
+				return iterations;
+
+			// aim a bit over the minimum, so that the next run is likely long enough
+			const double growth = elapsedNs > 0 ? 1.2 * minNs / elapsedNs : MAX_CALIBRATION_GROWTH;
+			iterations = std::max(iterations + 1, static_cast<uint64_t>(iterations * std::min<double>(growth, MAX_CALIBRATION_GROWTH)));
+		}
+	}
+
+	const char* getBuildType()
+	{
+#ifdef NDEBUG
+		return "release";
+#else
+		return "debug";
+#endif
+	}
+}
+
+MicroBenchmarkSuite::Settings::Settings():
+	repetitions(10),
+	warmupTime(200),
+	minRepetitionTime(20)
+{}
+
+double MicroBenchmarkSuite::Result::getMin() const
+{
+	return nsPerIteration.front();
+}
+
+double MicroBenchmarkSuite::Result::getMedian() const
+{
+	const size_t n = nsPerIteration.size();
+	return n % 2 ? nsPerIteration[n / 2] : (nsPerIteration[n / 2 - 1] + nsPerIteration[n / 2]) / 2;
+}
+
+double MicroBenchmarkSuite::Result::getMean() const
+{
+	double sum = 0;
+	for (double ns: nsPerIteration)
+		sum += ns;
+	return sum / nsPerIteration.size();
+}
+
+double MicroBenchmarkSuite::Result::getMax() const
+{
+	return nsPerIteration.back();
+}
+
+double MicroBenchmarkSuite::Result::getSpread() const
+{
+	const double mean = getMean();
+	double sum = 0;
+	for (double ns: nsPerIteration)
+		sum += (ns - mean) * (ns - mean);
+	return mean > 0 ? 100 * std::sqrt(sum / nsPerIteration.size()) / mean : 0;
+}
+
+void MicroBenchmarkSuite::add(const std::string& name, Body body, size_t bytesPerIteration)
+{
+	m_cases.push_back(Case{name, std::move(body), bytesPerIteration});
+}
+
+void MicroBenchmarkSuite::list(std::ostream& os) const
+{
+	for (const Case& c: m_cases)
+		os << c.name << std::endl;
+}
+
+std::vector<MicroBenchmarkSuite::Result> MicroBenchmarkSuite::run(const Settings& settings, std::ostream& os) const
+{
+	if (settings.repetitions == 0)
+		throw std::runtime_error("At least one repetition is needed.");
+
+	os << std::left << std::setw(40) << "case" << std::right
+	   << std::setw(12) << "iterations" << std::setw(14) << "min ns" << std::setw(14) << "median ns"
+	   << std::setw(14) << "mean ns" << std::setw(9) << "spread" << std::setw(12) << "MB/s" << std::endl;
+
+	std::vector<Result> results;
+	for (const Case& c: m_cases)
+	{
+		if (c.name.find(settings.filter) == std::string::npos)
+			continue;
+
+		const uint64_t iterations = calibrate(c.body, settings.minRepetitionTime);
+
+		// the calibration already ran the case, but possibly only briefly
+		const clock::time_point warmupEnd = clock::now() + settings.warmupTime;
+		do
+			c.body(iterations);
+		while (clock::now() < warmupEnd);
+
+		Result result{c.name, iterations, c.bytesPerIteration, std::vector<double>()};
+		result.nsPerIteration.reserve(settings.repetitions);
+		for (unsigned i = 0; i < settings.repetitions; i++)
+			result.nsPerIteration.push_back(getNs(timeIterations(c.body, iterations)) / iterations);
+		std::sort(result.nsPerIteration.begin(), result.nsPerIteration.end());
+
+		os << std::left << std::setw(40) << c.name << std::right << std::fixed << std::setprecision(1)
+		   << std::setw(12) << iterations << std::setw(14) << result.getMin() << std::setw(14) << result.getMedian()
+		   << std::setw(14) << result.getMean() << std::setw(8) << result.getSpread() << "%";
+		if (c.bytesPerIteration > 0)
+			os << std::setw(12) << c.bytesPerIteration * 1e3 / result.getMedian(); // bytes/ns = 1e3 MB/s
+		os << std::endl;
+
+		results.push_back(std::move(result));
+	}
+
+	return results;
+}
+
+void writeMicroBenchmarkJson(const std::string& fileName, const MicroBenchmarkSuite::Settings& settings,
+		const std::vector<MicroBenchmarkSuite::Result>& results)
+{
+	std::unique_ptr<FILE, decltype(&fclose)> file(std::fopen(fileName.c_str(), "w"), fclose);
+	if (!file)
+		throw std::runtime_error("Can't create benchmark result file " + fileName);
+
+	std::fprintf(file.get(), "{\n  \"build\": \"%s\",\n  \"compiler\": ", getBuildType());
+	writeJsonString(file.get(), __VERSION__);
+	std::fprintf(file.get(), ",\n  \"repetitions\": %u,\n  \"warmupMs\": %lld,\n  \"minRepetitionMs\": %lld,\n  \"cases\": [",
+			settings.repetitions, static_cast<long long>(settings.warmupTime.count()),
+			static_cast<long long>(settings.minRepetitionTime.count()));
+
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const MicroBenchmarkSuite::Result& result = results[i];
+		std::fputs(i > 0 ? ",\n    {\"name\": " : "\n    {\"name\": ", file.get());
+		writeJsonString(file.get(), result.name);
+		std::fprintf(file.get(), ", \"iterations\": %llu, \"bytesPerIteration\": %zu, \"minNs\": %.3f, \"medianNs\": %.3f, "
+				"\"meanNs\": %.3f, \"maxNs\": %.3f, \"spreadPercent\": %.2f}",
+				static_cast<unsigned long long>(result.iterations), result.bytesPerIteration,
+				result.getMin(), result.getMedian(), result.getMean(), result.getMax(), result.getSpread());
+	}
+
+	std::fputs("\n  ]\n}\n", file.get());
+}
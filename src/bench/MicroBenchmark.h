@@ -0,0 +1,110 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MICRO_BENCHMARK_H
+#define MICRO_BENCHMARK_H
+
+#include <chrono>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Keep the compiler from optimizing away the computation of value.
+ */
+template<typename T>
+inline void keepValue(const T& value)
+{
+	asm volatile("" : : "g"(&value) : "memory");
+}
+
+/**
+ * A small harness timing CPU code.
+ *
+ * Each case is a function running the measured code the given number of times.
+ * The harness first grows the iteration count until a repetition takes at
+ * least the minimum repetition time, then runs the case for the warmup time
+ * and finally times the repetitions. The results are in ns per iteration.
+ */
+class MicroBenchmarkSuite
+{
+public:
+	typedef std::chrono::steady_clock clock;
+	typedef std::function<void(uint64_t iterations)> Body;
+
+	struct Settings
+	{
+		Settings();
+
+		unsigned repetitions;
+		std::chrono::milliseconds warmupTime;
+		std::chrono::milliseconds minRepetitionTime;
+		std::string filter; // only the cases with this in their name
+	};
+
+	struct Result
+	{
+		std::string name;
+		uint64_t iterations; // per repetition
+		size_t bytesPerIteration;
+		std::vector<double> nsPerIteration; // of each repetition, sorted
+
+		double getMin() const;
+		double getMedian() const;
+		double getMean() const;
+		double getMax() const;
+
+		/** Standard deviation relative to the mean, in %. */
+		double getSpread() const;
+	};
+
+	/**
+	 * Add a case. Use names like "group/case/variant" so that a group can be selected with a filter.
+	 * @param bytesPerIteration Amount of data one iteration processes, for a throughput; 0 if not applicable.
+	 */
+	void add(const std::string& name, Body body, size_t bytesPerIteration = 0);
+
+	void list(std::ostream& os) const;
+
+	/**
+	 * Run the selected cases, writing a line for each to os as it finishes.
+	 */
+	std::vector<Result> run(const Settings& settings, std::ostream& os) const;
+
+private:
+	struct Case
+	{
+		std::string name;
+		Body body;
+		size_t bytesPerIteration;
+	};
+
+	std::vector<Case> m_cases;
+};
+
+/**
+ * Write the results as JSON. The build type and the compiler are included so that
+ * the files of different builds can be told apart.
+ */
+void writeMicroBenchmarkJson(const std::string& fileName, const MicroBenchmarkSuite::Settings& settings,
+		const std::vector<MicroBenchmarkSuite::Result>& results);
+
+#endif // MICRO_BENCHMARK_H
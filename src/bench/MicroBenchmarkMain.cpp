@@ -0,0 +1,139 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "MicroBenchmark.h"
+#include "Benchmarks.h"
+#include "../Options.h"
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+	struct BenchOptions
+	{
+		bool showHelp = false;
+		bool list = false;
+		MicroBenchmarkSuite::Settings settings;
+		std::string jsonFile;
+	};
+
+	BenchOptions parseBenchOptions(int argc, char* argv[])
+	{
+		BenchOptions options;
+
+		for (int i = 1; i < argc; i++)
+		{
+			const std::string arg(argv[i]);
+
+			// --name or --name=value
+			const size_t equals = arg.find('=');
+			const std::string name = arg.substr(0, equals);
+			const bool hasValue = equals != std::string::npos;
+			const std::string value = hasValue ? arg.substr(equals + 1) : std::string();
+
+			if ((name == "--help" || name == "-h") && !hasValue)
+				options.showHelp = true;
+			else if (name == "--list" && !hasValue)
+				options.list = true;
+			else if (name == "--filter" && hasValue)
+				options.settings.filter = value;
+			else if (name == "--repetitions" && hasValue)
+				options.settings.repetitions = parseUnsigned(name, value);
+			else if (name == "--warmup" && hasValue)
+				options.settings.warmupTime = std::chrono::milliseconds(parseUnsigned(name, value));
+			else if (name == "--min-time" && hasValue)
+				options.settings.minRepetitionTime = std::chrono::milliseconds(parseUnsigned(name, value));
+			else if (name == "--json" && hasValue)
+				options.jsonFile = value;
+			else
+				throw std::runtime_error("invalid option " + arg);
+		}
+
+		return options;
+	}
+
+	void printBenchUsage(std::ostream& os, const char* programName)
+	{
+		const MicroBenchmarkSuite::Settings defaults;
+		os << "Usage: " << programName << " [OPTIONS]" << std::endl
+		   << "Time the CPU hot paths of mir_gles_demo." << std::endl
+		   << std::endl
+		   << "  --help, -h        show this help" << std::endl
+		   << "  --list            list the cases" << std::endl
+		   << "  --filter=TEXT     run only the cases with TEXT in their name" << std::endl
+		   << "  --repetitions=N   timed repetitions of each case (default " << defaults.repetitions << ")" << std::endl
+		   << "  --warmup=MS       untimed run of each case before the repetitions (default "
+		   << defaults.warmupTime.count() << ")" << std::endl
+		   << "  --min-time=MS     minimum duration of a repetition (default " << defaults.minRepetitionTime.count() << ")" << std::endl
+		   << "  --json=FILE       also write the results to FILE, see tools/compare-microbenchmarks.py" << std::endl;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	BenchOptions options;
+	try
+	{
+		options = parseBenchOptions(argc, argv);
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << std::endl;
+		printBenchUsage(std::cerr, argv[0]);
+		return 1;
+	}
+
+	if (options.showHelp)
+	{
+		printBenchUsage(std::cout, argv[0]);
+		return 0;
+	}
+
+	try
+	{
+		MicroBenchmarkSuite suite;
+		addImageBenchmarks(suite);
+		addCubeBenchmarks(suite);
+		addInputBenchmarks(suite);
+
+		if (options.list)
+		{
+			suite.list(std::cout);
+			return 0;
+		}
+
+		const std::vector<MicroBenchmarkSuite::Result> results = suite.run(options.settings, std::cout);
+		if (results.empty())
+			throw std::runtime_error("No case matches the filter " + options.settings.filter);
+
+		if (!options.jsonFile.empty())
+		{
+			writeMicroBenchmarkJson(options.jsonFile, options.settings, results);
+			std::cout << "Results written to " << options.jsonFile << std::endl;
+		}
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
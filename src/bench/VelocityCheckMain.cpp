@@ -0,0 +1,219 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "../InputTrace.h"
+#include "../SwipeGesture.h"
+#include "../Options.h"
+
+#include <glm/glm.hpp>
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <cmath>
+
+/*
+ * Replays an input trace through SwipeGesture (and so VelocityTracker) and
+ * compares the velocity of each release with the expected one, e.g.
+ * media/traces/velocity.trace written by tools/make-velocity-trace.py.
+ */
+
+namespace
+{
+	// trace time advanced per replay() call; small enough to deliver the events one by one
+	const int64_t REPLAY_STEP = 1000000; // ns
+
+	/** A release with a velocity (pixels/s), or without a swipe. */
+	struct Release
+	{
+		bool isSwipe;
+		glm::vec2 velocity;
+	};
+
+	struct ReleaseCollector: InputReplayer::Listener, SwipeGesture::Listener
+	{
+		ReleaseCollector():
+			swipe(*this),
+			hasSwiped(false)
+		{}
+
+		virtual void onReplayedSample(const InputSample& sample) override
+		{
+			hasSwiped = false;
+			swipe.addSample(sample);
+			if (sample.action == InputSample::Action::Up)
+				releases.push_back(Release{hasSwiped, hasSwiped ? swipeVelocity : glm::vec2(0.0f, 0.0f)});
+		}
+
+		virtual void onReplayedKey(const KeySample&) override
+		{}
+
+		virtual void onSwipe(float dx, float dy) override
+		{
+			// onSwipe gets the distance traveled in SWIPE_DURATION
+			const float swipeSeconds = std::chrono::duration<float>(SwipeGesture::SWIPE_DURATION).count();
+			hasSwiped = true;
+			swipeVelocity = glm::vec2(dx / swipeSeconds, dy / swipeSeconds);
+		}
+
+		SwipeGesture swipe;
+		bool hasSwiped;
+		glm::vec2 swipeVelocity;
+		std::vector<Release> releases;
+	};
+
+	/**
+	 * One line per release: "VX VY" or "none". Empty lines and lines starting with # are skipped.
+	 */
+	std::vector<Release> loadExpected(const std::string& fileName)
+	{
+		std::ifstream file(fileName);
+		if (!file)
+			throw std::runtime_error("Can't open " + fileName);
+
+		std::vector<Release> releases;
+		std::string line;
+		unsigned lineNumber = 0;
+		while (std::getline(file, line))
+		{
+			lineNumber++;
+			if (line.empty() || line[0] == '#')
+				continue;
+
+			Release release{false, glm::vec2(0.0f, 0.0f)};
+			if (line != "none")
+			{
+				std::istringstream is(line);
+				release.isSwipe = true;
+				if (!(is >> release.velocity.x >> release.velocity.y))
+					throw std::runtime_error(fileName + ":" + std::to_string(lineNumber) + ": \"VX VY\" or \"none\" expected");
+			}
+			releases.push_back(release);
+		}
+
+		return releases;
+	}
+
+	std::string toString(const Release& release)
+	{
+		if (!release.isSwipe)
+			return "no swipe";
+
+		std::ostringstream os;
+		os << release.velocity.x << "," << release.velocity.y << " px/s";
+		return os.str();
+	}
+
+	bool matches(const Release& release, const Release& expected, float tolerance)
+	{
+		if (release.isSwipe != expected.isSwipe)
+			return false;
+		if (!expected.isSwipe)
+			return true;
+
+		// relative to the speed, plus a pixel per second for the slow ones
+		const glm::vec2 error = release.velocity - expected.velocity;
+		const float expectedSpeed = std::sqrt(expected.velocity.x * expected.velocity.x + expected.velocity.y * expected.velocity.y);
+		return std::sqrt(error.x * error.x + error.y * error.y) <= tolerance * expectedSpeed + 1.0f;
+	}
+
+	void printCheckUsage(std::ostream& os, const char* programName)
+	{
+		os << "Usage: " << programName << " [--tolerance=PERCENT] TRACE EXPECTED" << std::endl
+		   << "Check the release velocities fitted to an input trace against the expected ones." << std::endl
+		   << "The default tolerance is 2 percent of the expected speed." << std::endl;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	float tolerance = 0.02f;
+	std::vector<std::string> files;
+	try
+	{
+		for (int i = 1; i < argc; i++)
+		{
+			const std::string arg(argv[i]);
+			if (arg == "--help" || arg == "-h")
+			{
+				printCheckUsage(std::cout, argv[0]);
+				return 0;
+			}
+			else if (arg.compare(0, 12, "--tolerance=") == 0)
+				tolerance = parseFloat("--tolerance", arg.substr(12)) / 100.0f;
+			else if (arg.compare(0, 2, "--") == 0)
+				throw std::runtime_error("invalid option " + arg);
+			else
+				files.push_back(arg);
+		}
+
+		if (files.size() != 2)
+			throw std::runtime_error("a trace and an expected file are needed");
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << std::endl;
+		printCheckUsage(std::cerr, argv[0]);
+		return 1;
+	}
+
+	try
+	{
+		const std::vector<Release> expected = loadExpected(files[1]);
+
+		InputReplayer replayer(files[0], 1.0, REPLAY_STEP);
+		ReleaseCollector collector;
+		for (int64_t now = 0; !replayer.isFinished(); now += REPLAY_STEP)
+			replayer.replay(now, collector);
+
+		if (collector.releases.size() != expected.size())
+		{
+			throw std::runtime_error(files[0] + " has " + std::to_string(collector.releases.size()) + " releases, "
+					+ files[1] + " expects " + std::to_string(expected.size()));
+		}
+
+		unsigned failures = 0;
+		for (size_t i = 0; i < expected.size(); i++)
+		{
+			const bool isMatch = matches(collector.releases[i], expected[i], tolerance);
+			std::cout << "release " << i + 1 << ": " << toString(collector.releases[i])
+					<< ", expected " << toString(expected[i]) << (isMatch ? "" : "  FAILED") << std::endl;
+			if (!isMatch)
+				failures++;
+		}
+
+		if (failures > 0)
+		{
+			std::cout << failures << " of " << expected.size() << " releases failed" << std::endl;
+			return 1;
+		}
+
+		std::cout << "All " << expected.size() << " releases passed" << std::endl;
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
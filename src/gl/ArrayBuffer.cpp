@@ -17,19 +17,50 @@
  * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "ArrayBuffer.h"
+#include "GLCheck.h"
+#include "GLCounters.h"
 #include <stdexcept>
 
-ArrayBuffer::ArrayBuffer()
+ArrayBuffer::ArrayBuffer(const std::string& name):
+	m_buffer(GLObjectPool::get().create(GLObjectType::Buffer)),
+	m_memory(MemoryCategory::Buffer, name)
+{}
+
+ArrayBuffer::~ArrayBuffer()
 {
-	glGenBuffers(1, &m_buffer);
+	GLObjectPool::get().release(m_buffer);
 }
 
-ArrayBuffer::~ArrayBuffer()
+ArrayBuffer::ArrayBuffer(ArrayBuffer&& other):
+	m_buffer(other.m_buffer),
+	m_memory(std::move(other.m_memory))
+{
+	other.m_buffer = GLHandle();
+}
+
+ArrayBuffer& ArrayBuffer::operator=(ArrayBuffer&& other)
 {
-	glDeleteBuffers(1, &m_buffer);
+	if (this != &other)
+	{
+		GLObjectPool::get().release(m_buffer);
+		m_buffer = other.m_buffer;
+		other.m_buffer = GLHandle();
+		m_memory = std::move(other.m_memory);
+	}
+
+	return *this;
 }
 
 void ArrayBuffer::bind()
 {
-	glBindBuffer(GL_ARRAY_BUFFER, m_buffer);
+	GL_CHECK(glBindBuffer(GL_ARRAY_BUFFER, getGLBuffer()));
+}
+
+void ArrayBuffer::setData(const void* data, size_t size, GLenum usage)
+{
+	bind();
+	GL_CHECK(glBufferData(GL_ARRAY_BUFFER, size, data, usage));
+	countGL(GLCounter::BufferUploads);
+	countGL(GLCounter::UploadedBytes, size);
+	m_memory.resize(size);
 }
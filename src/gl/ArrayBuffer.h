@@ -19,30 +19,40 @@
 #ifndef GL_ARRAY_BUFFER_H
 #define GL_ARRAY_BUFFER_H
 
+#include "../MemoryTracker.h"
+#include "GLObjectPool.h"
+
 #include <memory>
+#include <string>
 #include <GLES2/gl2.h>
 
 class ArrayBuffer
 {
 public:
-	ArrayBuffer();
+	explicit ArrayBuffer(const std::string& name = std::string());
 	~ArrayBuffer();
 
 	void bind();
 
+	/**
+	 * Bind the buffer and replace its content (glBufferData). The size is accounted in the MemoryTracker.
+	 */
+	void setData(const void* data, size_t size, GLenum usage);
+
 	GLuint getGLBuffer() const
 	{
-		return m_buffer;
+		return GLObjectPool::get().resolve(m_buffer);
 	}
 
 	// allow move, disallow copy
-	ArrayBuffer& operator=(ArrayBuffer&&) = default;
-	ArrayBuffer(ArrayBuffer&&) = default;
+	ArrayBuffer& operator=(ArrayBuffer&& other);
+	ArrayBuffer(ArrayBuffer&& other);
 	ArrayBuffer& operator=(const ArrayBuffer&) = delete;
 	ArrayBuffer(const ArrayBuffer&) = delete;
 
 private:
-	GLuint m_buffer;
+	GLHandle m_buffer;
+	TrackedMemory m_memory;
 };
 
 #endif // GL_ARRAY_BUFFER_H
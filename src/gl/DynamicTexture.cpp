@@ -0,0 +1,167 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "DynamicTexture.h"
+#include "Extensions.h"
+#include "GLCheck.h"
+#include "GLCounters.h"
+
+#include <GLES2/gl2ext.h>
+
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+
+// older headers may not have GL_EXT_unpack_subimage
+#ifndef GL_UNPACK_ROW_LENGTH_EXT
+#define GL_UNPACK_ROW_LENGTH_EXT 0x0CF2
+#endif
+
+void DynamicTexture::Rect::add(const Rect& other)
+{
+	if (isEmpty())
+		*this = other;
+	else if (!other.isEmpty())
+	{
+		x0 = std::min(x0, other.x0);
+		y0 = std::min(y0, other.y0);
+		x1 = std::max(x1, other.x1);
+		y1 = std::max(y1, other.y1);
+	}
+}
+
+DynamicTexture::DynamicTexture(unsigned width, unsigned height, unsigned bufferCount):
+	m_width(width),
+	m_height(height),
+	m_hasUnpackSubimage(hasGLExtension("GL_EXT_unpack_subimage")),
+	m_current(0)
+{
+	if (bufferCount < 1)
+		throw std::runtime_error("DynamicTexture: at least one buffer is needed");
+
+	for (unsigned i = 0; i < bufferCount; i++)
+	{
+		m_textures.emplace_back(new Texture2D(width, height, "dynamic texture"));
+		m_dirty.push_back(Rect{0, 0, 0, 0});
+	}
+
+	if (bufferCount > 1)
+	{
+		const size_t size = static_cast<size_t>(width) * height * 4;
+		m_shadow.reset(new unsigned char[size]);
+		m_shadowMemory = TrackedMemory(MemoryCategory::Staging, "dynamic texture shadow", size);
+		std::memset(m_shadow.get(), 0, size);
+
+		// the textures' initial content is undefined, make them match the shadow copy
+		for (Rect& dirty: m_dirty)
+			dirty = Rect{0, 0, width, height};
+	}
+
+	m_statistics.uploadCount = 0;
+	m_statistics.uploadBytes = 0;
+	m_statistics.uploadTime = std::chrono::steady_clock::duration::zero();
+}
+
+void DynamicTexture::update(unsigned x, unsigned y, unsigned width, unsigned height, const unsigned char* data, unsigned rowLength)
+{
+	if (x + width > m_width || y + height > m_height)
+		throw std::runtime_error("DynamicTexture::update: the rectangle is out of the texture");
+
+	if (rowLength == 0)
+		rowLength = width;
+
+	const Rect rect{x, y, x + width, y + height};
+	if (rect.isEmpty())
+		return;
+
+	if (!m_shadow)
+	{
+		upload(*m_textures[0], rect, data, rowLength);
+		return;
+	}
+
+	const size_t rowSize = static_cast<size_t>(width) * 4;
+	for (unsigned row = 0; row < height; row++)
+		std::memcpy(m_shadow.get() + ((y + row) * m_width + x) * 4, data + static_cast<size_t>(row) * rowLength * 4, rowSize);
+
+	for (Rect& dirty: m_dirty)
+		dirty.add(rect);
+}
+
+const Texture2D& DynamicTexture::commit()
+{
+	if (!m_shadow)
+		return *m_textures[0];
+
+	m_current = (m_current + 1) % m_textures.size();
+
+	Rect& dirty = m_dirty[m_current];
+	if (!dirty.isEmpty())
+	{
+		if (!m_hasUnpackSubimage)
+		{
+			// without GL_UNPACK_ROW_LENGTH, whole rows are contiguous in the shadow copy
+			dirty.x0 = 0;
+			dirty.x1 = m_width;
+		}
+
+		upload(*m_textures[m_current], dirty, m_shadow.get() + (dirty.y0 * m_width + dirty.x0) * 4, m_width);
+		dirty = Rect{0, 0, 0, 0};
+	}
+
+	return *m_textures[m_current];
+}
+
+void DynamicTexture::upload(const Texture2D& texture, const Rect& rect, const unsigned char* data, unsigned rowLength)
+{
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	const unsigned width = rect.x1 - rect.x0;
+	const unsigned height = rect.y1 - rect.y0;
+	const uint64_t uploadCount = m_statistics.uploadCount;
+
+	GL_CHECK(glBindTexture(GL_TEXTURE_2D, texture.getGLTexture()));
+
+	if (rowLength == width)
+	{
+		GL_CHECK(glTexSubImage2D(GL_TEXTURE_2D, 0, rect.x0, rect.y0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, data));
+		m_statistics.uploadCount++;
+	}
+	else if (m_hasUnpackSubimage)
+	{
+		GL_CHECK(glPixelStorei(GL_UNPACK_ROW_LENGTH_EXT, rowLength));
+		GL_CHECK(glTexSubImage2D(GL_TEXTURE_2D, 0, rect.x0, rect.y0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, data));
+		GL_CHECK(glPixelStorei(GL_UNPACK_ROW_LENGTH_EXT, 0));
+		m_statistics.uploadCount++;
+	}
+	else
+	{
+		// no way to tell GL about the stride: upload row by row
+		for (unsigned row = 0; row < height; row++)
+		{
+			GL_CHECK(glTexSubImage2D(GL_TEXTURE_2D, 0, rect.x0, rect.y0 + row, width, 1, GL_RGBA, GL_UNSIGNED_BYTE,
+					data + static_cast<size_t>(row) * rowLength * 4));
+		}
+		m_statistics.uploadCount += height;
+	}
+
+	countGL(GLCounter::TextureUploads, m_statistics.uploadCount - uploadCount);
+	countGL(GLCounter::UploadedBytes, static_cast<uint64_t>(width) * height * 4);
+	m_statistics.uploadBytes += static_cast<uint64_t>(width) * height * 4;
+	m_statistics.uploadTime += std::chrono::steady_clock::now() - start;
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GL_DYNAMIC_TEXTURE_H
+#define GL_DYNAMIC_TEXTURE_H
+
+#include "Texture.h"
+#include "../MemoryTracker.h"
+
+#include <GLES2/gl2.h>
+
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * A texture whose content changes often (e.g. camera frames or generated content).
+ *
+ * The content is updated by rectangles with glTexSubImage2D, the texture objects
+ * are never re-created and no mipmaps are generated.
+ *
+ * With more than one buffer, the textures form a ring: updates go to a CPU side
+ * copy and commit() uploads the changed region into the next texture in the ring,
+ * so that a texture the GPU may still be reading from is never written to (which
+ * would stall the pipeline). With a single buffer, updates are uploaded directly.
+ *
+ * Strided sources are uploaded using GL_EXT_unpack_subimage if it's available.
+ * The methods bind the texture to GL_TEXTURE_2D of the active texture unit.
+ */
+class DynamicTexture
+{
+public:
+	struct Statistics
+	{
+		uint64_t uploadCount; // glTexSubImage2D calls
+		uint64_t uploadBytes;
+		std::chrono::steady_clock::duration uploadTime; // CPU time spent submitting the uploads
+	};
+
+	DynamicTexture(unsigned width, unsigned height, unsigned bufferCount);
+
+	/**
+	 * Update a rectangle of the texture with RGBA data.
+	 * @param rowLength Distance between the starts of the source rows, in pixels. 0 means width.
+	 */
+	void update(unsigned x, unsigned y, unsigned width, unsigned height, const unsigned char* data, unsigned rowLength = 0);
+
+	/**
+	 * Upload the pending updates into the next texture of the ring and return it.
+	 * Call this once per frame, before drawing with the texture.
+	 */
+	const Texture2D& commit();
+
+	const Texture2D& getCurrent() const
+	{
+		return *m_textures[m_current];
+	}
+
+	const Statistics& getStatistics() const
+	{
+		return m_statistics;
+	}
+
+private:
+	struct Rect
+	{
+		unsigned x0;
+		unsigned y0;
+		unsigned x1;
+		unsigned y1;
+
+		bool isEmpty() const
+		{
+			return x0 >= x1 || y0 >= y1;
+		}
+
+		void add(const Rect& other);
+	};
+
+	void upload(const Texture2D& texture, const Rect& rect, const unsigned char* data, unsigned rowLength);
+
+	unsigned m_width;
+	unsigned m_height;
+	bool m_hasUnpackSubimage;
+
+	std::vector<std::unique_ptr<Texture2D>> m_textures;
+	std::vector<Rect> m_dirty; // region of each texture changed since it was written last
+	std::unique_ptr<unsigned char[]> m_shadow; // current content, only with more than one buffer
+	TrackedMemory m_shadowMemory;
+	size_t m_current;
+
+	Statistics m_statistics;
+};
+
+#endif // GL_DYNAMIC_TEXTURE_H
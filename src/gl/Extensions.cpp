@@ -0,0 +1,44 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "Extensions.h"
+
+#include <GLES2/gl2.h>
+#include <cstring>
+
+bool hasGLExtension(const char* name)
+{
+	const char* extensions = reinterpret_cast<const char*>(glGetString(GL_EXTENSIONS));
+	if (!extensions)
+		return false;
+
+	// the names are separated by spaces; make sure not to match a prefix of a longer name
+	const size_t nameLength = std::strlen(name);
+	const char* p = extensions;
+	while ((p = std::strstr(p, name)) != nullptr)
+	{
+		const bool startsWord = p == extensions || p[-1] == ' ';
+		const bool endsWord = p[nameLength] == ' ' || p[nameLength] == '\0';
+		if (startsWord && endsWord)
+			return true;
+
+		p += nameLength;
+	}
+
+	return false;
+}
@@ -0,0 +1,208 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "GLCheck.h"
+
+#include <cstdio>
+
+std::string getGLErrorName(GLenum error)
+{
+	switch (error)
+	{
+	case GL_NO_ERROR:
+		return "GL_NO_ERROR";
+	case GL_INVALID_ENUM:
+		return "GL_INVALID_ENUM";
+	case GL_INVALID_VALUE:
+		return "GL_INVALID_VALUE";
+	case GL_INVALID_OPERATION:
+		return "GL_INVALID_OPERATION";
+	case GL_INVALID_FRAMEBUFFER_OPERATION:
+		return "GL_INVALID_FRAMEBUFFER_OPERATION";
+	case GL_OUT_OF_MEMORY:
+		return "GL_OUT_OF_MEMORY";
+	}
+
+	char buffer[32];
+	std::snprintf(buffer, sizeof(buffer), "GL error 0x%04x", error);
+	return buffer;
+}
+
+#ifndef NDEBUG
+
+#include "Extensions.h"
+#include "../Log.h"
+
+#include <EGL/egl.h>
+
+#include <array>
+#include <mutex>
+
+// GL_KHR_debug, in case gl2ext.h is too old to have it
+#ifndef GL_DEBUG_OUTPUT_KHR
+#define GL_DEBUG_OUTPUT_KHR 0x92E0
+#endif
+#ifndef GL_DEBUG_OUTPUT_SYNCHRONOUS_KHR
+#define GL_DEBUG_OUTPUT_SYNCHRONOUS_KHR 0x8242
+#endif
+#ifndef GL_DEBUG_TYPE_ERROR_KHR
+#define GL_DEBUG_TYPE_ERROR_KHR 0x824C
+#endif
+#ifndef GL_DEBUG_TYPE_PERFORMANCE_KHR
+#define GL_DEBUG_TYPE_PERFORMANCE_KHR 0x8250
+#endif
+#ifndef GL_DEBUG_SEVERITY_HIGH_KHR
+#define GL_DEBUG_SEVERITY_HIGH_KHR 0x9146
+#endif
+#ifndef GL_DEBUG_SEVERITY_MEDIUM_KHR
+#define GL_DEBUG_SEVERITY_MEDIUM_KHR 0x9147
+#endif
+#ifndef GL_DEBUG_SEVERITY_LOW_KHR
+#define GL_DEBUG_SEVERITY_LOW_KHR 0x9148
+#endif
+
+namespace
+{
+	typedef void (GL_APIENTRY *DebugProc)(GLenum source, GLenum type, GLuint id, GLenum severity,
+			GLsizei length, const GLchar* message, const void* userParam);
+	typedef void (GL_APIENTRY *DebugMessageCallbackFunction)(DebugProc callback, const void* userParam);
+
+	enum class DebugMessageKind
+	{
+		Error,
+		Performance,
+		Other
+	};
+
+	const size_t DEBUG_MESSAGE_KIND_COUNT = 3;
+
+	// the sites are linked in when they report their first error
+	std::mutex g_sitesMutex;
+	GLCallSite* g_sites = nullptr;
+
+	// the callback may be called from a driver thread (if the output is not synchronous)
+	std::array<uint64_t, DEBUG_MESSAGE_KIND_COUNT> g_debugMessageCounts;
+	std::mutex g_debugMessageMutex;
+
+	void GL_APIENTRY onDebugMessage(GLenum /* source */, GLenum type, GLuint id, GLenum severity,
+			GLsizei /* length */, const GLchar* message, const void* /* userParam */)
+	{
+		DebugMessageKind kind = DebugMessageKind::Other;
+		if (type == GL_DEBUG_TYPE_ERROR_KHR)
+			kind = DebugMessageKind::Error;
+		else if (type == GL_DEBUG_TYPE_PERFORMANCE_KHR)
+			kind = DebugMessageKind::Performance;
+
+		{
+			std::lock_guard<std::mutex> guard(g_debugMessageMutex);
+			g_debugMessageCounts[static_cast<size_t>(kind)]++;
+		}
+
+		const char* kindName = kind == DebugMessageKind::Error ? "error" : kind == DebugMessageKind::Performance ? "performance" : "info";
+		switch (severity)
+		{
+		case GL_DEBUG_SEVERITY_HIGH_KHR:
+			LOG_ERROR("GL debug (" << kindName << ", id " << id << "): " << message);
+			break;
+		case GL_DEBUG_SEVERITY_MEDIUM_KHR:
+			LOG_WARNING("GL debug (" << kindName << ", id " << id << "): " << message);
+			break;
+		case GL_DEBUG_SEVERITY_LOW_KHR:
+			LOG_INFO("GL debug (" << kindName << ", id " << id << "): " << message);
+			break;
+		default:
+			LOG_DEBUG("GL debug (" << kindName << ", id " << id << "): " << message);
+		}
+	}
+}
+
+unsigned checkGLErrors(GLCallSite& site)
+{
+	unsigned count = 0;
+	GLenum error;
+	// there can be more than one error flag set
+	while ((error = glGetError()) != GL_NO_ERROR)
+	{
+		if (site.errorCount == 0)
+		{
+			std::lock_guard<std::mutex> guard(g_sitesMutex);
+			site.next = g_sites;
+			g_sites = &site;
+		}
+
+		// only the first few errors of a site are logged, the report has the counts
+		if (site.errorCount < 3)
+			LOG_ERROR(getGLErrorName(error) << " after " << site.call << " at " << site.file << ":" << site.line);
+
+		site.errorCount++;
+		count++;
+	}
+
+	return count;
+}
+
+void installGLDebugOutput()
+{
+	if (!hasGLExtension("GL_KHR_debug"))
+	{
+		LOG_INFO("GL_KHR_debug not available, only glGetError is checked");
+		return;
+	}
+
+	DebugMessageCallbackFunction debugMessageCallback =
+			reinterpret_cast<DebugMessageCallbackFunction>(eglGetProcAddress("glDebugMessageCallbackKHR"));
+	if (!debugMessageCallback)
+	{
+		LOG_WARNING("Can't load glDebugMessageCallbackKHR");
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> guard(g_debugMessageMutex);
+		g_debugMessageCounts.fill(0);
+	}
+
+	// synchronous: the messages are logged from the thread (and right after the call) that caused them
+	debugMessageCallback(onDebugMessage, nullptr);
+	glEnable(GL_DEBUG_OUTPUT_KHR);
+	glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS_KHR);
+	LOG_INFO("GL_KHR_debug output enabled");
+}
+
+void reportGLErrors(std::ostream& os)
+{
+	{
+		std::lock_guard<std::mutex> guard(g_debugMessageMutex);
+		os << "GL debug messages: " << g_debugMessageCounts[static_cast<size_t>(DebugMessageKind::Error)] << " errors, "
+		   << g_debugMessageCounts[static_cast<size_t>(DebugMessageKind::Performance)] << " performance warnings, "
+		   << g_debugMessageCounts[static_cast<size_t>(DebugMessageKind::Other)] << " other" << std::endl;
+	}
+
+	std::lock_guard<std::mutex> guard(g_sitesMutex);
+	if (!g_sites)
+	{
+		os << "GL errors: none" << std::endl;
+		return;
+	}
+
+	os << "GL errors by call site:" << std::endl;
+	for (const GLCallSite* site = g_sites; site; site = site->next)
+		os << "  " << site->errorCount << " after " << site->call << " at " << site->file << ":" << site->line << std::endl;
+}
+
+#endif // NDEBUG
@@ -0,0 +1,104 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GL_CHECK_H
+#define GL_CHECK_H
+
+/*
+ * Checked GL calls. In debug builds, GL_CHECK() calls glGetError after the
+ * call, logs the errors and counts them by call site. With NDEBUG defined the
+ * macros expand to the bare call.
+ *
+ *     GL_CHECK(glDrawArrays(GL_TRIANGLES, 0, count));
+ *     const GLuint shader = GL_CHECK_RESULT(glCreateShader(GL_VERTEX_SHADER));
+ *
+ * GL error flags are sticky, so an error of an earlier unchecked call is
+ * attributed to the next checked one. The call sites are meant to be used on
+ * the GL thread only.
+ */
+
+#include <GLES2/gl2.h>
+
+#include <string>
+#include <ostream>
+#include <cstdint>
+
+/** Name of a glGetError() code, e.g. "GL_INVALID_ENUM". */
+std::string getGLErrorName(GLenum error);
+
+#ifndef NDEBUG
+
+struct GLCallSite
+{
+	const char* call;
+	const char* file;
+	int line;
+	uint64_t errorCount;
+	GLCallSite* next; // in the list of the sites that had errors
+};
+
+/** Check and log the pending GL errors, attributing them to the site. Returns the number of errors. */
+unsigned checkGLErrors(GLCallSite& site);
+
+template<typename T>
+T checkGLResult(T result, GLCallSite& site)
+{
+	checkGLErrors(site);
+	return result;
+}
+
+/**
+ * Log the GL_KHR_debug messages of the driver (including performance warnings), if the extension
+ * is available. A GL context must be current.
+ */
+void installGLDebugOutput();
+
+/** Write the error counts by call site and the counts of the driver's debug messages. */
+void reportGLErrors(std::ostream& os);
+
+#define GL_CHECK_SITE(call) static GLCallSite glCallSite = { #call, __FILE__, __LINE__, 0, nullptr }
+
+#define GL_CHECK(call) \
+	do \
+	{ \
+		call; \
+		GL_CHECK_SITE(call); \
+		checkGLErrors(glCallSite); \
+	} while (false)
+
+#define GL_CHECK_RESULT(call) \
+	([&]() -> decltype(call) \
+	{ \
+		GL_CHECK_SITE(call); \
+		return checkGLResult(call, glCallSite); \
+	}())
+
+#else
+
+inline void installGLDebugOutput()
+{}
+
+inline void reportGLErrors(std::ostream&)
+{}
+
+#define GL_CHECK(call) call
+#define GL_CHECK_RESULT(call) call
+
+#endif // NDEBUG
+
+#endif // GL_CHECK_H
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "GLCounters.h"
+
+namespace
+{
+	GLCounts& getCounts()
+	{
+		static GLCounts counts = GLCounts();
+		return counts;
+	}
+}
+
+void countGL(GLCounter counter, uint64_t n)
+{
+	getCounts()[static_cast<size_t>(counter)] += n;
+}
+
+const GLCounts& getGLCounts()
+{
+	return getCounts();
+}
+
+const char* getGLCounterName(GLCounter counter)
+{
+	switch (counter)
+	{
+	case GLCounter::DrawCalls:
+		return "drawCalls";
+	case GLCounter::Vertices:
+		return "vertices";
+	case GLCounter::TextureBinds:
+		return "textureBinds";
+	case GLCounter::ProgramBinds:
+		return "programBinds";
+	case GLCounter::UniformUpdates:
+		return "uniformUpdates";
+	case GLCounter::BufferUploads:
+		return "bufferUploads";
+	case GLCounter::TextureUploads:
+		return "textureUploads";
+	case GLCounter::UploadedBytes:
+		return "uploadedBytes";
+	}
+
+	return "unknown";
+}
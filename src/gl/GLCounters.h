@@ -0,0 +1,54 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GL_COUNTERS_H
+#define GL_COUNTERS_H
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Counts of the GL work submitted, for the benchmarks. Unlike GL_CHECK these
+ * are kept in release builds too (it's an increment per call). Only to be used
+ * on the GL thread.
+ */
+enum class GLCounter
+{
+	DrawCalls,
+	Vertices,
+	TextureBinds,
+	ProgramBinds,
+	UniformUpdates,
+	BufferUploads,
+	TextureUploads,
+	UploadedBytes
+};
+
+const size_t GL_COUNTER_COUNT = 8;
+
+typedef std::array<uint64_t, GL_COUNTER_COUNT> GLCounts;
+
+void countGL(GLCounter counter, uint64_t n = 1);
+
+/** The counts since the start of the program. */
+const GLCounts& getGLCounts();
+
+const char* getGLCounterName(GLCounter counter);
+
+#endif // GL_COUNTERS_H
@@ -0,0 +1,234 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "GLObjectPool.h"
+#include "GLCheck.h"
+#include "../Log.h"
+
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+	// how many texture/buffer names are generated at once
+	const GLsizei GEN_BATCH_SIZE = 16;
+
+	const char* getTypeName(GLObjectType type)
+	{
+		switch (type)
+		{
+		case GLObjectType::Texture:
+			return "texture";
+		case GLObjectType::Buffer:
+			return "buffer";
+		case GLObjectType::Shader:
+			return "shader";
+		case GLObjectType::Program:
+			return "program";
+		}
+
+		return "unknown";
+	}
+
+	uint32_t nextGeneration(uint32_t generation)
+	{
+		// 0 is reserved for the null handle
+		return generation + 1 == 0 ? 1 : generation + 1;
+	}
+}
+
+GLObjectPool::GLObjectPool()
+{
+	m_statistics.genCalls = 0;
+	m_statistics.deleteCalls = 0;
+	m_statistics.createdCount = 0;
+	m_statistics.deletedCount = 0;
+	m_statistics.liveCount = 0;
+	m_statistics.pendingDeleteCount = 0;
+}
+
+GLObjectPool& GLObjectPool::get()
+{
+	static GLObjectPool pool;
+	return pool;
+}
+
+GLHandle GLObjectPool::create(GLObjectType type, GLenum shaderType)
+{
+	std::lock_guard<std::mutex> guard(m_mutex);
+
+	const GLuint name = createName(type, shaderType);
+
+	GLHandle handle;
+	if (m_freeSlots.empty())
+	{
+		const Slot slot = { type, name, 1 };
+		handle.index = m_slots.size();
+		m_slots.push_back(slot);
+	}
+	else
+	{
+		handle.index = m_freeSlots.back();
+		m_freeSlots.pop_back();
+
+		Slot& slot = m_slots[handle.index];
+		slot.type = type;
+		slot.name = name;
+	}
+
+	handle.generation = m_slots[handle.index].generation;
+	handle.name = name;
+	m_statistics.createdCount++;
+	m_statistics.liveCount++;
+	return handle;
+}
+
+void GLObjectPool::release(GLHandle handle)
+{
+	if (handle.isNull())
+		return;
+
+	std::lock_guard<std::mutex> guard(m_mutex);
+
+	// always checked: a double release would delete a name that may already belong to another object
+	if (handle.index >= m_slots.size() || m_slots[handle.index].generation != handle.generation)
+	{
+		LOG_ERROR("GLObjectPool: release of a stale handle (slot " << handle.index << ", generation " << handle.generation << ")");
+		return;
+	}
+
+	Slot& slot = m_slots[handle.index];
+	m_pendingDeletes[static_cast<size_t>(slot.type)].push_back(slot.name);
+	slot.name = 0;
+	slot.generation = nextGeneration(slot.generation);
+	m_freeSlots.push_back(handle.index);
+
+	m_statistics.liveCount--;
+	m_statistics.pendingDeleteCount++;
+}
+
+GLuint GLObjectPool::resolveChecked(GLHandle handle) const
+{
+	std::lock_guard<std::mutex> guard(m_mutex);
+	return getSlot(handle).name;
+}
+
+void GLObjectPool::flush()
+{
+	std::lock_guard<std::mutex> guard(m_mutex);
+	if (m_statistics.pendingDeleteCount == 0)
+		return;
+
+	for (size_t i = 0; i < TYPE_COUNT; i++)
+	{
+		std::vector<GLuint>& names = m_pendingDeletes[i];
+		if (names.empty())
+			continue;
+
+		switch (static_cast<GLObjectType>(i))
+		{
+		case GLObjectType::Texture:
+			GL_CHECK(glDeleteTextures(names.size(), names.data()));
+			m_statistics.deleteCalls++;
+			break;
+		case GLObjectType::Buffer:
+			GL_CHECK(glDeleteBuffers(names.size(), names.data()));
+			m_statistics.deleteCalls++;
+			break;
+		case GLObjectType::Shader:
+			for (GLuint name: names)
+				GL_CHECK(glDeleteShader(name));
+			m_statistics.deleteCalls += names.size();
+			break;
+		case GLObjectType::Program:
+			for (GLuint name: names)
+				GL_CHECK(glDeleteProgram(name));
+			m_statistics.deleteCalls += names.size();
+			break;
+		}
+
+		m_statistics.deletedCount += names.size();
+		names.clear();
+	}
+
+	m_statistics.pendingDeleteCount = 0;
+}
+
+GLObjectPool::Statistics GLObjectPool::getStatistics() const
+{
+	std::lock_guard<std::mutex> guard(m_mutex);
+	return m_statistics;
+}
+
+void GLObjectPool::report(std::ostream& os) const
+{
+	const Statistics statistics = getStatistics();
+	os << "GL objects: " << statistics.liveCount << " live, " << statistics.createdCount << " created ("
+	   << statistics.genCalls << " glGen* calls), " << statistics.deletedCount << " deleted ("
+	   << statistics.deleteCalls << " glDelete* calls), " << statistics.pendingDeleteCount << " pending deletion" << std::endl;
+}
+
+GLuint GLObjectPool::createName(GLObjectType type, GLenum shaderType)
+{
+	GLuint name = 0;
+	switch (type)
+	{
+	case GLObjectType::Texture:
+	case GLObjectType::Buffer:
+		{
+			std::vector<GLuint>& reserve = m_reserve[static_cast<size_t>(type)];
+			if (reserve.empty())
+			{
+				reserve.resize(GEN_BATCH_SIZE);
+				if (type == GLObjectType::Texture)
+					GL_CHECK(glGenTextures(GEN_BATCH_SIZE, reserve.data()));
+				else
+					GL_CHECK(glGenBuffers(GEN_BATCH_SIZE, reserve.data()));
+				m_statistics.genCalls++;
+			}
+
+			name = reserve.back();
+			reserve.pop_back();
+		}
+		break;
+
+	case GLObjectType::Shader:
+		name = GL_CHECK_RESULT(glCreateShader(shaderType));
+		break;
+
+	case GLObjectType::Program:
+		name = GL_CHECK_RESULT(glCreateProgram());
+		break;
+	}
+
+	if (name == 0)
+		throw std::runtime_error(std::string("Can't create a new ") + getTypeName(type) + ".");
+
+	return name;
+}
+
+const GLObjectPool::Slot& GLObjectPool::getSlot(GLHandle handle) const
+{
+#ifndef NDEBUG
+	if (handle.isNull() || handle.index >= m_slots.size() || m_slots[handle.index].generation != handle.generation)
+		throw std::runtime_error("Use of a stale or null GL handle (slot " + std::to_string(handle.index)
+				+ ", generation " + std::to_string(handle.generation) + ")");
+#endif
+
+	return m_slots[handle.index];
+}
@@ -0,0 +1,150 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GL_OBJECT_POOL_H
+#define GL_OBJECT_POOL_H
+
+#include <GLES2/gl2.h>
+
+#include <array>
+#include <vector>
+#include <mutex>
+#include <ostream>
+#include <cstdint>
+#include <cstddef>
+
+enum class GLObjectType
+{
+	Texture,
+	Buffer,
+	Shader,
+	Program
+};
+
+/**
+ * Reference to a GL object in the GLObjectPool. The default value is the null handle.
+ *
+ * The handle carries the GL name too: the name of a live object never changes,
+ * so resolving it needs no lookup.
+ */
+struct GLHandle
+{
+	GLHandle():
+		index(0),
+		generation(0),
+		name(0)
+	{}
+
+	bool isNull() const
+	{
+		return generation == 0;
+	}
+
+	uint32_t index;
+	uint32_t generation; // 0: null
+	GLuint name;
+};
+
+/**
+ * Owner of the GL object names, referenced by generational handles.
+ *
+ * Texture and buffer names are generated in batches. Released objects are only
+ * queued and deleted (in batches too) by flush(), which the render loop calls at a
+ * point where the GPU is done with them; so a wrapper can be destroyed on any thread.
+ * A released handle becomes stale: the generation of its slot changes. Using a stale
+ * handle throws std::runtime_error in debug builds (it is not checked with NDEBUG).
+ *
+ * create() and flush() need the GL context current, the rest can be called from any thread.
+ */
+class GLObjectPool
+{
+public:
+	struct Statistics
+	{
+		uint64_t genCalls; // glGenTextures/glGenBuffers
+		uint64_t deleteCalls; // all the glDelete* calls
+		uint64_t createdCount;
+		uint64_t deletedCount;
+		size_t liveCount;
+		size_t pendingDeleteCount;
+	};
+
+	static GLObjectPool& get();
+
+	/**
+	 * Create a new GL object.
+	 * @param shaderType GL_VERTEX_SHADER or GL_FRAGMENT_SHADER for a shader, ignored otherwise.
+	 */
+	GLHandle create(GLObjectType type, GLenum shaderType = 0);
+
+	/** Queue the object for deletion. Releasing a null (or stale) handle does nothing. */
+	void release(GLHandle handle);
+
+	/**
+	 * The GL name of a live object. Called on every bind: with NDEBUG it just returns
+	 * the name in the handle, without locking.
+	 */
+	GLuint resolve(GLHandle handle) const
+	{
+#ifdef NDEBUG
+		return handle.name;
+#else
+		return resolveChecked(handle);
+#endif
+	}
+
+	/** Delete the released objects. */
+	void flush();
+
+	Statistics getStatistics() const;
+	void report(std::ostream& os) const;
+
+	// disallow copy and move
+	GLObjectPool& operator=(GLObjectPool&&) = delete;
+	GLObjectPool(GLObjectPool&&) = delete;
+	GLObjectPool& operator=(const GLObjectPool&) = delete;
+	GLObjectPool(const GLObjectPool&) = delete;
+
+private:
+	static const size_t TYPE_COUNT = 4;
+
+	struct Slot
+	{
+		GLObjectType type;
+		GLuint name;
+		uint32_t generation;
+	};
+
+	GLObjectPool();
+
+	GLuint resolveChecked(GLHandle handle) const;
+	GLuint createName(GLObjectType type, GLenum shaderType);
+	const Slot& getSlot(GLHandle handle) const;
+
+	mutable std::mutex m_mutex;
+	std::vector<Slot> m_slots;
+	std::vector<uint32_t> m_freeSlots;
+
+	// names generated ahead, only textures and buffers (shaders and programs are created one by one)
+	std::array<std::vector<GLuint>, TYPE_COUNT> m_reserve;
+	std::array<std::vector<GLuint>, TYPE_COUNT> m_pendingDeletes;
+
+	Statistics m_statistics;
+};
+
+#endif // GL_OBJECT_POOL_H
@@ -0,0 +1,289 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "GpuProfiler.h"
+#include "Extensions.h"
+#include "../Log.h"
+
+#include <EGL/egl.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <cstring>
+
+// GL_EXT_disjoint_timer_query, in case gl2ext.h is too old to have it
+#ifndef GL_QUERY_COUNTER_BITS_EXT
+#define GL_QUERY_COUNTER_BITS_EXT 0x8864
+#endif
+#ifndef GL_QUERY_RESULT_EXT
+#define GL_QUERY_RESULT_EXT 0x8866
+#endif
+#ifndef GL_QUERY_RESULT_AVAILABLE_EXT
+#define GL_QUERY_RESULT_AVAILABLE_EXT 0x8867
+#endif
+#ifndef GL_TIME_ELAPSED_EXT
+#define GL_TIME_ELAPSED_EXT 0x88BF
+#endif
+#ifndef GL_GPU_DISJOINT_EXT
+#define GL_GPU_DISJOINT_EXT 0x8FBB
+#endif
+
+namespace
+{
+	const char TIMER_QUERY_EXTENSION[] = "GL_EXT_disjoint_timer_query";
+
+	// how many query objects are created at once when the pool runs out
+	const GLsizei QUERY_BATCH_SIZE = 8;
+
+	template<typename FUNCTION>
+	bool loadFunction(FUNCTION& function, const char* name)
+	{
+		function = reinterpret_cast<FUNCTION>(eglGetProcAddress(name));
+		return function != nullptr;
+	}
+}
+
+GpuProfiler::GpuProfiler():
+	m_available(false),
+	m_genQueries(nullptr),
+	m_deleteQueries(nullptr),
+	m_beginQuery(nullptr),
+	m_endQuery(nullptr),
+	m_getQueryiv(nullptr),
+	m_getQueryObjectuiv(nullptr),
+	m_getQueryObjectui64v(nullptr),
+	m_oldestFrame(0),
+	m_pendingFrameCount(0),
+	m_inPass(false)
+{
+	reset();
+
+	if (!hasGLExtension(TIMER_QUERY_EXTENSION))
+	{
+		LOG_INFO("GPU timing not available: " << TIMER_QUERY_EXTENSION << " not supported");
+		return;
+	}
+
+	const bool loaded = loadFunction(m_genQueries, "glGenQueriesEXT")
+			&& loadFunction(m_deleteQueries, "glDeleteQueriesEXT")
+			&& loadFunction(m_beginQuery, "glBeginQueryEXT")
+			&& loadFunction(m_endQuery, "glEndQueryEXT")
+			&& loadFunction(m_getQueryiv, "glGetQueryivEXT")
+			&& loadFunction(m_getQueryObjectuiv, "glGetQueryObjectuivEXT")
+			&& loadFunction(m_getQueryObjectui64v, "glGetQueryObjectui64vEXT");
+	if (!loaded)
+	{
+		LOG_WARNING("GPU timing not available: can't load the " << TIMER_QUERY_EXTENSION << " functions");
+		return;
+	}
+
+	// an implementation may advertise the extension without a usable timer
+	GLint counterBits = 0;
+	m_getQueryiv(GL_TIME_ELAPSED_EXT, GL_QUERY_COUNTER_BITS_EXT, &counterBits);
+	if (counterBits == 0)
+	{
+		LOG_INFO("GPU timing not available: the timer has no bits");
+		return;
+	}
+
+	// reading the flag clears it
+	GLint disjoint = 0;
+	glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+
+	m_available = true;
+	LOG_INFO("GPU timing enabled (" << counterBits << " bit timer)");
+}
+
+GpuProfiler::~GpuProfiler()
+{
+	if (!m_available)
+		return;
+
+	for (const Frame& frame: m_frames)
+	{
+		for (const PendingQuery& pending: frame)
+			m_freeQueries.push_back(pending.query);
+	}
+
+	if (!m_freeQueries.empty())
+		m_deleteQueries(m_freeQueries.size(), m_freeQueries.data());
+}
+
+void GpuProfiler::beginFrame()
+{
+	if (!m_available)
+		return;
+
+	// the results of a frame are read only once all of them are available
+	size_t readyFrameCount = 0;
+	while (readyFrameCount < m_pendingFrameCount && isFrameAvailable(getFrame(readyFrameCount)))
+	{
+		for (PendingQuery& pending: getFrame(readyFrameCount))
+			m_getQueryObjectui64v(pending.query, GL_QUERY_RESULT_EXT, &pending.elapsed);
+
+		readyFrameCount++;
+	}
+
+	// the flag is checked after reading the results: if it's set, any of them may be bogus (and so may be the ones still in flight)
+	GLint disjoint = 0;
+	glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+	if (disjoint)
+	{
+		m_disjointFrameCount += m_pendingFrameCount;
+		while (m_pendingFrameCount > 0)
+			recycleOldestFrame();
+
+		return;
+	}
+
+	for (size_t i = 0; i < readyFrameCount; i++)
+	{
+		for (const PendingQuery& pending: getFrame(0))
+		{
+			PassStatistics& pass = m_passes[pending.pass];
+			pass.count++;
+			pass.sum += pending.elapsed;
+			pass.max = std::max(pass.max, pending.elapsed);
+		}
+
+		m_frameCount++;
+		recycleOldestFrame();
+	}
+
+	// don't wait indefinitely for a slow GPU
+	if (m_pendingFrameCount == MAX_PENDING_FRAMES)
+	{
+		m_droppedFrameCount++;
+		recycleOldestFrame();
+	}
+}
+
+void GpuProfiler::endFrame()
+{
+	if (m_inPass)
+		throw std::runtime_error("GpuProfiler::endFrame called inside a pass");
+
+	if (m_available && !getFrame(m_pendingFrameCount).empty())
+		m_pendingFrameCount++;
+}
+
+void GpuProfiler::beginPass(const char* name)
+{
+	if (m_inPass)
+		throw std::runtime_error(std::string("GPU profiler passes can't be nested: ") + name);
+
+	m_inPass = true;
+	if (!m_available)
+		return;
+
+	if (m_freeQueries.empty())
+	{
+		m_freeQueries.resize(QUERY_BATCH_SIZE);
+		m_genQueries(QUERY_BATCH_SIZE, m_freeQueries.data());
+	}
+
+	const PendingQuery pending = { getPassIndex(name), m_freeQueries.back(), 0 };
+	m_freeQueries.pop_back();
+
+	m_beginQuery(GL_TIME_ELAPSED_EXT, pending.query);
+	getFrame(m_pendingFrameCount).push_back(pending);
+}
+
+void GpuProfiler::endPass()
+{
+	if (!m_inPass)
+		throw std::runtime_error("GpuProfiler::endPass called outside a pass");
+
+	m_inPass = false;
+	if (m_available)
+		m_endQuery(GL_TIME_ELAPSED_EXT);
+}
+
+void GpuProfiler::reset()
+{
+	// the pass names are kept, so that the indices of the pending queries stay valid
+	for (PassStatistics& pass: m_passes)
+	{
+		pass.count = 0;
+		pass.sum = 0;
+		pass.max = 0;
+	}
+
+	m_frameCount = 0;
+	m_disjointFrameCount = 0;
+	m_droppedFrameCount = 0;
+}
+
+void GpuProfiler::report(std::ostream& os) const
+{
+	if (!m_available)
+	{
+		os << "GPU time: not available" << std::endl;
+		return;
+	}
+
+	const double MS = 1e6;
+	os << "GPU time: " << m_frameCount << " frames (" << m_disjointFrameCount << " discarded as disjoint, "
+	   << m_droppedFrameCount << " dropped as late)" << std::endl;
+	for (const PassStatistics& pass: m_passes)
+	{
+		os << "  " << pass.name << ": ";
+		if (pass.count == 0)
+			os << "no samples" << std::endl;
+		else
+			os << "mean " << pass.sum / pass.count / MS << " ms, max " << pass.max / MS << " ms" << std::endl;
+	}
+}
+
+bool GpuProfiler::isFrameAvailable(const Frame& frame) const
+{
+	for (const PendingQuery& pending: frame)
+	{
+		GLuint available = GL_FALSE;
+		m_getQueryObjectuiv(pending.query, GL_QUERY_RESULT_AVAILABLE_EXT, &available);
+		if (!available)
+			return false;
+	}
+
+	return true;
+}
+
+void GpuProfiler::recycleOldestFrame()
+{
+	Frame& frame = getFrame(0);
+	for (const PendingQuery& pending: frame)
+		m_freeQueries.push_back(pending.query);
+
+	frame.clear();
+	m_oldestFrame = (m_oldestFrame + 1) % m_frames.size();
+	m_pendingFrameCount--;
+}
+
+size_t GpuProfiler::getPassIndex(const char* name)
+{
+	for (size_t i = 0; i < m_passes.size(); i++)
+	{
+		if (m_passes[i].name == name || std::strcmp(m_passes[i].name, name) == 0)
+			return i;
+	}
+
+	const PassStatistics pass = { name, 0, 0, 0 };
+	m_passes.push_back(pass);
+	return m_passes.size() - 1;
+}
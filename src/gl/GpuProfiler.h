@@ -0,0 +1,139 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GL_GPU_PROFILER_H
+#define GL_GPU_PROFILER_H
+
+#include <GLES2/gl2.h>
+
+#include <vector>
+#include <array>
+#include <ostream>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Measures the GPU time of render passes using GL_EXT_disjoint_timer_query.
+ *
+ * The query objects come from a pool and are reused across frames. The results
+ * are read back only when they are available (typically a few frames later), so
+ * the pipeline is never stalled. If the GPU reports a disjoint operation (e.g.
+ * a frequency change), all the results in flight are discarded.
+ *
+ * Without the extension, all the methods are no-ops and the report says so.
+ * A GL context must be current when the profiler is created, used and destroyed.
+ */
+class GpuProfiler
+{
+public:
+	struct PassStatistics
+	{
+		const char* name;
+		uint64_t count;
+		uint64_t sum; // ns
+		uint64_t max; // ns
+	};
+
+	GpuProfiler();
+	~GpuProfiler();
+
+	bool isAvailable() const
+	{
+		return m_available;
+	}
+
+	/**
+	 * Collect the results of the earlier frames. Call once per frame, before the first pass.
+	 */
+	void beginFrame();
+	void endFrame();
+
+	/**
+	 * Measure the GL commands issued until endPass(). Passes can't be nested.
+	 * @param name Must outlive the profiler (a string literal).
+	 */
+	void beginPass(const char* name);
+	void endPass();
+
+	const std::vector<PassStatistics>& getPasses() const
+	{
+		return m_passes;
+	}
+
+	void reset();
+	void report(std::ostream& os) const;
+
+	// disallow copy and move
+	GpuProfiler& operator=(GpuProfiler&&) = delete;
+	GpuProfiler(GpuProfiler&&) = delete;
+	GpuProfiler& operator=(const GpuProfiler&) = delete;
+	GpuProfiler(const GpuProfiler&) = delete;
+
+private:
+	// how many frames can wait for their results; the oldest one is dropped if it takes longer
+	static const size_t MAX_PENDING_FRAMES = 4;
+
+	typedef void (GL_APIENTRY *GenQueriesFunction)(GLsizei n, GLuint* ids);
+	typedef void (GL_APIENTRY *DeleteQueriesFunction)(GLsizei n, const GLuint* ids);
+	typedef void (GL_APIENTRY *BeginQueryFunction)(GLenum target, GLuint id);
+	typedef void (GL_APIENTRY *EndQueryFunction)(GLenum target);
+	typedef void (GL_APIENTRY *GetQueryivFunction)(GLenum target, GLenum pname, GLint* params);
+	typedef void (GL_APIENTRY *GetQueryObjectuivFunction)(GLuint id, GLenum pname, GLuint* params);
+	typedef void (GL_APIENTRY *GetQueryObjectui64vFunction)(GLuint id, GLenum pname, uint64_t* params);
+
+	struct PendingQuery
+	{
+		size_t pass; // index to m_passes
+		GLuint query;
+		uint64_t elapsed; // ns, once read back
+	};
+
+	typedef std::vector<PendingQuery> Frame;
+
+	Frame& getFrame(size_t age)
+	{
+		return m_frames[(m_oldestFrame + age) % m_frames.size()];
+	}
+
+	bool isFrameAvailable(const Frame& frame) const;
+	void recycleOldestFrame();
+	size_t getPassIndex(const char* name);
+
+	bool m_available;
+	GenQueriesFunction m_genQueries;
+	DeleteQueriesFunction m_deleteQueries;
+	BeginQueryFunction m_beginQuery;
+	EndQueryFunction m_endQuery;
+	GetQueryivFunction m_getQueryiv;
+	GetQueryObjectuivFunction m_getQueryObjectuiv;
+	GetQueryObjectui64vFunction m_getQueryObjectui64v;
+
+	std::vector<GLuint> m_freeQueries;
+	// the pending frames (oldest first) followed by the frame being recorded
+	std::array<Frame, MAX_PENDING_FRAMES + 1> m_frames;
+	size_t m_oldestFrame;
+	size_t m_pendingFrameCount;
+	bool m_inPass;
+
+	std::vector<PassStatistics> m_passes;
+	uint64_t m_frameCount; // frames with results
+	uint64_t m_disjointFrameCount;
+	uint64_t m_droppedFrameCount;
+};
+
+#endif // GL_GPU_PROFILER_H
@@ -17,37 +17,41 @@
  * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "Program.h"
+#include "GLCheck.h"
 #include "../Exceptions.h"
+#include "../Trace.h"
 
 #include <stdexcept>
 #include <memory>
 
-Program::Program(const Shader& vertexShader, const Shader& fragmentShader):
-	m_isLinked(false)
+Program::Program(const Shader& vertexShader, const Shader& fragmentShader, const std::string& name):
+	m_isLinked(false),
+	m_program(GLObjectPool::get().create(GLObjectType::Program)),
+	m_memory(MemoryCategory::Program, name)
 {
-	m_program = glCreateProgram();
-	if (m_program == 0)
-		throw std::runtime_error("Can't create a new program.");
-
 	// no need to keep the shaders, OpenGL keeps them alive as long as the program lives
-	glAttachShader(m_program, vertexShader.getGLShader());
-	glAttachShader(m_program, fragmentShader.getGLShader());
+	const GLuint program = getGLProgram();
+	GL_CHECK(glAttachShader(program, vertexShader.getGLShader()));
+	GL_CHECK(glAttachShader(program, fragmentShader.getGLShader()));
 }
 
 void Program::link()
 {
-	glLinkProgram(m_program);
+	TRACE_SCOPE("Program::link");
+
+	const GLuint program = getGLProgram();
+	GL_CHECK(glLinkProgram(program));
 
 	GLint isLinked = 0;
-	glGetProgramiv(m_program, GL_LINK_STATUS, &isLinked);
+	glGetProgramiv(program, GL_LINK_STATUS, &isLinked);
 	if (isLinked == 0)
 	{
 		GLint infoLogLen = 0;
-		glGetProgramiv(m_program, GL_INFO_LOG_LENGTH, &infoLogLen);
+		glGetProgramiv(program, GL_INFO_LOG_LENGTH, &infoLogLen);
 		if (infoLogLen > 0)
 		{
 			std::unique_ptr<char[]> infoLog(new char[infoLogLen]);
-			glGetProgramInfoLog(m_program, infoLogLen, nullptr, infoLog.get());
+			glGetProgramInfoLog(program, infoLogLen, nullptr, infoLog.get());
 			throw std::runtime_error(std::string("Can't link program: ") + infoLog.get());
 		}
 		throw std::runtime_error("Can't link program: no error info available");
@@ -61,7 +65,7 @@ GLuint Program::getAttribute(const char* name)
 	if (!m_isLinked)
 		throw std::runtime_error("getAttribute() can only be called after the program has been linked");
 
-	GLint index = glGetAttribLocation(m_program, name);
+	GLint index = glGetAttribLocation(getGLProgram(), name);
 	if (index < 0)
 	{
 		throw GLError(std::string("Can't get location of attribute '") + name + "'");
@@ -75,7 +79,7 @@ GLuint Program::getUniform(const char* name)
 	if (!m_isLinked)
 		throw std::runtime_error("getUniform() can only be called after the program has been linked");
 
-	GLint index = glGetUniformLocation(m_program, name);
+	GLint index = glGetUniformLocation(getGLProgram(), name);
 	if (index < 0)
 	{
 		throw GLError(std::string("Can't get location of uniform '") + name + "'");
@@ -86,5 +90,27 @@ GLuint Program::getUniform(const char* name)
 
 Program::~Program()
 {
-	glDeleteProgram(m_program);
+	GLObjectPool::get().release(m_program);
+}
+
+Program::Program(Program&& other):
+	m_isLinked(other.m_isLinked),
+	m_program(other.m_program),
+	m_memory(std::move(other.m_memory))
+{
+	other.m_program = GLHandle();
+}
+
+Program& Program::operator=(Program&& other)
+{
+	if (this != &other)
+	{
+		GLObjectPool::get().release(m_program);
+		m_isLinked = other.m_isLinked;
+		m_program = other.m_program;
+		other.m_program = GLHandle();
+		m_memory = std::move(other.m_memory);
+	}
+
+	return *this;
 }
@@ -20,13 +20,20 @@
 #define GL_PROGRAM_H
 
 #include "Shader.h"
+#include "../MemoryTracker.h"
+#include "GLObjectPool.h"
 
 #include <GLES2/gl2.h>
 
+#include <string>
+
 class Program
 {
 public:
-	Program(const Shader& vertexShader, const Shader& fragmentShader);
+	/**
+	 * The program is accounted in the MemoryTracker by count only, its driver memory is unknown.
+	 */
+	Program(const Shader& vertexShader, const Shader& fragmentShader, const std::string& name = std::string());
 	~Program();
 
 	void link();
@@ -36,18 +43,19 @@ public:
 
 	GLuint getGLProgram() const
 	{
-		return m_program;
+		return GLObjectPool::get().resolve(m_program);
 	}
 
 	// allow move, disallow copy
-	Program& operator=(Program&&) = default;
-	Program(Program&&) = default;
+	Program& operator=(Program&& other);
+	Program(Program&& other);
 	Program& operator=(const Program&) = delete;
 	Program(const Program&) = delete;
 
 private:
 	bool m_isLinked;
-	GLuint m_program;
+	GLHandle m_program;
+	TrackedMemory m_memory;
 };
 
 #endif // GL_PROGRAM_H
@@ -17,8 +17,12 @@
  * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "Shader.h"
+#include "GLCheck.h"
+#include "../Trace.h"
+
 #include <stdexcept>
 #include <memory>
+#include <cstring>
 
 static GLenum getGLShaderType(ShaderType type)
 {
@@ -33,32 +37,57 @@ static GLenum getGLShaderType(ShaderType type)
 	throw std::runtime_error("getGLShaderType: unexpected shader type " + std::to_string(static_cast<int>(type)));
 }
 
-Shader::Shader(ShaderType type, const char* program)
+Shader::Shader(ShaderType type, const char* program, const std::string& name):
+	m_shader(GLObjectPool::get().create(GLObjectType::Shader, getGLShaderType(type))),
+	m_memory(MemoryCategory::Shader, name, std::strlen(program))
 {
-	m_shader = glCreateShader(getGLShaderType(type));
-	if (m_shader == 0)
-		throw std::runtime_error("Can't create a new shader.");
+	TRACE_SCOPE("Shader compile");
 
-	glShaderSource(m_shader, 1, &program, nullptr);
-	glCompileShader(m_shader);
+	const GLuint shader = getGLShader();
+	GL_CHECK(glShaderSource(shader, 1, &program, nullptr));
+	GL_CHECK(glCompileShader(shader));
 
 	GLint isCompiled = 0;
-	glGetShaderiv(m_shader, GL_COMPILE_STATUS, &isCompiled);
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &isCompiled);
 	if (isCompiled == 0)
 	{
+		std::string error("no error info available");
 		GLint infoLogLen = 0;
-		glGetShaderiv(m_shader, GL_INFO_LOG_LENGTH, &infoLogLen);
+		glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &infoLogLen);
 		if (infoLogLen > 0)
 		{
 			std::unique_ptr<char[]> infoLog(new char[infoLogLen]);
-			glGetShaderInfoLog(m_shader, infoLogLen, nullptr, infoLog.get());
-			throw std::runtime_error(std::string("Can't compile shader: ") + infoLog.get());
+			glGetShaderInfoLog(shader, infoLogLen, nullptr, infoLog.get());
+			error = infoLog.get();
 		}
-		throw std::runtime_error("Can't compile shader: no error info available");
+
+		// the destructor won't run
+		GLObjectPool::get().release(m_shader);
+		throw std::runtime_error("Can't compile shader: " + error);
 	}
 }
 
 Shader::~Shader()
 {
-	glDeleteShader(m_shader);
+	GLObjectPool::get().release(m_shader);
+}
+
+Shader::Shader(Shader&& other):
+	m_shader(other.m_shader),
+	m_memory(std::move(other.m_memory))
+{
+	other.m_shader = GLHandle();
+}
+
+Shader& Shader::operator=(Shader&& other)
+{
+	if (this != &other)
+	{
+		GLObjectPool::get().release(m_shader);
+		m_shader = other.m_shader;
+		other.m_shader = GLHandle();
+		m_memory = std::move(other.m_memory);
+	}
+
+	return *this;
 }
@@ -19,8 +19,13 @@
 #ifndef GL_SHADER_H
 #define GL_SHADER_H
 
+#include "../MemoryTracker.h"
+#include "GLObjectPool.h"
+
 #include <GLES2/gl2.h>
 
+#include <string>
+
 enum class ShaderType
 {
 	Vertex,
@@ -30,22 +35,26 @@ enum class ShaderType
 class Shader
 {
 public:
-	Shader(ShaderType type, const char* program);
+	/**
+	 * The source size is accounted in the MemoryTracker as an estimate of the driver memory.
+	 */
+	Shader(ShaderType type, const char* program, const std::string& name = std::string());
 	~Shader();
 
 	GLuint getGLShader() const
 	{
-		return m_shader;
+		return GLObjectPool::get().resolve(m_shader);
 	}
 
 	// allow move, disallow copy
-	Shader& operator=(Shader&&) = default;
-	Shader(Shader&&) = default;
+	Shader& operator=(Shader&& other);
+	Shader(Shader&& other);
 	Shader& operator=(const Shader&) = delete;
 	Shader(const Shader&) = delete;
 
 private:
-	GLuint m_shader;
+	GLHandle m_shader;
+	TrackedMemory m_memory;
 };
 
 #endif // GL_SHADER_H
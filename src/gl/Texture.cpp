@@ -17,22 +17,103 @@
  * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "Texture.h"
+#include "GLCheck.h"
+#include "GLCounters.h"
+#include "../Trace.h"
+
 #include <stdexcept>
 
-Texture2D::Texture2D(const Image &image)
+Texture2D::Texture2D(const Image &image, const std::string& name):
+	m_memory(MemoryCategory::Texture, name)
 {
-	glGenTextures(1, &m_texture);
-	if (m_texture == 0)
-		throw std::runtime_error("Can't create a new texture.");
-
-	glBindTexture(GL_TEXTURE_2D, m_texture);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, image.getWidth(), image.getHeight(), 0, GL_RGBA, GL_UNSIGNED_BYTE, image.getData());
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-	glGenerateMipmap(GL_TEXTURE_2D);
+	TRACE_SCOPE("Texture2D upload");
+
+	create();
+
+	GL_CHECK(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, image.getWidth(), image.getHeight(), 0, GL_RGBA, GL_UNSIGNED_BYTE, image.getData()));
+	GL_CHECK(glGenerateMipmap(GL_TEXTURE_2D));
+	countGL(GLCounter::TextureUploads);
+	countGL(GLCounter::UploadedBytes, image.getSize());
+
+	// the whole mipmap chain takes about 4/3 of the base level
+	m_memory.resize(image.getSize() + image.getSize() / 3);
+}
+
+Texture2D::Texture2D(const std::vector<Image>& levels, const std::string& name):
+	m_memory(MemoryCategory::Texture, name)
+{
+	TRACE_SCOPE("Texture2D upload");
+
+	if (levels.empty())
+		throw std::runtime_error("Can't create a texture without any image data.");
+
+	create();
+
+	size_t memorySize = 0;
+	for (size_t level = 0; level < levels.size(); level++)
+	{
+		const Image& image = levels[level];
+		GL_CHECK(glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA, image.getWidth(), image.getHeight(), 0, GL_RGBA, GL_UNSIGNED_BYTE, image.getData()));
+		memorySize += image.getSize();
+	}
+	countGL(GLCounter::TextureUploads, levels.size());
+	countGL(GLCounter::UploadedBytes, memorySize);
+
+	if (levels.size() == 1)
+	{
+		GL_CHECK(glGenerateMipmap(GL_TEXTURE_2D));
+		memorySize += memorySize / 3;
+	}
+
+	m_memory.resize(memorySize);
+}
+
+Texture2D::Texture2D(unsigned width, unsigned height, const std::string& name):
+	m_memory(MemoryCategory::Texture, name)
+{
+	TRACE_SCOPE("Texture2D allocate");
+
+	create();
+
+	GL_CHECK(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+	// no mipmaps: they would have to be regenerated on every update
+	GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+	GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+	GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+
+	m_memory.resize(static_cast<size_t>(width) * height * 4);
+}
+
+void Texture2D::create()
+{
+	m_texture = GLObjectPool::get().create(GLObjectType::Texture);
+
+	GL_CHECK(glBindTexture(GL_TEXTURE_2D, getGLTexture()));
+	GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+	GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR));
 }
 
 Texture2D::~Texture2D()
 {
-	glDeleteTextures(1, &m_texture);
+	GLObjectPool::get().release(m_texture);
+}
+
+Texture2D::Texture2D(Texture2D&& other):
+	m_texture(other.m_texture),
+	m_memory(std::move(other.m_memory))
+{
+	other.m_texture = GLHandle();
+}
+
+Texture2D& Texture2D::operator=(Texture2D&& other)
+{
+	if (this != &other)
+	{
+		GLObjectPool::get().release(m_texture);
+		m_texture = other.m_texture;
+		other.m_texture = GLHandle();
+		m_memory = std::move(other.m_memory);
+	}
+
+	return *this;
 }
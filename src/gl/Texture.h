@@ -20,27 +20,58 @@
 #define GL_TEXTURE_H
 
 #include "../Image.h"
+#include "../MemoryTracker.h"
+#include "GLObjectPool.h"
 #include <GLES2/gl2.h>
 
+#include <vector>
+#include <string>
+#include <cstddef>
+
+/**
+ * The estimated GPU memory of the texture is accounted in the MemoryTracker under the given debug name.
+ */
 class Texture2D
 {
 public:
-	explicit Texture2D(const Image &image);
+	explicit Texture2D(const Image &image, const std::string& name = std::string());
+
+	/**
+	 * Create a texture from a precomputed mipmap chain (the base level first).
+	 * If only the base level is present, the mipmaps are generated by GL.
+	 */
+	explicit Texture2D(const std::vector<Image>& levels, const std::string& name = std::string());
+
+	/**
+	 * Create a texture with uninitialized content and no mipmaps, to be filled by glTexSubImage2D.
+	 */
+	Texture2D(unsigned width, unsigned height, const std::string& name = std::string());
 	~Texture2D();
 
 	GLuint getGLTexture() const
 	{
-		return m_texture;
+		return GLObjectPool::get().resolve(m_texture);
+	}
+
+	/**
+	 * Estimated GPU memory held by the texture, including the mipmaps.
+	 */
+	size_t getMemorySize() const
+	{
+		return m_memory.getSize();
 	}
 
 	// allow move, disallow copy
-	Texture2D& operator=(Texture2D&&) = default;
-	Texture2D(Texture2D&&) = default;
+	Texture2D& operator=(Texture2D&& other);
+	Texture2D(Texture2D&& other);
 	Texture2D& operator=(const Texture2D&) = delete;
 	Texture2D(const Texture2D&) = delete;
 
 private:
-	GLuint m_texture;
+	void create();
+
+	GLHandle m_texture;
+	TrackedMemory m_memory;
 };
 
 #endif // GL_TEXTURE_H
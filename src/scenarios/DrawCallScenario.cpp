@@ -0,0 +1,67 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "DrawCallScenario.h"
+#include "../gl/GLCheck.h"
+#include "../gl/GLCounters.h"
+
+#include <glm/gtc/type_ptr.hpp>
+
+DrawCallScenario::DrawCallScenario(const ScenarioContext& context, const ScenarioParameters& parameters):
+	ScenarioRenderer(context),
+	m_drawCount(parameters.getUnsigned("draws", 1)),
+	m_offsetScaleIndex(0),
+	m_colorIndex(0)
+{}
+
+void DrawCallScenario::setUp(int, int)
+{
+	m_program = createProgram(QUAD_VERTEX_SHADER, COLOR_FRAGMENT_SHADER, "draw-calls");
+	GL_CHECK(glUseProgram(m_program->getGLProgram()));
+	countGL(GLCounter::ProgramBinds);
+	m_offsetScaleIndex = m_program->getUniform("offsetScale");
+	m_colorIndex = m_program->getUniform("color");
+
+	m_quad.reset(new ArrayBuffer("quad"));
+	setQuadData(*m_quad);
+	GL_CHECK(glEnableVertexAttribArray(POSITION_ATTRIBUTE));
+	GL_CHECK(glVertexAttribPointer(POSITION_ATTRIBUTE, 2, GL_FLOAT, GL_FALSE, 0, nullptr));
+
+	m_offsetScales = layOutGrid(m_drawCount);
+	m_colors.reserve(m_drawCount);
+	for (unsigned i = 0; i < m_drawCount; i++)
+		m_colors.push_back(glm::vec4((i % 7) / 6.0f, (i % 5) / 4.0f, (i % 3) / 2.0f, 1.0f));
+
+	GL_CHECK(glClearColor(0.0, 0.0, 0.0, 1.0));
+}
+
+void DrawCallScenario::renderFrame(unsigned)
+{
+	GL_CHECK(glClear(GL_COLOR_BUFFER_BIT));
+
+	for (unsigned i = 0; i < m_drawCount; i++)
+	{
+		GL_CHECK(glUniform4fv(m_offsetScaleIndex, 1, glm::value_ptr(m_offsetScales[i])));
+		GL_CHECK(glUniform4fv(m_colorIndex, 1, glm::value_ptr(m_colors[i])));
+		GL_CHECK(glDrawArrays(GL_TRIANGLES, 0, QUAD_VERTEX_COUNT));
+	}
+
+	countGL(GLCounter::UniformUpdates, 2 * m_drawCount);
+	countGL(GLCounter::DrawCalls, m_drawCount);
+	countGL(GLCounter::Vertices, m_drawCount * QUAD_VERTEX_COUNT);
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef DRAW_CALL_SCENARIO_H
+#define DRAW_CALL_SCENARIO_H
+
+#include "ScenarioRenderer.h"
+
+/**
+ * Draw-call bound: a grid of tiny quads, each with its own uniforms and draw call.
+ */
+class DrawCallScenario: public ScenarioRenderer
+{
+public:
+	DrawCallScenario(const ScenarioContext& context, const ScenarioParameters& parameters);
+
+protected:
+	virtual void setUp(int width, int height) override;
+	virtual void renderFrame(unsigned frameNumber) override;
+
+private:
+	unsigned m_drawCount;
+
+	std::unique_ptr<Program> m_program;
+	std::unique_ptr<ArrayBuffer> m_quad;
+	GLuint m_offsetScaleIndex;
+	GLuint m_colorIndex;
+	std::vector<glm::vec4> m_offsetScales;
+	std::vector<glm::vec4> m_colors;
+};
+
+#endif // DRAW_CALL_SCENARIO_H
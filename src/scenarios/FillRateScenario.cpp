@@ -0,0 +1,75 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "FillRateScenario.h"
+#include "../gl/GLCheck.h"
+#include "../gl/GLCounters.h"
+
+#include <glm/gtc/type_ptr.hpp>
+
+FillRateScenario::FillRateScenario(const ScenarioContext& context, const ScenarioParameters& parameters):
+	ScenarioRenderer(context),
+	m_layerCount(parameters.getUnsigned("layers", 1)),
+	m_blend(parameters.getBool("blend")),
+	m_colorIndex(0)
+{}
+
+void FillRateScenario::setUp(int, int)
+{
+	m_program = createProgram(QUAD_VERTEX_SHADER, COLOR_FRAGMENT_SHADER, "fill-rate");
+	GL_CHECK(glUseProgram(m_program->getGLProgram()));
+	countGL(GLCounter::ProgramBinds);
+	m_colorIndex = m_program->getUniform("color");
+
+	// the whole viewport
+	GL_CHECK(glUniform4f(m_program->getUniform("offsetScale"), 0.0f, 0.0f, 1.0f, 1.0f));
+	countGL(GLCounter::UniformUpdates);
+
+	m_quad.reset(new ArrayBuffer("quad"));
+	setQuadData(*m_quad);
+	GL_CHECK(glEnableVertexAttribArray(POSITION_ATTRIBUTE));
+	GL_CHECK(glVertexAttribPointer(POSITION_ATTRIBUTE, 2, GL_FLOAT, GL_FALSE, 0, nullptr));
+
+	const float alpha = m_blend ? 0.1f : 1.0f;
+	m_colors.reserve(m_layerCount);
+	for (unsigned i = 0; i < m_layerCount; i++)
+		m_colors.push_back(glm::vec4((i % 3) / 2.0f, (i % 4) / 3.0f, (i % 5) / 4.0f, alpha));
+
+	if (m_blend)
+	{
+		GL_CHECK(glEnable(GL_BLEND));
+		GL_CHECK(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
+	}
+
+	GL_CHECK(glClearColor(0.0, 0.0, 0.0, 1.0));
+}
+
+void FillRateScenario::renderFrame(unsigned)
+{
+	GL_CHECK(glClear(GL_COLOR_BUFFER_BIT));
+
+	for (unsigned i = 0; i < m_layerCount; i++)
+	{
+		GL_CHECK(glUniform4fv(m_colorIndex, 1, glm::value_ptr(m_colors[i])));
+		GL_CHECK(glDrawArrays(GL_TRIANGLES, 0, QUAD_VERTEX_COUNT));
+	}
+
+	countGL(GLCounter::UniformUpdates, m_layerCount);
+	countGL(GLCounter::DrawCalls, m_layerCount);
+	countGL(GLCounter::Vertices, m_layerCount * QUAD_VERTEX_COUNT);
+}
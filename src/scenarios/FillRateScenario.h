@@ -0,0 +1,47 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef FILL_RATE_SCENARIO_H
+#define FILL_RATE_SCENARIO_H
+
+#include "ScenarioRenderer.h"
+
+/**
+ * Fill-rate bound: full-screen quads drawn on top of each other. Without
+ * blending, a GPU with hidden surface removal may skip most of the layers.
+ */
+class FillRateScenario: public ScenarioRenderer
+{
+public:
+	FillRateScenario(const ScenarioContext& context, const ScenarioParameters& parameters);
+
+protected:
+	virtual void setUp(int width, int height) override;
+	virtual void renderFrame(unsigned frameNumber) override;
+
+private:
+	unsigned m_layerCount;
+	bool m_blend;
+
+	std::unique_ptr<Program> m_program;
+	std::unique_ptr<ArrayBuffer> m_quad;
+	GLuint m_colorIndex;
+	std::vector<glm::vec4> m_colors;
+};
+
+#endif // FILL_RATE_SCENARIO_H
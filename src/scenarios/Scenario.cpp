@@ -0,0 +1,79 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "Scenario.h"
+#include "../Options.h"
+
+#include <stdexcept>
+
+void ScenarioParameters::set(const std::string& name, const std::string& value)
+{
+	m_values[name] = value;
+}
+
+bool ScenarioParameters::has(const std::string& name) const
+{
+	return m_values.find(name) != m_values.end();
+}
+
+unsigned ScenarioParameters::getUnsigned(const std::string& name, unsigned minimum) const
+{
+	const unsigned value = parseUnsigned(name, getValue(name));
+	if (value < minimum)
+		throw std::runtime_error("invalid value for " + name + ": " + getValue(name) + " (at least " + std::to_string(minimum) + ")");
+
+	return value;
+}
+
+float ScenarioParameters::getFloat(const std::string& name) const
+{
+	return parseFloat(name, getValue(name));
+}
+
+bool ScenarioParameters::getBool(const std::string& name) const
+{
+	const std::string& value = getValue(name);
+	if (value == "1" || value == "true" || value == "yes" || value == "on")
+		return true;
+	if (value == "0" || value == "false" || value == "no" || value == "off")
+		return false;
+
+	throw std::runtime_error("invalid value for " + name + ": " + value);
+}
+
+std::string ScenarioParameters::toString() const
+{
+	std::string s;
+	for (const std::pair<const std::string, std::string>& value: m_values)
+	{
+		if (!s.empty())
+			s += ',';
+		s += value.first + '=' + value.second;
+	}
+
+	return s;
+}
+
+const std::string& ScenarioParameters::getValue(const std::string& name) const
+{
+	const std::map<std::string, std::string>::const_iterator i = m_values.find(name);
+	if (i == m_values.end())
+		throw std::runtime_error("missing scenario parameter " + name);
+
+	return i->second;
+}
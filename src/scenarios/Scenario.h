@@ -0,0 +1,70 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef SCENARIO_H
+#define SCENARIO_H
+
+#include <map>
+#include <memory>
+#include <string>
+
+class AssetPipeline;
+class PhaseTimer;
+class Benchmark;
+class GoldenImageCheck;
+struct Options;
+
+/**
+ * What a scenario renderer gets from the application.
+ */
+struct ScenarioContext
+{
+	const char* name; // from the registry, a string literal
+	std::shared_ptr<AssetPipeline> assets;
+	std::shared_ptr<PhaseTimer> startupTimer;
+	std::shared_ptr<Benchmark> benchmark; // may be null
+	std::shared_ptr<GoldenImageCheck> goldenCheck; // may be null, only the cube supports it
+	const Options* options;
+};
+
+/**
+ * Values of the parameters of a scenario. The registry fills in the defaults,
+ * so all the parameters a scenario declares are present. The getters throw
+ * std::runtime_error on an invalid value.
+ */
+class ScenarioParameters
+{
+public:
+	void set(const std::string& name, const std::string& value);
+	bool has(const std::string& name) const;
+
+	unsigned getUnsigned(const std::string& name, unsigned minimum = 0) const;
+	float getFloat(const std::string& name) const;
+	/** 0/1, false/true, no/yes or off/on */
+	bool getBool(const std::string& name) const;
+
+	/** "name=value,..." ordered by the name */
+	std::string toString() const;
+
+private:
+	const std::string& getValue(const std::string& name) const;
+
+	std::map<std::string, std::string> m_values;
+};
+
+#endif // SCENARIO_H
@@ -0,0 +1,178 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ScenarioRegistry.h"
+#include "DrawCallScenario.h"
+#include "FillRateScenario.h"
+#include "VertexScenario.h"
+#include "TextureBandwidthScenario.h"
+#include "StateChangeScenario.h"
+#include "TextureStreamingScenario.h"
+#include "../DemoRenderer.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+	std::shared_ptr<MirNativeWindowRenderer> createDemo(const ScenarioContext& context, const ScenarioParameters&)
+	{
+		return std::make_shared<DemoRenderer>(context.assets, context.startupTimer, *context.options, context.benchmark,
+				context.goldenCheck);
+	}
+
+	template<typename SCENARIO>
+	std::shared_ptr<MirNativeWindowRenderer> create(const ScenarioContext& context, const ScenarioParameters& parameters)
+	{
+		return std::make_shared<SCENARIO>(context, parameters);
+	}
+}
+
+std::string ScenarioSpec::toString() const
+{
+	const std::string values = parameters.toString();
+	return values.empty() ? std::string(info->name) : info->name + (':' + values);
+}
+
+const std::vector<ScenarioInfo>& getScenarios()
+{
+	static const std::vector<ScenarioInfo> scenarios =
+	{
+		{
+			"cube", "the demo: a textured die, driven by the input (or --replay-input)",
+			{},
+			createDemo, DemoRenderer::preloadAssets
+		},
+		{
+			"draw-calls", "draw-call bound: a grid of tiny quads, one draw call and two uniform updates each",
+			{
+				{ "draws", "2000", "draw calls per frame" }
+			},
+			create<DrawCallScenario>, nullptr
+		},
+		{
+			"fill-rate", "fill-rate bound: full-screen layers on top of each other",
+			{
+				{ "layers", "10", "full-screen quads per frame" },
+				{ "blend", "1", "alpha-blend the layers" }
+			},
+			create<FillRateScenario>, nullptr
+		},
+		{
+			"vertices", "vertex bound: lit high-poly spheres covering few pixels",
+			{
+				{ "segments", "256", "the spheres have segments x segments quads" },
+				{ "meshes", "4", "spheres drawn per frame" }
+			},
+			create<VertexScenario>, nullptr
+		},
+		{
+			"texture-bandwidth", "texture bandwidth bound: large noise textures minified over the whole screen",
+			{
+				{ "size", "2048", "texture width and height (a power of two)" },
+				{ "textures", "4", "textures, each drawn as a full-screen layer" },
+				{ "mipmaps", "0", "sample the mipmaps (trilinear) instead of the base level (nearest)" },
+				{ "repeat", "4", "how many times the texture repeats across the screen" }
+			},
+			create<TextureBandwidthScenario>, nullptr
+		},
+		{
+			"state-changes", "state-change bound: tiny quads, each with a different program, texture and blending",
+			{
+				{ "draws", "1000", "draw calls per frame" },
+				{ "programs", "4", "programs to switch between" },
+				{ "textures", "4", "textures to switch between" },
+				{ "atlas", "0", "pack the textures into an atlas and select them by texture coordinates instead" }
+			},
+			create<StateChangeScenario>, nullptr
+		},
+		{
+			"texture-streaming", "texture upload bound: a band of a dynamic texture rewritten every frame",
+			{
+				{ "size", "1024", "texture width and height" },
+				{ "buffers", "3", "textures in the ring (1 uploads straight into the texture being drawn)" },
+				{ "rows", "128", "rows updated per frame" },
+				{ "columns", "0", "width of the updated band, 0 for whole rows (narrower bands are strided)" }
+			},
+			create<TextureStreamingScenario>, nullptr
+		}
+	};
+
+	return scenarios;
+}
+
+ScenarioSpec parseScenarioSpec(const std::string& spec)
+{
+	const size_t colon = spec.find(':');
+	const std::string name = spec.substr(0, colon);
+
+	ScenarioSpec result;
+	result.info = nullptr;
+	for (const ScenarioInfo& info: getScenarios())
+	{
+		if (name == info.name)
+			result.info = &info;
+	}
+	if (!result.info)
+		throw std::runtime_error("unknown scenario " + name + " (see --list-scenarios)");
+
+	for (const ScenarioParameterInfo& parameter: result.info->parameters)
+		result.parameters.set(parameter.name, parameter.defaultValue);
+
+	if (colon == std::string::npos)
+		return result;
+
+	// PARAMETER=VALUE,...
+	size_t start = colon + 1;
+	while (start <= spec.size())
+	{
+		const size_t end = std::min(spec.find(',', start), spec.size());
+		const std::string assignment = spec.substr(start, end - start);
+		const size_t equals = assignment.find('=');
+		if (equals == std::string::npos)
+			throw std::runtime_error("invalid scenario parameter " + assignment + " (PARAMETER=VALUE expected)");
+
+		const std::string parameter = assignment.substr(0, equals);
+		if (!result.parameters.has(parameter))
+			throw std::runtime_error("unknown parameter " + parameter + " of scenario " + name + " (see --list-scenarios)");
+
+		result.parameters.set(parameter, assignment.substr(equals + 1));
+		start = end + 1;
+	}
+
+	return result;
+}
+
+std::shared_ptr<MirNativeWindowRenderer> createScenario(const ScenarioSpec& spec, ScenarioContext context)
+{
+	context.name = spec.info->name;
+	if (context.goldenCheck && spec.info->create != createDemo)
+		throw std::runtime_error(std::string("The golden image check needs the cube scenario, not ") + spec.info->name);
+
+	return spec.info->create(context, spec.parameters);
+}
+
+void listScenarios(std::ostream& os)
+{
+	for (const ScenarioInfo& info: getScenarios())
+	{
+		os << info.name << ": " << info.description << std::endl;
+		for (const ScenarioParameterInfo& parameter: info.parameters)
+			os << "    " << parameter.name << " (default " << parameter.defaultValue << "): " << parameter.description << std::endl;
+	}
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef SCENARIO_REGISTRY_H
+#define SCENARIO_REGISTRY_H
+
+#include "Scenario.h"
+#include "../MirNativeWindowRenderer.h"
+
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class AssetPipeline;
+
+struct ScenarioParameterInfo
+{
+	const char* name;
+	const char* defaultValue;
+	const char* description;
+};
+
+struct ScenarioInfo
+{
+	typedef std::shared_ptr<MirNativeWindowRenderer> (*Factory)(const ScenarioContext& context, const ScenarioParameters& parameters);
+	typedef void (*Preloader)(AssetPipeline& assets);
+
+	const char* name;
+	const char* description;
+	std::vector<ScenarioParameterInfo> parameters;
+	Factory create;
+	Preloader preloadAssets; // may be null
+};
+
+/**
+ * A scenario with all its parameter values.
+ */
+struct ScenarioSpec
+{
+	const ScenarioInfo* info;
+	ScenarioParameters parameters;
+
+	/** "name:parameter=value,..." including the defaults, to identify the results of a run. */
+	std::string toString() const;
+};
+
+const std::vector<ScenarioInfo>& getScenarios();
+
+/**
+ * Parse "NAME[:PARAMETER=VALUE,...]". Throws std::runtime_error on an unknown scenario
+ * or parameter.
+ */
+ScenarioSpec parseScenarioSpec(const std::string& spec);
+
+/**
+ * Create the renderer of the scenario. The parameters are validated here,
+ * so that bad values are reported before any window is created.
+ */
+std::shared_ptr<MirNativeWindowRenderer> createScenario(const ScenarioSpec& spec, ScenarioContext context);
+
+void listScenarios(std::ostream& os);
+
+#endif // SCENARIO_REGISTRY_H
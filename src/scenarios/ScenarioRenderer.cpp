@@ -0,0 +1,180 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ScenarioRenderer.h"
+#include "../Benchmark.h"
+#include "../PhaseTimer.h"
+#include "../Log.h"
+#include "../Trace.h"
+#include "../gl/GLCheck.h"
+#include "../gl/GLObjectPool.h"
+
+#include <iostream>
+#include <cmath>
+
+const char ScenarioRenderer::QUAD_VERTEX_SHADER[] =
+	"attribute vec2 vPosition;\n"
+	"uniform vec4 offsetScale;\n"
+	"varying vec2 vTexCoord;\n"
+	"void main()\n"
+	"{\n"
+	"	vTexCoord = vPosition * 0.5 + 0.5;\n"
+	"	gl_Position = vec4(vPosition * offsetScale.zw + offsetScale.xy, 0.0, 1.0);\n"
+	"}\n";
+
+const char ScenarioRenderer::COLOR_FRAGMENT_SHADER[] =
+	"precision mediump float;\n"
+	"uniform vec4 color;\n"
+	"void main()\n"
+	"{\n"
+	"	gl_FragColor = color;\n"
+	"}\n";
+
+namespace
+{
+	// how often the CPU and GPU frame times are reported
+	const std::chrono::seconds FRAME_STATS_REPORT_PERIOD(10);
+
+	int64_t getTime()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+}
+
+ScenarioRenderer::ScenarioRenderer(const ScenarioContext& context):
+	m_name(context.name),
+	m_startupTimer(context.startupTimer),
+	m_benchmark(context.benchmark),
+	m_cpuFrameTime(std::string("CPU frame time (") + context.name + ")")
+{}
+
+void ScenarioRenderer::run(MirNativeWindowControl& nativeWindow)
+{
+	TRACE_THREAD_NAME("render");
+
+	// no-op in release builds
+	installGLDebugOutput();
+
+	GL_CHECK(glViewport(0, 0, nativeWindow.getWidth(), nativeWindow.getHeight()));
+	setUp(nativeWindow.getWidth(), nativeWindow.getHeight());
+	m_startupTimer->mark(std::string("scenario ") + m_name + " setup");
+
+	m_gpuProfiler.reset(new GpuProfiler());
+	m_frameStatsReportTime = clock::now();
+	nativeWindow.setSwapInterval(0);
+	LOG_INFO("Running scenario " << m_name);
+
+	unsigned frameNumber = 0;
+	while (!m_benchmark || !m_benchmark->isFinished())
+	{
+		const int64_t frameStartTime = getTime();
+
+		m_gpuProfiler->beginFrame();
+		m_gpuProfiler->beginPass(m_name);
+		{
+			TRACE_SCOPE("renderFrame");
+			renderFrame(frameNumber);
+		}
+		m_gpuProfiler->endPass();
+		m_gpuProfiler->endFrame();
+
+		const int64_t submitTime = getTime();
+		nativeWindow.swapBuffers();
+		const int64_t swapTime = getTime();
+
+		GLObjectPool::get().flush();
+		recordFrameTime(submitTime - frameStartTime);
+
+		if (frameNumber == 0)
+		{
+			m_startupTimer->mark("first frame");
+			// nothing after the first frame is a part of the startup
+			m_startupTimer->stop();
+			std::cout << "Startup timings:" << std::endl;
+			m_startupTimer->report(std::cout);
+
+			// the first frame is a part of the startup
+			if (m_benchmark)
+				m_benchmark->start();
+		}
+		else if (m_benchmark)
+			m_benchmark->addFrame(submitTime - frameStartTime, swapTime - frameStartTime);
+
+		frameNumber++;
+	}
+}
+
+void ScenarioRenderer::handleEvent(const MirEvent*)
+{
+	// no input
+}
+
+std::unique_ptr<Program> ScenarioRenderer::createProgram(const char* vertexShader, const char* fragmentShader, const std::string& name)
+{
+	const Shader vs(ShaderType::Vertex, vertexShader, name + " vertex shader");
+	const Shader fs(ShaderType::Fragment, fragmentShader, name + " fragment shader");
+
+	std::unique_ptr<Program> program(new Program(vs, fs, name));
+	GL_CHECK(glBindAttribLocation(program->getGLProgram(), POSITION_ATTRIBUTE, "vPosition"));
+	program->link();
+	return program;
+}
+
+void ScenarioRenderer::setQuadData(ArrayBuffer& buffer)
+{
+	const GLfloat vertices[QUAD_VERTEX_COUNT * 2] =
+	{
+		-1, -1,   1, -1,   1, 1,
+		-1, -1,   1, 1,   -1, 1
+	};
+	buffer.setData(vertices, sizeof(vertices), GL_STATIC_DRAW);
+}
+
+std::vector<glm::vec4> ScenarioRenderer::layOutGrid(unsigned count)
+{
+	const unsigned columns = static_cast<unsigned>(std::ceil(std::sqrt(static_cast<double>(count))));
+	const float cellSize = 2.0f / columns;
+
+	std::vector<glm::vec4> cells;
+	cells.reserve(count);
+	for (unsigned i = 0; i < count; i++)
+	{
+		const float x = -1.0f + cellSize * (i % columns + 0.5f);
+		const float y = -1.0f + cellSize * (i / columns + 0.5f);
+		// leave a gap between the quads
+		cells.push_back(glm::vec4(x, y, cellSize * 0.4f, cellSize * 0.4f));
+	}
+
+	return cells;
+}
+
+void ScenarioRenderer::recordFrameTime(int64_t cpuTime)
+{
+	m_cpuFrameTime.add(cpuTime);
+
+	const clock::time_point now = clock::now();
+	if (now - m_frameStatsReportTime >= FRAME_STATS_REPORT_PERIOD)
+	{
+		m_cpuFrameTime.report(std::cout);
+		m_gpuProfiler->report(std::cout);
+		reportGLErrors(std::cout);
+		m_cpuFrameTime.reset();
+		m_gpuProfiler->reset();
+		m_frameStatsReportTime = now;
+	}
+}
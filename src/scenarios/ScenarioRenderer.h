@@ -0,0 +1,102 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef SCENARIO_RENDERER_H
+#define SCENARIO_RENDERER_H
+
+#include "Scenario.h"
+#include "../MirNativeWindowRenderer.h"
+#include "../LatencyHistogram.h"
+#include "../gl/GpuProfiler.h"
+#include "../gl/Program.h"
+#include "../gl/ArrayBuffer.h"
+
+#include <glm/glm.hpp>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * Base of the synthetic benchmark scenarios.
+ *
+ * Runs the frame loop without a frame rate cap and without waiting for the
+ * vertical sync, measures the CPU and GPU time of the frames and feeds the
+ * benchmark, if there is one (run() then returns when it's finished). The
+ * scenarios ignore the input and are deterministic: any animation depends on
+ * the frame number only.
+ */
+class ScenarioRenderer: public MirNativeWindowRenderer
+{
+public:
+	explicit ScenarioRenderer(const ScenarioContext& context);
+
+	virtual void run(MirNativeWindowControl& nativeWindow) override;
+	virtual void handleEvent(const MirEvent* event) override;
+
+protected:
+	/**
+	 * Create the GL resources. Called on the render thread with the context current.
+	 */
+	virtual void setUp(int width, int height) = 0;
+
+	/**
+	 * Issue the GL commands of a frame (including the clear).
+	 */
+	virtual void renderFrame(unsigned frameNumber) = 0;
+
+	/**
+	 * Compile and link a program. The vPosition attribute is always bound to POSITION_ATTRIBUTE,
+	 * so that the vertex attribute setup doesn't change with the program.
+	 */
+	static std::unique_ptr<Program> createProgram(const char* vertexShader, const char* fragmentShader, const std::string& name);
+
+	/** Fill the buffer with a quad covering the whole viewport (-1 to 1), as QUAD_VERTEX_COUNT vec2 vertices. */
+	static void setQuadData(ArrayBuffer& buffer);
+
+	/**
+	 * Offset (xy) and scale (zw) for QUAD_VERTEX_SHADER of count small quads laid out in a grid
+	 * covering the viewport.
+	 */
+	static std::vector<glm::vec4> layOutGrid(unsigned count);
+
+	static const GLuint POSITION_ATTRIBUTE = 0;
+	static const GLsizei QUAD_VERTEX_COUNT = 6;
+
+	// vPosition scaled and offset by the offsetScale uniform, vTexCoord from 0 to 1 over the quad
+	static const char QUAD_VERTEX_SHADER[];
+	// the color uniform
+	static const char COLOR_FRAGMENT_SHADER[];
+
+private:
+	typedef std::chrono::steady_clock clock;
+
+	void recordFrameTime(int64_t cpuTime);
+
+	const char* m_name;
+	std::shared_ptr<PhaseTimer> m_startupTimer;
+	std::shared_ptr<Benchmark> m_benchmark;
+
+	// the profiler needs the GL context, so it's created in run()
+	LatencyHistogram m_cpuFrameTime;
+	std::unique_ptr<GpuProfiler> m_gpuProfiler;
+	clock::time_point m_frameStatsReportTime;
+};
+
+#endif // SCENARIO_RENDERER_H
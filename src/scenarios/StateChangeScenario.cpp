@@ -0,0 +1,200 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "StateChangeScenario.h"
+#include "../Image.h"
+#include "../TextureAtlas.h"
+#include "../gl/GLCheck.h"
+#include "../gl/GLCounters.h"
+
+#include <stdexcept>
+#include <string>
+
+#include <glm/gtc/type_ptr.hpp>
+
+namespace
+{
+	// the programs differ in the tint only, enough for the driver to see different programs
+	std::string getFragmentShader(const glm::vec3& tint)
+	{
+		return "precision mediump float;\n"
+			"uniform sampler2D textureSampler;\n"
+			"uniform vec4 texCoordOffsetScale;\n"
+			"varying vec2 vTexCoord;\n"
+			"void main()\n"
+			"{\n"
+			"	vec2 texCoord = vTexCoord * texCoordOffsetScale.zw + texCoordOffsetScale.xy;\n"
+			"	gl_FragColor = texture2D(textureSampler, texCoord) * vec4("
+				+ std::to_string(tint.r) + ", " + std::to_string(tint.g) + ", " + std::to_string(tint.b) + ", 0.8);\n"
+			"}\n";
+	}
+
+	// small, so that the texture fetches cost next to nothing
+	const unsigned TEXTURE_SIZE = 16;
+	const unsigned ATLAS_PAGE_SIZE = 256;
+	const unsigned ATLAS_GUTTER = 2;
+
+	/** The color with a dark border, so that wrong texture coordinates show. */
+	Image createFramedImage(const glm::vec3& color)
+	{
+		const size_t byteCount = TEXTURE_SIZE * TEXTURE_SIZE * 4;
+		std::unique_ptr<unsigned char[]> data(new unsigned char[byteCount]);
+		for (unsigned y = 0; y < TEXTURE_SIZE; y++)
+		{
+			for (unsigned x = 0; x < TEXTURE_SIZE; x++)
+			{
+				const bool isBorder = x == 0 || y == 0 || x == TEXTURE_SIZE - 1 || y == TEXTURE_SIZE - 1;
+				const float brightness = isBorder ? 0.25f : 1.0f;
+				unsigned char* pixel = &data[(y * TEXTURE_SIZE + x) * 4];
+				pixel[0] = static_cast<unsigned char>(color.r * brightness * 255);
+				pixel[1] = static_cast<unsigned char>(color.g * brightness * 255);
+				pixel[2] = static_cast<unsigned char>(color.b * brightness * 255);
+				pixel[3] = 255;
+			}
+		}
+
+		return Image(TEXTURE_SIZE, TEXTURE_SIZE, std::move(data), "state-changes");
+	}
+
+	glm::vec3 getColor(unsigned i)
+	{
+		return glm::vec3((i % 2) * 0.5f + 0.5f, (i / 2 % 2) * 0.5f + 0.5f, (i / 4 % 2) * 0.5f + 0.5f);
+	}
+}
+
+StateChangeScenario::StateChangeScenario(const ScenarioContext& context, const ScenarioParameters& parameters):
+	ScenarioRenderer(context),
+	m_drawCount(parameters.getUnsigned("draws", 1)),
+	m_programCount(parameters.getUnsigned("programs", 1)),
+	m_textureCount(parameters.getUnsigned("textures", 1)),
+	m_atlas(parameters.getBool("atlas"))
+{
+	const unsigned tilesPerRow = ATLAS_PAGE_SIZE / (TEXTURE_SIZE + 2*ATLAS_GUTTER);
+	if (m_atlas && m_textureCount > tilesPerRow * tilesPerRow)
+		throw std::runtime_error("too many textures for the atlas: " + std::to_string(m_textureCount)
+				+ " (at most " + std::to_string(tilesPerRow * tilesPerRow) + ")");
+}
+
+void StateChangeScenario::setUp(int, int)
+{
+	m_programs.reserve(m_programCount);
+	m_offsetScaleIndices.reserve(m_programCount);
+	for (unsigned i = 0; i < m_programCount; i++)
+	{
+		m_programs.push_back(createProgram(QUAD_VERTEX_SHADER, getFragmentShader(getColor(i)).c_str(), "state-changes"));
+		GL_CHECK(glUseProgram(m_programs.back()->getGLProgram()));
+		GL_CHECK(glUniform1i(m_programs.back()->getUniform("textureSampler"), 0 /* Texture unit 0 */));
+		m_offsetScaleIndices.push_back(m_programs.back()->getUniform("offsetScale"));
+		m_texCoordIndices.push_back(m_programs.back()->getUniform("texCoordOffsetScale"));
+		GL_CHECK(glUniform4f(m_texCoordIndices.back(), 0.0f, 0.0f, 1.0f, 1.0f));
+	}
+
+	GL_CHECK(glActiveTexture(GL_TEXTURE0));
+	if (m_atlas)
+	{
+		// one texture for all, the draws select their image by the texture coordinates
+		TextureAtlas atlas(ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE, ATLAS_GUTTER);
+		for (unsigned i = 0; i < m_textureCount; i++)
+			atlas.add(std::to_string(i), createFramedImage(getColor(i + 3)));
+		atlas.build();
+
+		m_texCoordOffsetScales.reserve(m_textureCount);
+		for (unsigned i = 0; i < m_textureCount; i++)
+		{
+			const glm::vec2 texCoordMin = atlas.remap(std::to_string(i), glm::vec2(0.0f, 0.0f));
+			const glm::vec2 texCoordMax = atlas.remap(std::to_string(i), glm::vec2(1.0f, 1.0f));
+			m_texCoordOffsetScales.push_back(glm::vec4(texCoordMin.x, texCoordMin.y,
+					texCoordMax.x - texCoordMin.x, texCoordMax.y - texCoordMin.y));
+		}
+
+		m_textures.emplace_back(atlas.getPages().front(), "state-changes atlas");
+	}
+	else
+	{
+		m_textures.reserve(m_textureCount);
+		for (unsigned i = 0; i < m_textureCount; i++)
+			m_textures.emplace_back(createFramedImage(getColor(i + 3)), "state-changes texture");
+	}
+
+	m_quad.reset(new ArrayBuffer("quad"));
+	setQuadData(*m_quad);
+	GL_CHECK(glEnableVertexAttribArray(POSITION_ATTRIBUTE));
+	GL_CHECK(glVertexAttribPointer(POSITION_ATTRIBUTE, 2, GL_FLOAT, GL_FALSE, 0, nullptr));
+
+	m_offsetScales = layOutGrid(m_drawCount);
+
+	GL_CHECK(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
+	GL_CHECK(glClearColor(0.0, 0.0, 0.0, 1.0));
+}
+
+void StateChangeScenario::renderFrame(unsigned)
+{
+	GL_CHECK(glClear(GL_COLOR_BUFFER_BIT));
+
+	// redundant changes are skipped, as a real renderer would
+	unsigned currentProgram = m_programCount;
+	unsigned currentTexture = m_textureCount;
+	uint64_t programBinds = 0;
+	uint64_t textureBinds = 0;
+	uint64_t uniformUpdates = m_drawCount;
+	for (unsigned i = 0; i < m_drawCount; i++)
+	{
+		const unsigned program = i % m_programCount;
+		if (program != currentProgram)
+		{
+			GL_CHECK(glUseProgram(m_programs[program]->getGLProgram()));
+			currentProgram = program;
+			programBinds++;
+		}
+
+		const unsigned texture = i % m_textureCount;
+		if (m_atlas)
+		{
+			if (currentTexture == m_textureCount)
+			{
+				GL_CHECK(glBindTexture(GL_TEXTURE_2D, m_textures.front().getGLTexture()));
+				currentTexture = 0;
+				textureBinds++;
+			}
+
+			// the programs don't share uniforms, so the region is set on every draw
+			GL_CHECK(glUniform4fv(m_texCoordIndices[program], 1, glm::value_ptr(m_texCoordOffsetScales[texture])));
+			uniformUpdates++;
+		}
+		else if (texture != currentTexture)
+		{
+			GL_CHECK(glBindTexture(GL_TEXTURE_2D, m_textures[texture].getGLTexture()));
+			currentTexture = texture;
+			textureBinds++;
+		}
+
+		if (i % 2 == 0)
+			GL_CHECK(glEnable(GL_BLEND));
+		else
+			GL_CHECK(glDisable(GL_BLEND));
+
+		GL_CHECK(glUniform4fv(m_offsetScaleIndices[program], 1, glm::value_ptr(m_offsetScales[i])));
+		GL_CHECK(glDrawArrays(GL_TRIANGLES, 0, QUAD_VERTEX_COUNT));
+	}
+
+	countGL(GLCounter::ProgramBinds, programBinds);
+	countGL(GLCounter::TextureBinds, textureBinds);
+	countGL(GLCounter::UniformUpdates, uniformUpdates);
+	countGL(GLCounter::DrawCalls, m_drawCount);
+	countGL(GLCounter::Vertices, m_drawCount * QUAD_VERTEX_COUNT);
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef STATE_CHANGE_SCENARIO_H
+#define STATE_CHANGE_SCENARIO_H
+
+#include "ScenarioRenderer.h"
+#include "../gl/Texture.h"
+
+/**
+ * State-change bound: tiny quads, where each draw switches the program, the
+ * texture and the blending (as far as there are programs and textures to
+ * switch between).
+ *
+ * With the atlas, the textures are packed into a single atlas page and the
+ * draws select their image by a texture coordinate offset and scale instead
+ * of binding a texture.
+ */
+class StateChangeScenario: public ScenarioRenderer
+{
+public:
+	StateChangeScenario(const ScenarioContext& context, const ScenarioParameters& parameters);
+
+protected:
+	virtual void setUp(int width, int height) override;
+	virtual void renderFrame(unsigned frameNumber) override;
+
+private:
+	unsigned m_drawCount;
+	unsigned m_programCount;
+	unsigned m_textureCount;
+	bool m_atlas;
+
+	std::vector<std::unique_ptr<Program>> m_programs;
+	std::vector<GLuint> m_offsetScaleIndices; // of each program
+	std::vector<GLuint> m_texCoordIndices; // of each program
+	std::vector<Texture2D> m_textures; // just the atlas page with the atlas
+	std::vector<glm::vec4> m_texCoordOffsetScales; // of each image in the atlas
+	std::unique_ptr<ArrayBuffer> m_quad;
+	std::vector<glm::vec4> m_offsetScales;
+};
+
+#endif // STATE_CHANGE_SCENARIO_H
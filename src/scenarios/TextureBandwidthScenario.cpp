@@ -0,0 +1,124 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "TextureBandwidthScenario.h"
+#include "../Image.h"
+#include "../gl/GLCheck.h"
+#include "../gl/GLCounters.h"
+
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+	const char FRAGMENT_SHADER[] =
+		"precision mediump float;\n"
+		"uniform sampler2D textureSampler;\n"
+		"uniform float texCoordScale;\n"
+		"varying vec2 vTexCoord;\n"
+		"void main()\n"
+		"{\n"
+		"	gl_FragColor = texture2D(textureSampler, vTexCoord * texCoordScale);\n"
+		"}\n";
+
+	/** Deterministic RGBA noise. */
+	Image createNoiseImage(unsigned size, uint32_t seed)
+	{
+		const size_t byteCount = static_cast<size_t>(size) * size * 4;
+		std::unique_ptr<unsigned char[]> data(new unsigned char[byteCount]);
+
+		// xorshift32, the seed must not be 0
+		uint32_t x = seed | 1;
+		for (size_t i = 0; i < byteCount; i += 4)
+		{
+			x ^= x << 13;
+			x ^= x >> 17;
+			x ^= x << 5;
+			data[i] = static_cast<unsigned char>(x);
+			data[i + 1] = static_cast<unsigned char>(x >> 8);
+			data[i + 2] = static_cast<unsigned char>(x >> 16);
+			data[i + 3] = 255;
+		}
+
+		return Image(size, size, std::move(data), "noise");
+	}
+}
+
+TextureBandwidthScenario::TextureBandwidthScenario(const ScenarioContext& context, const ScenarioParameters& parameters):
+	ScenarioRenderer(context),
+	m_textureSize(parameters.getUnsigned("size", 1)),
+	m_textureCount(parameters.getUnsigned("textures", 1)),
+	m_mipmaps(parameters.getBool("mipmaps")),
+	m_repeat(parameters.getFloat("repeat"))
+{
+	// GLES 2 can repeat and mipmap power of two textures only
+	if ((m_textureSize & (m_textureSize - 1)) != 0)
+		throw std::runtime_error("invalid value for size: " + std::to_string(m_textureSize) + " (a power of two expected)");
+	if (!(m_repeat > 0))
+		throw std::runtime_error("invalid value for repeat: " + std::to_string(m_repeat));
+}
+
+void TextureBandwidthScenario::setUp(int, int)
+{
+	m_program = createProgram(QUAD_VERTEX_SHADER, FRAGMENT_SHADER, "texture-bandwidth");
+	GL_CHECK(glUseProgram(m_program->getGLProgram()));
+	countGL(GLCounter::ProgramBinds);
+	GL_CHECK(glUniform4f(m_program->getUniform("offsetScale"), 0.0f, 0.0f, 1.0f, 1.0f));
+	GL_CHECK(glUniform1f(m_program->getUniform("texCoordScale"), m_repeat));
+	GL_CHECK(glUniform1i(m_program->getUniform("textureSampler"), 0 /* Texture unit 0 */));
+	countGL(GLCounter::UniformUpdates, 3);
+
+	m_quad.reset(new ArrayBuffer("quad"));
+	setQuadData(*m_quad);
+	GL_CHECK(glEnableVertexAttribArray(POSITION_ATTRIBUTE));
+	GL_CHECK(glVertexAttribPointer(POSITION_ATTRIBUTE, 2, GL_FLOAT, GL_FALSE, 0, nullptr));
+
+	GL_CHECK(glActiveTexture(GL_TEXTURE0));
+	m_textures.reserve(m_textureCount);
+	for (unsigned i = 0; i < m_textureCount; i++)
+	{
+		// Texture2D generates the mipmaps and leaves the texture bound
+		m_textures.emplace_back(createNoiseImage(m_textureSize, i + 1), "noise texture");
+		if (!m_mipmaps)
+		{
+			GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+			GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+		}
+	}
+
+	// blended, so that a GPU with hidden surface removal has to sample every layer
+	GL_CHECK(glEnable(GL_BLEND));
+	GL_CHECK(glBlendColor(0.0f, 0.0f, 0.0f, 0.5f));
+	GL_CHECK(glBlendFunc(GL_CONSTANT_ALPHA, GL_ONE_MINUS_CONSTANT_ALPHA));
+	GL_CHECK(glClearColor(0.0, 0.0, 0.0, 1.0));
+}
+
+void TextureBandwidthScenario::renderFrame(unsigned)
+{
+	GL_CHECK(glClear(GL_COLOR_BUFFER_BIT));
+
+	for (const Texture2D& texture: m_textures)
+	{
+		GL_CHECK(glBindTexture(GL_TEXTURE_2D, texture.getGLTexture()));
+		GL_CHECK(glDrawArrays(GL_TRIANGLES, 0, QUAD_VERTEX_COUNT));
+	}
+
+	countGL(GLCounter::TextureBinds, m_textureCount);
+	countGL(GLCounter::DrawCalls, m_textureCount);
+	countGL(GLCounter::Vertices, m_textureCount * QUAD_VERTEX_COUNT);
+}
@@ -0,0 +1,51 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef TEXTURE_BANDWIDTH_SCENARIO_H
+#define TEXTURE_BANDWIDTH_SCENARIO_H
+
+#include "ScenarioRenderer.h"
+#include "../gl/Texture.h"
+
+/**
+ * Texture bandwidth bound: large noise textures (which don't compress or
+ * cache well), each blended over the whole screen. Repeated across the screen,
+ * the textures are minified: without mipmaps every sample hits a different
+ * part of the texture.
+ */
+class TextureBandwidthScenario: public ScenarioRenderer
+{
+public:
+	TextureBandwidthScenario(const ScenarioContext& context, const ScenarioParameters& parameters);
+
+protected:
+	virtual void setUp(int width, int height) override;
+	virtual void renderFrame(unsigned frameNumber) override;
+
+private:
+	unsigned m_textureSize;
+	unsigned m_textureCount;
+	bool m_mipmaps;
+	float m_repeat;
+
+	std::unique_ptr<Program> m_program;
+	std::unique_ptr<ArrayBuffer> m_quad;
+	std::vector<Texture2D> m_textures;
+};
+
+#endif // TEXTURE_BANDWIDTH_SCENARIO_H
@@ -0,0 +1,116 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "TextureStreamingScenario.h"
+#include "../Log.h"
+#include "../gl/GLCheck.h"
+#include "../gl/GLCounters.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+	const char FRAGMENT_SHADER[] =
+		"precision mediump float;\n"
+		"uniform sampler2D textureSampler;\n"
+		"varying vec2 vTexCoord;\n"
+		"void main()\n"
+		"{\n"
+		"	gl_FragColor = texture2D(textureSampler, vTexCoord);\n"
+		"}\n";
+}
+
+TextureStreamingScenario::TextureStreamingScenario(const ScenarioContext& context, const ScenarioParameters& parameters):
+	ScenarioRenderer(context),
+	m_textureSize(parameters.getUnsigned("size", 1)),
+	m_bufferCount(parameters.getUnsigned("buffers", 1)),
+	m_rows(parameters.getUnsigned("rows", 1)),
+	m_columns(parameters.getUnsigned("columns", 0))
+{
+	if (m_columns == 0)
+		m_columns = m_textureSize;
+
+	if (m_rows > m_textureSize)
+		throw std::runtime_error("invalid value for rows: " + std::to_string(m_rows) + " (at most size)");
+	if (m_columns > m_textureSize)
+		throw std::runtime_error("invalid value for columns: " + std::to_string(m_columns) + " (at most size)");
+}
+
+TextureStreamingScenario::~TextureStreamingScenario()
+{
+	if (!m_texture)
+		return;
+
+	const DynamicTexture::Statistics& statistics = m_texture->getStatistics();
+	LOG_INFO("Texture streaming: " << statistics.uploadCount << " uploads, " << statistics.uploadBytes / 1024 << " KiB, "
+			<< std::chrono::duration_cast<std::chrono::milliseconds>(statistics.uploadTime).count() << " ms submitting");
+}
+
+void TextureStreamingScenario::setUp(int, int)
+{
+	m_program = createProgram(QUAD_VERTEX_SHADER, FRAGMENT_SHADER, "texture-streaming");
+	GL_CHECK(glUseProgram(m_program->getGLProgram()));
+	countGL(GLCounter::ProgramBinds);
+	GL_CHECK(glUniform4f(m_program->getUniform("offsetScale"), 0.0f, 0.0f, 1.0f, 1.0f));
+	GL_CHECK(glUniform1i(m_program->getUniform("textureSampler"), 0 /* Texture unit 0 */));
+	countGL(GLCounter::UniformUpdates, 2);
+
+	m_quad.reset(new ArrayBuffer("quad"));
+	setQuadData(*m_quad);
+	GL_CHECK(glEnableVertexAttribArray(POSITION_ATTRIBUTE));
+	GL_CHECK(glVertexAttribPointer(POSITION_ATTRIBUTE, 2, GL_FLOAT, GL_FALSE, 0, nullptr));
+
+	GL_CHECK(glActiveTexture(GL_TEXTURE0));
+	m_texture.reset(new DynamicTexture(m_textureSize, m_textureSize, m_bufferCount));
+	m_source.reset(new unsigned char[static_cast<size_t>(m_textureSize) * m_rows * 4]);
+
+	GL_CHECK(glClearColor(0.0, 0.0, 0.0, 1.0));
+}
+
+void TextureStreamingScenario::renderFrame(unsigned frameNumber)
+{
+	// new content for the band: a gradient that changes with the frame number
+	for (unsigned y = 0; y < m_rows; y++)
+	{
+		unsigned char* row = &m_source[static_cast<size_t>(y) * m_textureSize * 4];
+		for (unsigned x = 0; x < m_textureSize; x++)
+		{
+			row[x * 4] = static_cast<unsigned char>(x + frameNumber);
+			row[x * 4 + 1] = static_cast<unsigned char>(y + frameNumber * 3);
+			row[x * 4 + 2] = static_cast<unsigned char>(frameNumber * 7);
+			row[x * 4 + 3] = 255;
+		}
+	}
+
+	// the band moves down the texture, centered horizontally
+	const unsigned y = frameNumber * m_rows % m_textureSize;
+	const unsigned height = std::min(m_rows, m_textureSize - y);
+	const unsigned x = (m_textureSize - m_columns) / 2;
+	m_texture->update(x, y, m_columns, height, &m_source[x * 4], m_textureSize);
+
+	GL_CHECK(glBindTexture(GL_TEXTURE_2D, m_texture->commit().getGLTexture()));
+	countGL(GLCounter::TextureBinds);
+
+	GL_CHECK(glClear(GL_COLOR_BUFFER_BIT));
+	GL_CHECK(glDrawArrays(GL_TRIANGLES, 0, QUAD_VERTEX_COUNT));
+	countGL(GLCounter::DrawCalls);
+	countGL(GLCounter::Vertices, QUAD_VERTEX_COUNT);
+}
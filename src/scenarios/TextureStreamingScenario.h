@@ -0,0 +1,53 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef TEXTURE_STREAMING_SCENARIO_H
+#define TEXTURE_STREAMING_SCENARIO_H
+
+#include "ScenarioRenderer.h"
+#include "../gl/DynamicTexture.h"
+
+/**
+ * Texture upload bound: a band of rows of a dynamic texture is rewritten every
+ * frame (like a video or a camera preview) and the texture is drawn over the
+ * whole screen. A band narrower than the texture is taken from a source as wide
+ * as the texture, so its rows are strided.
+ */
+class TextureStreamingScenario: public ScenarioRenderer
+{
+public:
+	TextureStreamingScenario(const ScenarioContext& context, const ScenarioParameters& parameters);
+	~TextureStreamingScenario();
+
+protected:
+	virtual void setUp(int width, int height) override;
+	virtual void renderFrame(unsigned frameNumber) override;
+
+private:
+	unsigned m_textureSize;
+	unsigned m_bufferCount;
+	unsigned m_rows;
+	unsigned m_columns;
+
+	std::unique_ptr<Program> m_program;
+	std::unique_ptr<ArrayBuffer> m_quad;
+	std::unique_ptr<DynamicTexture> m_texture;
+	std::unique_ptr<unsigned char[]> m_source; // m_textureSize x m_rows
+};
+
+#endif // TEXTURE_STREAMING_SCENARIO_H
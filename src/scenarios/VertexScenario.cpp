@@ -0,0 +1,137 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "VertexScenario.h"
+#include "../gl/GLCheck.h"
+#include "../gl/GLCounters.h"
+
+#include <cmath>
+
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace
+{
+	const char VERTEX_SHADER[] =
+		"attribute vec3 vPosition;\n"
+		"uniform mat4 MVPMatrix;\n"
+		"uniform mat4 rotationMatrix;\n"
+		"varying float vLight;\n"
+		"void main()\n"
+		"{\n"
+		"	// a unit sphere: the position is the normal\n"
+		"	vec3 normal = normalize((rotationMatrix * vec4(vPosition, 0.0)).xyz);\n"
+		"	vLight = max(dot(normal, normalize(vec3(0.5, 0.7, 1.0))), 0.1);\n"
+		"	gl_Position = MVPMatrix * vec4(vPosition, 1.0);\n"
+		"}\n";
+
+	const char FRAGMENT_SHADER[] =
+		"precision mediump float;\n"
+		"varying float vLight;\n"
+		"void main()\n"
+		"{\n"
+		"	gl_FragColor = vec4(vec3(0.9, 0.7, 0.4) * vLight, 1.0);\n"
+		"}\n";
+
+	// radius of the spheres on the screen (the viewport is 2 high)
+	const float MESH_RADIUS = 0.1f;
+
+	glm::vec3 getSpherePoint(unsigned latitude, unsigned longitude, unsigned segmentCount)
+	{
+		const float theta = M_PI * latitude / segmentCount;
+		const float phi = 2.0 * M_PI * longitude / segmentCount;
+		return glm::vec3(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+	}
+}
+
+VertexScenario::VertexScenario(const ScenarioContext& context, const ScenarioParameters& parameters):
+	ScenarioRenderer(context),
+	m_segmentCount(parameters.getUnsigned("segments", 2)),
+	m_meshCount(parameters.getUnsigned("meshes", 1)),
+	m_vertexCount(0),
+	m_mvpMatrixIndex(0),
+	m_rotationMatrixIndex(0)
+{}
+
+void VertexScenario::setUp(int width, int height)
+{
+	m_program = createProgram(VERTEX_SHADER, FRAGMENT_SHADER, "vertices");
+	GL_CHECK(glUseProgram(m_program->getGLProgram()));
+	countGL(GLCounter::ProgramBinds);
+	m_mvpMatrixIndex = m_program->getUniform("MVPMatrix");
+	m_rotationMatrixIndex = m_program->getUniform("rotationMatrix");
+
+	// two triangles for each segment of the latitude x longitude grid
+	std::vector<glm::vec3> vertices;
+	vertices.reserve(static_cast<size_t>(m_segmentCount) * m_segmentCount * 6);
+	for (unsigned i = 0; i < m_segmentCount; i++)
+	{
+		for (unsigned j = 0; j < m_segmentCount; j++)
+		{
+			const glm::vec3 a = getSpherePoint(i, j, m_segmentCount);
+			const glm::vec3 b = getSpherePoint(i + 1, j, m_segmentCount);
+			const glm::vec3 c = getSpherePoint(i + 1, j + 1, m_segmentCount);
+			const glm::vec3 d = getSpherePoint(i, j + 1, m_segmentCount);
+
+			vertices.push_back(a);
+			vertices.push_back(b);
+			vertices.push_back(c);
+			vertices.push_back(a);
+			vertices.push_back(c);
+			vertices.push_back(d);
+		}
+	}
+
+	m_mesh.reset(new ArrayBuffer("sphere"));
+	m_mesh->setData(glm::value_ptr(vertices[0]), vertices.size() * sizeof(vertices[0]), GL_STATIC_DRAW);
+	m_vertexCount = vertices.size();
+	GL_CHECK(glEnableVertexAttribArray(POSITION_ATTRIBUTE));
+	GL_CHECK(glVertexAttribPointer(POSITION_ATTRIBUTE, 3, GL_FLOAT, GL_FALSE, 0, nullptr));
+
+	// the spheres in a row across the middle of the screen
+	const float aspect = static_cast<float>(width) / height;
+	m_projectionMatrix = glm::ortho(-aspect, aspect, -1.0f, 1.0f, -1.0f, 1.0f);
+	m_positions.reserve(m_meshCount);
+	for (unsigned i = 0; i < m_meshCount; i++)
+		m_positions.push_back(glm::vec3(aspect * 0.8f * (2.0f * (i + 0.5f) / m_meshCount - 1.0f), 0.0f, 0.0f));
+
+	GL_CHECK(glEnable(GL_DEPTH_TEST));
+	GL_CHECK(glDepthFunc(GL_LESS));
+	GL_CHECK(glClearColor(0.0, 0.0, 0.0, 1.0));
+}
+
+void VertexScenario::renderFrame(unsigned frameNumber)
+{
+	GL_CHECK(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+
+	const float angle = frameNumber * 0.01f;
+	for (unsigned i = 0; i < m_meshCount; i++)
+	{
+		const glm::mat4 rotation = glm::rotate(glm::mat4(1.0f), angle + i, glm::vec3(0.3f, 1.0f, 0.0f));
+		const glm::mat4 model = glm::scale(glm::translate(glm::mat4(1.0f), m_positions[i]), glm::vec3(MESH_RADIUS)) * rotation;
+		const glm::mat4 mvpMatrix = m_projectionMatrix * model;
+
+		GL_CHECK(glUniformMatrix4fv(m_mvpMatrixIndex, 1, GL_FALSE, glm::value_ptr(mvpMatrix)));
+		GL_CHECK(glUniformMatrix4fv(m_rotationMatrixIndex, 1, GL_FALSE, glm::value_ptr(rotation)));
+		GL_CHECK(glDrawArrays(GL_TRIANGLES, 0, m_vertexCount));
+	}
+
+	countGL(GLCounter::UniformUpdates, 2 * m_meshCount);
+	countGL(GLCounter::DrawCalls, m_meshCount);
+	countGL(GLCounter::Vertices, static_cast<uint64_t>(m_meshCount) * m_vertexCount);
+}
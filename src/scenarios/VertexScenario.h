@@ -0,0 +1,51 @@
+/*
+ * Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+ *
+ * This file is part of MirGLESDemo.
+ *
+ * MirGLESDemo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MirGLESDemo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef VERTEX_SCENARIO_H
+#define VERTEX_SCENARIO_H
+
+#include "ScenarioRenderer.h"
+
+/**
+ * Vertex bound: lit spheres of many small triangles, each covering only a small
+ * part of the screen. The mesh isn't indexed, so there is no reuse of the
+ * transformed vertices either.
+ */
+class VertexScenario: public ScenarioRenderer
+{
+public:
+	VertexScenario(const ScenarioContext& context, const ScenarioParameters& parameters);
+
+protected:
+	virtual void setUp(int width, int height) override;
+	virtual void renderFrame(unsigned frameNumber) override;
+
+private:
+	unsigned m_segmentCount;
+	unsigned m_meshCount;
+
+	std::unique_ptr<Program> m_program;
+	std::unique_ptr<ArrayBuffer> m_mesh;
+	GLsizei m_vertexCount;
+	GLuint m_mvpMatrixIndex;
+	GLuint m_rotationMatrixIndex;
+	glm::mat4 m_projectionMatrix;
+	std::vector<glm::vec3> m_positions;
+};
+
+#endif // VERTEX_SCENARIO_H
@@ -0,0 +1,66 @@
+#!/usr/bin/env python3
+#
+# Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+#
+# This file is part of MirGLESDemo.
+#
+# MirGLESDemo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# MirGLESDemo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+
+# Compare two result files of mir_gles_demo_bench --json=FILE, e.g. of a
+# release build before and after a change.
+#
+# Usage: compare-microbenchmarks.py BASELINE RESULT
+#
+# Prints the median time of each case in both files and the change. Cases
+# that are only in one of the files are listed too.
+
+import json
+import sys
+
+def load(fileName):
+	with open(fileName) as f:
+		return json.load(f)
+
+def main():
+	if len(sys.argv) != 3:
+		sys.exit('Usage: %s BASELINE RESULT' % sys.argv[0])
+
+	baseline = load(sys.argv[1])
+	result = load(sys.argv[2])
+
+	for key in ('build', 'compiler'):
+		if baseline[key] != result[key]:
+			print('note: %s differs: %s vs %s' % (key, baseline[key], result[key]))
+
+	baselineCases = {c['name']: c for c in baseline['cases']}
+	resultCases = {c['name']: c for c in result['cases']}
+
+	print('%-40s %14s %14s %9s %8s' % ('case', 'baseline ns', 'result ns', 'change', 'spread'))
+	for name in sorted(set(baselineCases) | set(resultCases)):
+		if name not in resultCases:
+			print('%-40s %14.1f %14s' % (name, baselineCases[name]['medianNs'], '-'))
+			continue
+		if name not in baselineCases:
+			print('%-40s %14s %14.1f' % (name, '-', resultCases[name]['medianNs']))
+			continue
+
+		before = baselineCases[name]['medianNs']
+		after = resultCases[name]['medianNs']
+		change = (after - before) / before * 100 if before > 0 else 0.0
+		# a change smaller than the spread of the runs is probably noise
+		spread = max(baselineCases[name]['spreadPercent'], resultCases[name]['spreadPercent'])
+		print('%-40s %14.1f %14.1f %+8.1f%% %7.1f%%' % (name, before, after, change, spread))
+
+if __name__ == '__main__':
+	main()
@@ -0,0 +1,127 @@
+#!/usr/bin/env python3
+#
+# Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+#
+# This file is part of MirGLESDemo.
+#
+# MirGLESDemo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# MirGLESDemo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+
+# Generate the input trace checked by mir_gles_demo_velocity_check: strokes
+# with a known release velocity, in the format of src/InputTrace.cpp.
+#
+# Usage: make-velocity-trace.py TRACE EXPECTED
+#
+# The samples come at uneven intervals (as they do from real hardware), so a
+# velocity estimate that ignores the timestamps fails the check. EXPECTED gets
+# the release velocity of each stroke in pixels per second, or "none" if the
+# stroke must not end with a swipe.
+
+import struct
+import sys
+
+MAGIC = b'MGDINP'
+VERSION = 1
+
+EVENT_POINTER = 0x10
+DOWN, MOVE, UP = 0, 1, 2
+
+# ns between the samples, repeated; about 120 Hz with jitter
+INTERVALS = [8100000, 8600000, 7400000, 9200000, 8300000, 7900000, 8800000]
+
+def zigzag(value):
+	return (value << 1) ^ (value >> 63)
+
+def varint(value):
+	out = bytearray()
+	while value >= 0x80:
+		out.append((value & 0x7f) | 0x80)
+		value >>= 7
+	out.append(value)
+	return bytes(out)
+
+def floatBits(value):
+	return struct.unpack('<I', struct.pack('<f', value))[0]
+
+class Writer:
+	def __init__(self):
+		self.data = bytearray(MAGIC + struct.pack('<H', VERSION))
+		self.lastTime = 0
+		self.interval = 0
+
+	def sample(self, action, pointerId, x, y, time):
+		self.data += bytes([EVENT_POINTER | action])
+		self.data += varint(zigzag(time - self.lastTime))
+		self.data += varint(zigzag(pointerId))
+		self.data += varint(floatBits(x)) + varint(floatBits(y))
+		self.lastTime = time
+
+	def nextInterval(self):
+		interval = INTERVALS[self.interval % len(INTERVALS)]
+		self.interval += 1
+		return interval
+
+	def stroke(self, pointerId, start, time, segments):
+		'''
+		Move with constant velocities, segments is a list of (velocity, duration in ns).
+		Returns the time after the stroke.
+		'''
+		x, y = start
+		self.sample(DOWN, pointerId, x, y, time)
+		for (vx, vy), duration in segments:
+			end = time + duration
+			while time < end:
+				dt = min(self.nextInterval(), end - time)
+				time += dt
+				x += vx * dt / 1e9
+				y += vy * dt / 1e9
+				self.sample(MOVE, pointerId, x, y, time)
+		# released while still moving
+		dt = self.nextInterval()
+		time += dt
+		x += segments[-1][0][0] * dt / 1e9
+		y += segments[-1][0][1] * dt / 1e9
+		self.sample(UP, pointerId, x, y, time)
+		return time + 500000000
+
+def main():
+	if len(sys.argv) != 3:
+		sys.exit('Usage: %s TRACE EXPECTED' % sys.argv[0])
+
+	writer = Writer()
+	expected = []
+	time = 1000000000000
+
+	# (description, pointer, start, segments, expected velocity or None)
+	strokes = [
+		('fast fling to the right', 0, (100, 400), [((2400, 0), 150000000)], (2400, 0)),
+		('slow drag up', 0, (300, 600), [((0, -180), 300000000)], (0, -180)),
+		('diagonal fling with the mouse', -1, (50, 50), [((900, 1300), 120000000)], (900, 1300)),
+		('drag right, then fling left: only the recent motion counts', 1, (400, 300),
+			[((1500, 0), 250000000), ((-2000, 0), 150000000)], (-2000, 0)),
+		('fling, then held still before the release', 0, (100, 100),
+			[((2000, 500), 150000000), ((0, 0), 200000000)], None),
+	]
+
+	for description, pointerId, start, segments, velocity in strokes:
+		time = writer.stroke(pointerId, start, time, segments)
+		expected.append('# ' + description)
+		expected.append('none' if velocity is None else '%g %g' % velocity)
+
+	with open(sys.argv[1], 'wb') as f:
+		f.write(writer.data)
+	with open(sys.argv[2], 'w') as f:
+		f.write('\n'.join(expected) + '\n')
+
+if __name__ == '__main__':
+	main()
@@ -0,0 +1,89 @@
+#!/usr/bin/env python3
+#
+# Copyright 2017 David Kozub <zub at linux.fjfi.cvut.cz>
+#
+# This file is part of MirGLESDemo.
+#
+# MirGLESDemo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# MirGLESDemo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with MirGLESDemo.  If not, see <http://www.gnu.org/licenses/>.
+
+# Pack resource files into a single archive read by src/ResourceArchive.cpp.
+#
+# Usage: pack-resources.py OUTPUT BASE_DIR FILE...
+#
+# The entry names are the file paths relative to BASE_DIR.
+
+import os
+import struct
+import sys
+
+MAGIC = b'MGDPAK\0\0'
+VERSION = 1
+ENTRY_ALIGNMENT = 64
+
+HEADER = struct.Struct('<8sII')
+INDEX_ENTRY = struct.Struct('<QQQII')
+
+def fnv1a64(data):
+	h = 0xcbf29ce484222325
+	for b in data:
+		h ^= b
+		h = (h * 0x100000001b3) & 0xffffffffffffffff
+	return h
+
+def align(offset):
+	return (offset + ENTRY_ALIGNMENT - 1) // ENTRY_ALIGNMENT * ENTRY_ALIGNMENT
+
+def main():
+	if len(sys.argv) < 3:
+		sys.exit('Usage: %s OUTPUT BASE_DIR FILE...' % sys.argv[0])
+
+	output = sys.argv[1]
+	baseDir = sys.argv[2]
+
+	entries = []
+	for fileName in sys.argv[3:]:
+		name = os.path.relpath(fileName, baseDir).replace(os.sep, '/').encode('utf-8')
+		with open(fileName, 'rb') as f:
+			entries.append((fnv1a64(name), name, f.read()))
+
+	# sorted by hash so that the reader can do a binary search
+	entries.sort(key=lambda e: (e[0], e[1]))
+
+	namesOffset = HEADER.size + len(entries) * INDEX_ENTRY.size
+	nameOffsets = []
+	offset = namesOffset
+	for _, name, _ in entries:
+		nameOffsets.append(offset)
+		offset += len(name)
+
+	dataOffsets = []
+	for _, _, data in entries:
+		offset = align(offset)
+		dataOffsets.append(offset)
+		offset += len(data)
+
+	with open(output + '.tmp', 'wb') as out:
+		out.write(HEADER.pack(MAGIC, VERSION, len(entries)))
+		for (h, name, data), nameOffset, dataOffset in zip(entries, nameOffsets, dataOffsets):
+			out.write(INDEX_ENTRY.pack(h, dataOffset, len(data), nameOffset, len(name)))
+		for _, name, _ in entries:
+			out.write(name)
+		for (_, _, data), dataOffset in zip(entries, dataOffsets):
+			out.write(b'\0' * (dataOffset - out.tell()))
+			out.write(data)
+
+	os.replace(output + '.tmp', output)
+
+if __name__ == '__main__':
+	main()